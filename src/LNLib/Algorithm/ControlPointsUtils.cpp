@@ -11,6 +11,9 @@
 #include "ControlPointsUtils.h"
 #include "XYZ.h"
 #include "XYZW.h"
+#include "Projection.h"
+#include "MathUtils.h"
+#include "Constants.h"
 #include "LNLibExceptions.h"
 #include <algorithm>
 
@@ -21,7 +24,7 @@ std::vector<XYZ> LNLib::ControlPointsUtils::ToXYZ(const std::vector<XYZW>& weigh
 	std::vector<XYZ> result;
 	for (int i = 0; i < weightedControlPoints.size(); i++)
 	{
-		result.emplace_back(const_cast<XYZW&>(weightedControlPoints[i]).ToXYZ(true));
+		result.emplace_back(weightedControlPoints[i].ToXYZ(true));
 	}
 	return result;
 }
@@ -36,7 +39,7 @@ std::vector<std::vector<XYZ>> LNLib::ControlPointsUtils::ToXYZ(const std::vector
 	{
 		for (int j = 0; j < column; j++)
 		{
-			result[i][j] = const_cast<XYZW&>(points[i][j]).ToXYZ(true);
+			result[i][j] = points[i][j].ToXYZ(true);
 		}
 	}
 	return result;
@@ -58,6 +61,55 @@ std::vector<std::vector<XYZW>> LNLib::ControlPointsUtils::ToXYZW(const std::vect
 	return result;
 }
 
+bool LNLib::ControlPointsUtils::IsRational(const std::vector<XYZW>& weightedControlPoints)
+{
+	for (int i = 0; i < weightedControlPoints.size(); i++)
+	{
+		if (weightedControlPoints[i].GetW() != 1.0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool LNLib::ControlPointsUtils::IsRational(const std::vector<std::vector<XYZW>>& weightedControlPoints)
+{
+	for (int i = 0; i < weightedControlPoints.size(); i++)
+	{
+		if (IsRational(weightedControlPoints[i]))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool LNLib::ControlPointsUtils::IsFlatPolygon(const std::vector<XYZ>& points, double flatness)
+{
+	int last = points.size() - 1;
+	const XYZ& start = points[0];
+	const XYZ& end = points[last];
+	XYZ chord = end - start;
+	double length = chord.Length();
+	for (int i = 1; i <= last; i++)
+	{
+		if (MathUtils::IsAlmostEqualTo(length, 0.0))
+		{
+			if (points[i].Distance(start) > Constants::DistanceEpsilon)
+			{
+				return false;
+			}
+			continue;
+		}
+		if (Projection::DistanceToLine(start, end, points[i]) > flatness * length || (points[i] - points[i - 1]).DotProduct(chord) < 0.0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 std::vector<std::vector<XYZW>> LNLib::ControlPointsUtils::Multiply(const std::vector<std::vector<XYZW>>& points, const std::vector<std::vector<double>>& coefficient)
 {
 	int m = points.size();
@@ -11,6 +11,10 @@
 #include "Integrator.h"
 #include "FFT.h"
 #include "Constants.h"
+#include "LNLibExceptions.h"
+#include <cmath>
+#include <queue>
+#include <limits>
 
 namespace LNLib
 {
@@ -196,6 +200,336 @@ namespace LNLib
         }
         return integration;
     }
-}
 
+    /// <summary>
+    /// Nonnegative nodes and weights of the Kronrod rules, from the outermost node to the center, and the weights of
+    /// the embedded Gauss rules, which use every second of these nodes (QUADPACK qk15 and qk21).
+    /// </summary>
+    const double Kronrod15Nodes[8] =
+    {
+        0.991455371120812639206854697526329,
+        0.949107912342758524526189684047851,
+        0.864864423359769072789712788640926,
+        0.741531185599394439863864773280788,
+        0.586087235467691130294144845693013,
+        0.405845151377397166906606412076961,
+        0.207784955007898467600689403773245,
+        0.000000000000000000000000000000000,
+    };
+    const double Kronrod15Weights[8] =
+    {
+        0.022935322010529224963732008058970,
+        0.063092092629978553290700663189204,
+        0.104790010322250183839876322541518,
+        0.140653259715525918745189590510238,
+        0.169004726639267902826583426598550,
+        0.190350578064785409913256402421014,
+        0.204432940075298892414161999234649,
+        0.209482141084727828012999174891714,
+    };
+    const double Gauss7Weights[4] =
+    {
+        0.129484966168869693270611432679082,
+        0.279705391489276667901467771423780,
+        0.381830050505118944950369775488975,
+        0.417959183673469387755102040816327,
+    };
+
+    const double Kronrod21Nodes[11] =
+    {
+        0.995657163025808080735527280689003,
+        0.973906528517171720077964012084452,
+        0.930157491355708226001207180059508,
+        0.865063366688984510732096688423493,
+        0.780817726586416897063717578345042,
+        0.679409568299024406234327365114874,
+        0.562757134668604683339000099272694,
+        0.433395394129247190799265943165784,
+        0.294392862701460198131126603103866,
+        0.148874338981631210884826001129720,
+        0.000000000000000000000000000000000,
+    };
+    const double Kronrod21Weights[11] =
+    {
+        0.011694638867371874278064396062192,
+        0.032558162307964727478818972459390,
+        0.054755896574351996031381300244580,
+        0.075039674810919952767043140916190,
+        0.093125454583697605535065465083366,
+        0.109387158802297641899210590325805,
+        0.123491976262065851077382959789843,
+        0.134709217311473325928054001771707,
+        0.142775938577060080797094273138717,
+        0.147739104901338491374841515972068,
+        0.149445554002916905664936468389821,
+    };
+    const double Gauss10Weights[5] =
+    {
+        0.066671344308688137593568809893332,
+        0.149451349150580593145776339657697,
+        0.219086362515982043995534934228163,
+        0.269266719309996355091226921569469,
+        0.295524224714752870173892994651338,
+    };
+
+    struct KronrodInterval
+    {
+        double Start;
+        double End;
+        double Value;
+        double Error;
+
+        bool operator<(const KronrodInterval& other) const
+        {
+            return Error < other.Error;
+        }
+    };
+
+    /// <summary>
+    /// Applies the Kronrod rule and its embedded Gauss rule to [start, end]; the error estimate is their difference.
+    /// </summary>
+    KronrodInterval EvaluateKronrodInterval(const std::function<double(double)>& function, GaussKronrodRule rule, double start, double end)
+    {
+        bool isK21 = rule == GaussKronrodRule::G10K21;
+        const double* nodes = isK21 ? Kronrod21Nodes : Kronrod15Nodes;
+        const double* kronrodWeights = isK21 ? Kronrod21Weights : Kronrod15Weights;
+        const double* gaussWeights = isK21 ? Gauss10Weights : Gauss7Weights;
+        int last = isK21 ? 10 : 7;
+
+        double center = (start + end) / 2.0;
+        double half = (end - start) / 2.0;
+        double centerValue = function(center);
+        double kronrod = kronrodWeights[last] * centerValue;
+        // The 7 point Gauss rule has a node at the center, the 10 point rule does not.
+        double gauss = isK21 ? 0.0 : gaussWeights[last / 2] * centerValue;
+        for (int j = 0; j < last; j++)
+        {
+            double x = half * nodes[j];
+            double sum = function(center - x) + function(center + x);
+            kronrod += kronrodWeights[j] * sum;
+            if (j % 2 == 1)
+            {
+                gauss += gaussWeights[j / 2] * sum;
+            }
+        }
+
+        KronrodInterval interval;
+        interval.Start = start;
+        interval.End = end;
+        interval.Value = kronrod * half;
+        interval.Error = std::abs((kronrod - gauss) * half);
+        return interval;
+    }
 
+    /// <summary>
+    /// All 15 (21) Kronrod nodes on [-1, 1] in increasing order, with their Kronrod weights and Gauss weights (zero off the Gauss nodes).
+    /// </summary>
+    void ExpandKronrodRule(GaussKronrodRule rule, std::vector<double>& nodes, std::vector<double>& kronrodWeights, std::vector<double>& gaussWeights)
+    {
+        bool isK21 = rule == GaussKronrodRule::G10K21;
+        const double* halfNodes = isK21 ? Kronrod21Nodes : Kronrod15Nodes;
+        const double* halfKronrodWeights = isK21 ? Kronrod21Weights : Kronrod15Weights;
+        const double* halfGaussWeights = isK21 ? Gauss10Weights : Gauss7Weights;
+        int last = isK21 ? 10 : 7;
+
+        int size = 2 * last + 1;
+        nodes.resize(size);
+        kronrodWeights.resize(size);
+        gaussWeights.assign(size, 0.0);
+        for (int j = 0; j <= last; j++)
+        {
+            nodes[j] = -halfNodes[j];
+            nodes[size - 1 - j] = halfNodes[j];
+            kronrodWeights[j] = kronrodWeights[size - 1 - j] = halfKronrodWeights[j];
+            if (j % 2 == 1)
+            {
+                gaussWeights[j] = gaussWeights[size - 1 - j] = halfGaussWeights[j / 2];
+            }
+        }
+        if (!isK21)
+        {
+            gaussWeights[last] = halfGaussWeights[last / 2];
+        }
+    }
+
+    struct KronrodRectangle
+    {
+        double StartU;
+        double EndU;
+        double StartV;
+        double EndV;
+        double Value;
+        double Error;
+
+        bool operator<(const KronrodRectangle& other) const
+        {
+            return Error < other.Error;
+        }
+    };
+
+    LN_IntegrationResult Integrator::GaussKronrod(IntegrationFunction& function, void* customData, double start, double end, const LN_IntegrationTolerance& tolerance, int maxEvaluations, GaussKronrodRule rule)
+    {
+        return GaussKronrod([&](double parameter) { return function(parameter, customData); }, start, end, tolerance, maxEvaluations, rule);
+    }
+
+    LN_IntegrationResult Integrator::GaussKronrod(const std::function<double(double)>& function, double start, double end, const LN_IntegrationTolerance& tolerance, int maxEvaluations, GaussKronrodRule rule)
+    {
+        int ruleEvaluations = rule == GaussKronrodRule::G10K21 ? 21 : 15;
+        VALIDATE_ARGUMENT(tolerance.Absolute >= 0.0, "tolerance", "Absolute tolerance must greater than or equals zero.");
+        VALIDATE_ARGUMENT(tolerance.Relative >= 0.0, "tolerance", "Relative tolerance must greater than or equals zero.");
+        VALIDATE_ARGUMENT(tolerance.Absolute > 0.0 || tolerance.Relative > 0.0, "tolerance", "Absolute or relative tolerance must greater than zero.");
+        VALIDATE_ARGUMENT(maxEvaluations >= ruleEvaluations, "maxEvaluations", "MaxEvaluations must allow one application of the rule.");
+
+        LN_IntegrationResult result;
+        if (start == end)
+        {
+            return result;
+        }
+
+        std::priority_queue<KronrodInterval> intervals;
+        KronrodInterval whole = EvaluateKronrodInterval(function, rule, start, end);
+        intervals.push(whole);
+        result.Evaluations = ruleEvaluations;
+        double value = whole.Value;
+        double error = whole.Error;
+        while (error > std::max(tolerance.Absolute, tolerance.Relative * std::abs(value)) && result.Evaluations + 2 * ruleEvaluations <= maxEvaluations)
+        {
+            KronrodInterval worst = intervals.top();
+            double middle = (worst.Start + worst.End) / 2.0;
+            if (std::abs(worst.End - worst.Start) <= 100.0 * std::numeric_limits<double>::epsilon() * std::max(std::abs(worst.Start), std::abs(worst.End)))
+            {
+                break;
+            }
+            intervals.pop();
+            KronrodInterval left = EvaluateKronrodInterval(function, rule, worst.Start, middle);
+            KronrodInterval right = EvaluateKronrodInterval(function, rule, middle, worst.End);
+            intervals.push(left);
+            intervals.push(right);
+            result.Evaluations += 2 * ruleEvaluations;
+            value += left.Value + right.Value - worst.Value;
+            error += left.Error + right.Error - worst.Error;
+        }
+
+        // Sum afresh so that the running updates do not accumulate cancellation.
+        value = 0.0;
+        error = 0.0;
+        while (!intervals.empty())
+        {
+            value += intervals.top().Value;
+            error += intervals.top().Error;
+            intervals.pop();
+        }
+        result.Value = value;
+        result.Error = error;
+        result.IsConverged = error <= std::max(tolerance.Absolute, tolerance.Relative * std::abs(value));
+        return result;
+    }
+
+    LN_IntegrationResult Integrator::GaussKronrodCubature(const std::function<void(const std::vector<double>&, const std::vector<double>&, std::vector<double>&)>& function, double startU, double endU, double startV, double endV, const LN_IntegrationTolerance& tolerance, int maxEvaluations, GaussKronrodRule rule)
+    {
+        std::vector<double> nodes, kronrodWeights, gaussWeights;
+        ExpandKronrodRule(rule, nodes, kronrodWeights, gaussWeights);
+        int size = nodes.size();
+        int ruleEvaluations = size * size;
+        VALIDATE_ARGUMENT(tolerance.Absolute >= 0.0, "tolerance", "Absolute tolerance must greater than or equals zero.");
+        VALIDATE_ARGUMENT(tolerance.Relative >= 0.0, "tolerance", "Relative tolerance must greater than or equals zero.");
+        VALIDATE_ARGUMENT(tolerance.Absolute > 0.0 || tolerance.Relative > 0.0, "tolerance", "Absolute or relative tolerance must greater than zero.");
+        VALIDATE_ARGUMENT(maxEvaluations >= ruleEvaluations, "maxEvaluations", "MaxEvaluations must allow one application of the rule.");
+
+        LN_IntegrationResult result;
+        if (startU == endU || startV == endV)
+        {
+            return result;
+        }
+
+        std::vector<double> us(size);
+        std::vector<double> vs(size);
+        std::vector<double> values;
+        auto evaluate = [&](double su, double eu, double sv, double ev)
+        {
+            double halfU = (eu - su) / 2.0;
+            double halfV = (ev - sv) / 2.0;
+            for (int i = 0; i < size; i++)
+            {
+                us[i] = (su + eu) / 2.0 + halfU * nodes[i];
+                vs[i] = (sv + ev) / 2.0 + halfV * nodes[i];
+            }
+            values.resize(ruleEvaluations);
+            function(us, vs, values);
+
+            double kronrod = 0.0;
+            double gauss = 0.0;
+            for (int i = 0; i < size; i++)
+            {
+                double kronrodRow = 0.0;
+                double gaussRow = 0.0;
+                for (int j = 0; j < size; j++)
+                {
+                    double value = values[i * size + j];
+                    kronrodRow += kronrodWeights[j] * value;
+                    gaussRow += gaussWeights[j] * value;
+                }
+                kronrod += kronrodWeights[i] * kronrodRow;
+                gauss += gaussWeights[i] * gaussRow;
+            }
+
+            KronrodRectangle rectangle;
+            rectangle.StartU = su;
+            rectangle.EndU = eu;
+            rectangle.StartV = sv;
+            rectangle.EndV = ev;
+            rectangle.Value = kronrod * halfU * halfV;
+            rectangle.Error = std::abs((kronrod - gauss) * halfU * halfV);
+            return rectangle;
+        };
+
+        std::priority_queue<KronrodRectangle> rectangles;
+        KronrodRectangle whole = evaluate(startU, endU, startV, endV);
+        rectangles.push(whole);
+        result.Evaluations = ruleEvaluations;
+        double value = whole.Value;
+        double error = whole.Error;
+        while (error > std::max(tolerance.Absolute, tolerance.Relative * std::abs(value)) && result.Evaluations + 4 * ruleEvaluations <= maxEvaluations)
+        {
+            KronrodRectangle worst = rectangles.top();
+            double middleU = (worst.StartU + worst.EndU) / 2.0;
+            double middleV = (worst.StartV + worst.EndV) / 2.0;
+            double limit = 100.0 * std::numeric_limits<double>::epsilon();
+            if (std::abs(worst.EndU - worst.StartU) <= limit * std::max(std::abs(worst.StartU), std::abs(worst.EndU)) ||
+                std::abs(worst.EndV - worst.StartV) <= limit * std::max(std::abs(worst.StartV), std::abs(worst.EndV)))
+            {
+                break;
+            }
+            rectangles.pop();
+            KronrodRectangle quarters[4] =
+            {
+                evaluate(worst.StartU, middleU, worst.StartV, middleV),
+                evaluate(middleU, worst.EndU, worst.StartV, middleV),
+                evaluate(worst.StartU, middleU, middleV, worst.EndV),
+                evaluate(middleU, worst.EndU, middleV, worst.EndV),
+            };
+            value -= worst.Value;
+            error -= worst.Error;
+            for (int k = 0; k < 4; k++)
+            {
+                rectangles.push(quarters[k]);
+                value += quarters[k].Value;
+                error += quarters[k].Error;
+            }
+            result.Evaluations += 4 * ruleEvaluations;
+        }
+
+        value = 0.0;
+        error = 0.0;
+        while (!rectangles.empty())
+        {
+            value += rectangles.top().Value;
+            error += rectangles.top().Error;
+            rectangles.pop();
+        }
+        result.Value = value;
+        result.Error = error;
+        result.IsConverged = error <= std::max(tolerance.Absolute, tolerance.Relative * std::abs(value));
+        return result;
+    }
+}
@@ -87,11 +87,11 @@ std::unordered_map<double, int, std::hash<double>, CustomDoubleEqual> LNLib::Kno
 std::unordered_map<double, int, std::hash<double>, CustomDoubleEqual> LNLib::KnotVectorUtils::GetInternalKnotMultiplicityMap(const std::vector<double>& knotVector)
 {
 	auto result = GetKnotMultiplicityMap(knotVector);
-	if (!result.empty()) 
+	if (!knotVector.empty()) 
 	{
-		result.erase(result.begin());
-		auto lastElementIterator = prev(result.end(), 1);
-		result.erase(lastElementIterator);
+		// The map is unordered, so the end knots are removed by value.
+		result.erase(knotVector[0]);
+		result.erase(knotVector[knotVector.size() - 1]);
 	}
 	return result;
 }
@@ -245,5 +245,23 @@ bool LNLib::KnotVectorUtils::IsUniform(const std::vector<double>& knotVector)
 	return true;
 }
 
+std::vector<double> LNLib::KnotVectorUtils::GetBreakpoints(int degree, const std::vector<double>& knotVector)
+{
+	VALIDATE_ARGUMENT(degree >= 0, "degree", "Degree must greater than or equals zero.");
+	VALIDATE_ARGUMENT(knotVector.size() > 2 * degree + 1, "knotVector", "KnotVector size must greater than two times degree plus one.");
+
+	int last = knotVector.size() - degree - 1;
+	std::vector<double> breakpoints;
+	breakpoints.emplace_back(knotVector[degree]);
+	for (int i = degree + 1; i <= last; i++)
+	{
+		if (!MathUtils::IsAlmostEqualTo(knotVector[i], breakpoints[breakpoints.size() - 1]))
+		{
+			breakpoints.emplace_back(knotVector[i]);
+		}
+	}
+	return breakpoints;
+}
+
 
 
@@ -0,0 +1,99 @@
+/*
+ * Author:
+ * 2026/10/16 - LNLib contributors
+ * Individual authors are recorded in the git history of this file.
+ *
+ * Use of this source code is governed by a GPL-3.0 license that can be found in
+ * the LICENSE file.
+ */
+
+#include "ParallelUtils.h"
+#include "LNLibExceptions.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <algorithm>
+
+int LNLib::ParallelUtils::GetThreadCount(const LN_ExecutionPolicy& policy)
+{
+	VALIDATE_ARGUMENT(policy.ThreadCount >= 0, "policy", "ThreadCount must greater than or equals zero.");
+
+	if (policy.ThreadCount > 0)
+	{
+		return policy.ThreadCount;
+	}
+	int hardwareCount = std::thread::hardware_concurrency();
+	return std::max(hardwareCount, 1);
+}
+
+void LNLib::ParallelUtils::For(int count, const LN_ExecutionPolicy& policy, const std::function<void(int)>& body)
+{
+	int threadCount = std::min(GetThreadCount(policy), count);
+	if (threadCount <= 1)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			body(i);
+		}
+		return;
+	}
+
+	std::atomic<int> next(0);
+	std::atomic<bool> failed(false);
+	std::exception_ptr exception;
+	std::mutex exceptionMutex;
+
+	auto worker = [&]()
+	{
+		int i;
+		while (!failed && (i = next++) < count)
+		{
+			try
+			{
+				body(i);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(exceptionMutex);
+				if (!exception)
+				{
+					exception = std::current_exception();
+				}
+				failed = true;
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	try
+	{
+		threads.reserve(threadCount - 1);
+		for (int i = 0; i < threadCount - 1; i++)
+		{
+			threads.emplace_back(worker);
+		}
+	}
+	catch (...)
+	{
+		// A thread failed to start: stop the ones already running and join them before
+		// unwinding, since destroying a joinable std::thread calls std::terminate.
+		failed = true;
+		for (int i = 0; i < threads.size(); i++)
+		{
+			threads[i].join();
+		}
+		throw;
+	}
+	worker();
+	for (int i = 0; i < threads.size(); i++)
+	{
+		threads[i].join();
+	}
+
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
+}
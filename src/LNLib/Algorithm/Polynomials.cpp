@@ -121,12 +121,22 @@ int LNLib::Polynomials::GetKnotMultiplicity(const std::vector<double>& knotVecto
 }
 
 int LNLib::Polynomials::GetKnotSpanIndex(int degree, const std::vector<double>& knotVector, double paramT)
+{
+	return GetKnotSpanIndex(degree, LN_ArrayView<double>(knotVector), paramT);
+}
+
+int LNLib::Polynomials::GetKnotSpanIndex(int degree, const LN_ArrayView<double>& knotVector, double paramT)
 {
 	VALIDATE_ARGUMENT(degree >= 0, "degree", "Degree must greater than or equals zero.");
 	VALIDATE_ARGUMENT(knotVector.size() > 0, "knotVector", "KnotVector size must greater than zero.");
 	VALIDATE_ARGUMENT(ValidationUtils::IsValidKnotVector(knotVector), "knotVector", "KnotVector must be a nondecreasing sequence of real numbers.");
 	VALIDATE_ARGUMENT_RANGE(paramT, knotVector[0], knotVector[knotVector.size() - 1]);
 
+	return GetKnotSpanIndexUnchecked(degree, knotVector, paramT);
+}
+
+int LNLib::Polynomials::GetKnotSpanIndexUnchecked(int degree, const LN_ArrayView<double>& knotVector, double paramT)
+{
 	int n = knotVector.size() - degree - 2;
 	if (MathUtils::IsGreaterThanOrEqual(paramT, knotVector[n + 1]))
 	{
@@ -157,7 +167,32 @@ int LNLib::Polynomials::GetKnotSpanIndex(int degree, const std::vector<double>&
 	return mid;
 }
 
+int LNLib::Polynomials::GetKnotSpanIndexUnchecked(int degree, const LN_ArrayView<double>& knotVector, double paramT, int hintSpanIndex)
+{
+	int n = knotVector.size() - degree - 2;
+	if (MathUtils::IsGreaterThanOrEqual(paramT, knotVector[n + 1]))
+	{
+		return n;
+	}
+	if (hintSpanIndex < degree || hintSpanIndex > n || paramT < knotVector[hintSpanIndex])
+	{
+		return GetKnotSpanIndexUnchecked(degree, knotVector, paramT);
+	}
+
+	int spanIndex = hintSpanIndex;
+	while (spanIndex < n && paramT >= knotVector[spanIndex + 1])
+	{
+		spanIndex++;
+	}
+	return spanIndex;
+}
+
 std::vector<double> LNLib::Polynomials::BasisFunctions(int spanIndex, int degree, const std::vector<double>& knotVector, double paramT)
+{
+	return BasisFunctions(spanIndex, degree, LN_ArrayView<double>(knotVector), paramT);
+}
+
+std::vector<double> LNLib::Polynomials::BasisFunctions(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double paramT)
 {
 	VALIDATE_ARGUMENT(spanIndex >= 0, "spanIndex", "SpanIndex must greater than or equals zero.");
 	VALIDATE_ARGUMENT(degree >= 0, "degree", "Degree must greater than or equals zero.");
@@ -165,31 +200,78 @@ std::vector<double> LNLib::Polynomials::BasisFunctions(int spanIndex, int degree
 	VALIDATE_ARGUMENT(ValidationUtils::IsValidKnotVector(knotVector), "knotVector", "KnotVector must be a nondecreasing sequence of real numbers.");
 	VALIDATE_ARGUMENT_RANGE(paramT, knotVector[0], knotVector[knotVector.size() - 1]);
 
+	return BasisFunctionsUnchecked(spanIndex, degree, knotVector, paramT);
+}
+
+std::vector<double> LNLib::Polynomials::BasisFunctionsUnchecked(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double paramT)
+{
 	std::vector<double> basisFunctions(degree + 1);
-	basisFunctions[0] = 1.0;
+	BasisFunctionsUnchecked(spanIndex, degree, knotVector, paramT, basisFunctions.data());
+	return basisFunctions;
+}
 
-	std::vector<double> left(degree + 1);
-	std::vector<double> right(degree + 1);
+void LNLib::Polynomials::BasisFunctionsUnchecked(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double paramT, double* basisFunctions)
+{
+	switch (degree)
+	{
+	case 1:
+		BasisFunctionsUnchecked<1>(spanIndex, knotVector, paramT, basisFunctions);
+		break;
+	case 2:
+		BasisFunctionsUnchecked<2>(spanIndex, knotVector, paramT, basisFunctions);
+		break;
+	case 3:
+		BasisFunctionsUnchecked<3>(spanIndex, knotVector, paramT, basisFunctions);
+		break;
+	case 4:
+		BasisFunctionsUnchecked<4>(spanIndex, knotVector, paramT, basisFunctions);
+		break;
+	case 5:
+		BasisFunctionsUnchecked<5>(spanIndex, knotVector, paramT, basisFunctions);
+		break;
+	default:
+		BasisFunctionsKernel(spanIndex, degree, knotVector, paramT, basisFunctions);
+		break;
+	}
+}
 
+void LNLib::Polynomials::ComputeInverseDenominators(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double* inverseDenominators)
+{
 	for (int j = 1; j <= degree; j++)
 	{
-		left[j] = paramT - knotVector[spanIndex + 1 - j];
-		right[j] = knotVector[spanIndex + j] - paramT;
+		double* row = inverseDenominators + j * (j - 1) / 2;
+		for (int r = 0; r < j; r++)
+		{
+			row[r] = 1.0 / (knotVector[spanIndex + r + 1] - knotVector[spanIndex + 1 - j + r]);
+		}
+	}
+}
 
+void LNLib::Polynomials::BasisFunctionsUnchecked(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double paramT, const double* inverseDenominators, double* basisFunctions)
+{
+	basisFunctions[0] = 1.0;
+	for (int j = 1; j <= degree; j++)
+	{
+		const double* row = inverseDenominators + j * (j - 1) / 2;
 		double saved = 0.0;
-
 		for (int r = 0; r < j; r++)
 		{
-			double temp = basisFunctions[r] / (right[r + 1] + left[j - r]);
-			basisFunctions[r] = saved + right[r + 1] * temp;
-			saved = left[j - r] * temp;
+			double right = knotVector[spanIndex + r + 1] - paramT;
+			double left = paramT - knotVector[spanIndex + 1 - j + r];
+			double temp = basisFunctions[r] * row[r];
+			basisFunctions[r] = saved + right * temp;
+			saved = left * temp;
 		}
 		basisFunctions[j] = saved;
 	}
-	return basisFunctions;
 }
 
-std::vector<std::vector<double>> LNLib::Polynomials::BasisFunctionsDerivatives(int spanIndex, int degree,  int derivative, const std::vector<double>& knotVector, double paramT)
+std::vector<std::vector<double>> LNLib::Polynomials::BasisFunctionsDerivatives(int spanIndex, int degree, int derivative, const std::vector<double>& knotVector, double paramT)
+{
+	return BasisFunctionsDerivatives(spanIndex, degree, derivative, LN_ArrayView<double>(knotVector), paramT);
+}
+
+std::vector<std::vector<double>> LNLib::Polynomials::BasisFunctionsDerivatives(int spanIndex, int degree, int derivative, const LN_ArrayView<double>& knotVector, double paramT)
 {
 	VALIDATE_ARGUMENT(spanIndex >= 0, "spanIndex", "SpanIndex must greater than or equals zero.");
 	VALIDATE_ARGUMENT(degree > 0, "degree", "Degree must greater than zero.");
@@ -198,86 +280,118 @@ std::vector<std::vector<double>> LNLib::Polynomials::BasisFunctionsDerivatives(i
 	VALIDATE_ARGUMENT(ValidationUtils::IsValidKnotVector(knotVector), "knotVector", "KnotVector must be a nondecreasing sequence of real numbers.");
 	VALIDATE_ARGUMENT_RANGE(paramT, knotVector[0], knotVector[knotVector.size() - 1]);
 
-	std::vector<std::vector<double>> derivatives(derivative + 1, std::vector<double>(degree + 1));
-	std::vector<std::vector<double>> ndu(degree + 1,std::vector<double>(degree + 1));
+	return BasisFunctionsDerivativesUnchecked(spanIndex, degree, derivative, knotVector, paramT);
+}
 
-	ndu[0][0] = 1.0;
+std::vector<std::vector<double>> LNLib::Polynomials::BasisFunctionsDerivativesUnchecked(int spanIndex, int degree, int derivative, const LN_ArrayView<double>& knotVector, double paramT)
+{
+	int n = degree + 1;
+	LN_ScratchBuffer<(MaxStackDegree + 1) * (MaxStackDegree + 1)> buffer((derivative + 1) * n);
+	BasisFunctionsDerivativesUnchecked(spanIndex, degree, derivative, knotVector, paramT, buffer.Data());
 
-	std::vector<double> left(degree + 1);
-	std::vector<double> right(degree + 1);
+	std::vector<std::vector<double>> derivatives(derivative + 1, std::vector<double>(n));
+	for (int k = 0; k <= derivative; k++)
+	{
+		std::copy(buffer.Data() + k * n, buffer.Data() + (k + 1) * n, derivatives[k].begin());
+	}
+	return derivatives;
+}
+
+void LNLib::Polynomials::BasisFunctionsDerivativesUnchecked(int spanIndex, int degree, int derivative, const LN_ArrayView<double>& knotVector, double paramT, double* derivatives)
+{
+	switch (degree)
+	{
+	case 1:
+		BasisFunctionsDerivativesUnchecked<1>(spanIndex, derivative, knotVector, paramT, derivatives);
+		break;
+	case 2:
+		BasisFunctionsDerivativesUnchecked<2>(spanIndex, derivative, knotVector, paramT, derivatives);
+		break;
+	case 3:
+		BasisFunctionsDerivativesUnchecked<3>(spanIndex, derivative, knotVector, paramT, derivatives);
+		break;
+	case 4:
+		BasisFunctionsDerivativesUnchecked<4>(spanIndex, derivative, knotVector, paramT, derivatives);
+		break;
+	case 5:
+		BasisFunctionsDerivativesUnchecked<5>(spanIndex, derivative, knotVector, paramT, derivatives);
+		break;
+	default:
+	{
+		LN_ScratchBuffer<(MaxStackDegree + 1) * (MaxStackDegree + 1)> ndu((degree + 1) * (degree + 1));
+		LN_ScratchBuffer<2 * (MaxStackDegree + 1)> a(2 * (degree + 1));
+		BasisFunctionsDerivativesKernel(spanIndex, degree, derivative, knotVector, paramT, ndu.Data(), a.Data(), derivatives);
+		break;
+	}
+	}
+}
 
-	double saved = 0.0;
-	double temp = 0.0;
+void LNLib::Polynomials::BasisFunctionsDerivativesUnchecked(int spanIndex, int degree, int derivative, const LN_ArrayView<double>& knotVector, double paramT, const double* inverseDenominators, double* derivatives)
+{
+	const int n = degree + 1;
+	LN_ScratchBuffer<(MaxStackDegree + 1) * (MaxStackDegree + 1)> ndu(n * n);
+	LN_ScratchBuffer<2 * (MaxStackDegree + 1)> a(2 * n);
 
+	// Only the upper triangle of ndu (the basis functions of every degree) depends on paramT;
+	// the knot differences of its lower triangle are read as reciprocals from inverseDenominators.
+	ndu[0] = 1.0;
 	for (int j = 1; j <= degree; j++)
 	{
-		left[j] = paramT - knotVector[spanIndex + 1 - j];
-		right[j] = knotVector[spanIndex + j] - paramT;
-
-		saved = 0.0;
+		const double* row = inverseDenominators + j * (j - 1) / 2;
+		double saved = 0.0;
 		for (int r = 0; r < j; r++)
 		{
-			ndu[j][r] = right[r + 1] + left[j - r];
-			temp = ndu[r][j - 1] / ndu[j][r];
-
-			ndu[r][j] = saved + right[r + 1] * temp;
-			saved = left[j - r] * temp;
+			double right = knotVector[spanIndex + r + 1] - paramT;
+			double left = paramT - knotVector[spanIndex + 1 - j + r];
+			double temp = ndu[r * n + j - 1] * row[r];
+			ndu[r * n + j] = saved + right * temp;
+			saved = left * temp;
 		}
-		ndu[j][j] = saved;
+		ndu[j * n + j] = saved;
 	}
 
 	for (int j = 0; j <= degree; j++)
 	{
-		derivatives[0][j] = ndu[j][degree];
+		derivatives[j] = ndu[j * n + degree];
 	}
 
-	std::vector<std::vector<double>> a(2,std::vector<double>(degree + 1));
 	for (int r = 0; r <= degree; r++)
 	{
-		int s1 = 0; 
-		int s2 = 1;
-		a[0][0] = 1.0;
+		double* a1 = a.Data();
+		double* a2 = a.Data() + n;
+		a1[0] = 1.0;
 
 		for (int k = 1; k <= derivative; k++)
 		{
 			double d = 0.0;
 			int rk = r - k;
 			int pk = degree - k;
+			const double* row = inverseDenominators + (pk + 1) * pk / 2;
 
 			if (r >= k)
 			{
-				a[s2][0] = a[s1][0] / ndu[pk + 1][rk];
-				d = a[s2][0] * ndu[rk][pk];
+				a2[0] = a1[0] * row[rk];
+				d = a2[0] * ndu[rk * n + pk];
 			}
 
-			int j1 = 0;
-			int j2 = 0;
-
-			if (rk >= -1)
-				j1 = 1;
-			else
-				j1 = -rk;
-
-			if (r - 1 <= pk)
-				j2 = k - 1;
-			else
-				j2 = degree - r;
+			int j1 = rk >= -1 ? 1 : -rk;
+			int j2 = r - 1 <= pk ? k - 1 : degree - r;
 
 			for (int j = j1; j <= j2; j++)
 			{
-				a[s2][j] = (a[s1][j] - a[s1][j - 1]) / ndu[pk + 1][rk + j];
-				d += a[s2][j] * ndu[rk + j][pk];
+				a2[j] = (a1[j] - a1[j - 1]) * row[rk + j];
+				d += a2[j] * ndu[(rk + j) * n + pk];
 			}
 			if (r <= pk)
 			{
-				a[s2][k] = -a[s1][k - 1] / ndu[pk + 1][r];
-				d += a[s2][k] * ndu[r][pk];
+				a2[k] = -a1[k - 1] * row[r];
+				d += a2[k] * ndu[r * n + pk];
 			}
-			derivatives[k][r] = d;
+			derivatives[k * n + r] = d;
 
-			int temp = s1; 
-			s1 = s2; 
-			s2 = temp;
+			double* swap = a1;
+			a1 = a2;
+			a2 = swap;
 		}
 	}
 
@@ -286,11 +400,10 @@ std::vector<std::vector<double>> LNLib::Polynomials::BasisFunctionsDerivatives(i
 	{
 		for (int j = 0; j <= degree; j++)
 		{
-			derivatives[k][j] *= r;
+			derivatives[k * n + j] *= r;
 		}
 		r *= degree - k;
 	}
-	return derivatives;
 }
 
 double LNLib::Polynomials::OneBasisFunction(int spanIndex, int degree, const std::vector<double>& knotVector, double paramT)
@@ -441,6 +554,11 @@ std::vector<double> LNLib::Polynomials::OneBasisFunctionDerivative(int spanIndex
 }
 
 std::vector<std::vector<double>> LNLib::Polynomials::AllBasisFunctions(int spanIndex, int degree, const std::vector<double>& knotVector, double knot)
+{
+	return AllBasisFunctions(spanIndex, degree, LN_ArrayView<double>(knotVector), knot);
+}
+
+std::vector<std::vector<double>> LNLib::Polynomials::AllBasisFunctions(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double knot)
 {
 	VALIDATE_ARGUMENT(spanIndex >= 0, "spanIndex", "SpanIndex must greater than or equals zero.");
 	VALIDATE_ARGUMENT(degree >= 0, "degree", "Degree must greater than or equals zero.");
@@ -448,16 +566,43 @@ std::vector<std::vector<double>> LNLib::Polynomials::AllBasisFunctions(int spanI
 	VALIDATE_ARGUMENT(ValidationUtils::IsValidKnotVector(knotVector), "knotVector", "KnotVector must be a nondecreasing sequence of real numbers.");
 	VALIDATE_ARGUMENT_RANGE(knot, knotVector[0], knotVector[knotVector.size() - 1]);
 
-	std::vector<std::vector<double>> result(degree + 1, std::vector<double>(degree + 1));
-	for (int i = 0; i <= degree; i++)
+	return AllBasisFunctionsUnchecked(spanIndex, degree, knotVector, knot);
+}
+
+std::vector<std::vector<double>> LNLib::Polynomials::AllBasisFunctionsUnchecked(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double knot)
+{
+	int n = degree + 1;
+	LN_ScratchBuffer<(MaxStackDegree + 1) * (MaxStackDegree + 1)> buffer(n * n);
+	AllBasisFunctionsUnchecked(spanIndex, degree, knotVector, knot, buffer.Data());
+
+	std::vector<std::vector<double>> result(n, std::vector<double>(n));
+	for (int j = 0; j <= degree; j++)
 	{
-		std::vector<double> basis = Polynomials::BasisFunctions(spanIndex, i, knotVector, knot);
-		for (int j = 0; j <= i; j++)
+		std::copy(buffer.Data() + j * n, buffer.Data() + (j + 1) * n, result[j].begin());
+	}
+	return result;
+}
+
+void LNLib::Polynomials::AllBasisFunctionsUnchecked(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double knot, double* allBasisFunctions)
+{
+	// Column i of the A2.2 triangle holds the basis functions of degree i, so one pass yields every degree.
+	int n = degree + 1;
+	std::fill(allBasisFunctions, allBasisFunctions + n * n, 0.0);
+
+	allBasisFunctions[0] = 1.0;
+	for (int j = 1; j <= degree; j++)
+	{
+		double saved = 0.0;
+		for (int r = 0; r < j; r++)
 		{
-			result[j][i] = basis[j];
+			double right = knotVector[spanIndex + r + 1] - knot;
+			double left = knot - knotVector[spanIndex + 1 - j + r];
+			double temp = allBasisFunctions[r * n + j - 1] / (right + left);
+			allBasisFunctions[r * n + j] = saved + right * temp;
+			saved = left * temp;
 		}
+		allBasisFunctions[j * n + j] = saved;
 	}
-	return result;
 }
 
 std::vector<std::vector<double>> LNLib::Polynomials::BezierToPowerMatrix(int degree)
@@ -472,13 +617,13 @@ std::vector<std::vector<double>> LNLib::Polynomials::BezierToPowerMatrix(int deg
 	}
 
 	matrix[0][0] = matrix[degree][degree] = 1.0;
-	matrix[degree][0] = degree % 2 == 0 ? -1.0 : 1.0;
+	matrix[degree][0] = degree % 2 == 0 ? 1.0 : -1.0;
 
 	double sign = -1.0;
 	for (int i = 1; i < degree; i++)
 	{
 		matrix[i][i] = MathUtils::Binomial(degree,i);
-		matrix[i][0] = matrix[degree][degree - 1] = sign * matrix[i][i];
+		matrix[i][0] = matrix[degree][degree - i] = sign * matrix[i][i];
 		sign = -sign;
 	}
 
@@ -11,6 +11,7 @@
 #include "Projection.h"
 #include "XYZ.h"
 #include "MathUtils.h"
+#include <algorithm>
 
 LNLib::XYZ LNLib::Projection::PointToRay(const XYZ& origin, const XYZ& vector, const XYZ& Point)
 {
@@ -36,6 +37,28 @@ bool LNLib::Projection::PointToLine(const XYZ& start, const XYZ& end, const XYZ&
     return true;
 }
 
+double LNLib::Projection::DistanceToLine(const XYZ& start, const XYZ& end, const XYZ& point)
+{
+    XYZ direction = end - start;
+    double length = direction.Length();
+    if (MathUtils::IsAlmostEqualTo(length, 0.0))
+    {
+        return point.Distance(start);
+    }
+    return (point - start).CrossProduct(direction).Length() / length;
+}
+
+double LNLib::Projection::DistanceToBox(const XYZ& min, const XYZ& max, const XYZ& point)
+{
+    double squareDistance = 0.0;
+    for (int k = 0; k < 3; k++)
+    {
+        double distance = std::max(std::max(min[k] - point[k], point[k] - max[k]), 0.0);
+        squareDistance += distance * distance;
+    }
+    return sqrt(squareDistance);
+}
+
 LNLib::XYZ LNLib::Projection::Stereographic(const XYZ& pointOnSphere, double radius)
 {
     double x = pointOnSphere.GetX();
@@ -0,0 +1,371 @@
+/*
+ * Author:
+ * 2026/10/16 - LNLib contributors
+ * Individual authors are recorded in the git history of this file.
+ *
+ * Use of this source code is governed by a GPL-3.0 license that can be found in
+ * the LICENSE file.
+ */
+
+#include "SimdKernels.h"
+#include "Polynomials.h"
+#include "XYZ.h"
+#include <vector>
+#include <algorithm>
+#include <atomic>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define LNLIB_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define LNLIB_AVX2_TARGET
+#else
+#define LNLIB_AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+namespace LNLib
+{
+	/// <summary>
+	/// Read by every kernel dispatch, possibly from parallel workers, while SetAVX2Enabled may write it.
+	/// </summary>
+	std::atomic<bool> avx2Enabled(true);
+
+	bool DetectAVX2()
+	{
+#if defined(LNLIB_SIMD_X86) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+		{
+			return false;
+		}
+		__cpuid(info, 1);
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool fma = (info[2] & (1 << 12)) != 0;
+		if (!osxsave || !fma || (_xgetbv(0) & 0x6) != 0x6)
+		{
+			return false;
+		}
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#elif defined(LNLIB_SIMD_X86) && defined(__GNUC__)
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+		return false;
+#endif
+	}
+
+	void GetPointsOnCurveScalar(const LN_CompiledNurbsCurve& curve, const double* paramTs, int count, XYZ* points)
+	{
+		int degree = curve.GetDegree();
+		LN_ArrayView<double> knotVector(curve.GetKnotVector());
+		const double* X = curve.GetX().data();
+		const double* Y = curve.GetY().data();
+		const double* Z = curve.GetZ().data();
+		const double* W = curve.GetW().data();
+
+		LN_ScratchBuffer<Polynomials::MaxStackDegree + 1> N(degree + 1);
+		int spanIndex = -1;
+		for (int i = 0; i < count; i++)
+		{
+			double paramT = paramTs[i];
+			spanIndex = Polynomials::GetKnotSpanIndexUnchecked(degree, knotVector, paramT, spanIndex);
+			Polynomials::BasisFunctionsUnchecked(spanIndex, degree, knotVector, paramT, N.Data());
+
+			int first = spanIndex - degree;
+			double x = 0.0, y = 0.0, z = 0.0, w = 0.0;
+			for (int j = 0; j <= degree; j++)
+			{
+				x += N[j] * X[first + j];
+				y += N[j] * Y[first + j];
+				z += N[j] * Z[first + j];
+				w += N[j] * W[first + j];
+			}
+			points[i] = XYZ(x / w, y / w, z / w);
+		}
+	}
+
+	void EvaluateGridScalar(const LN_CompiledNurbsSurface& surface, const std::vector<int>& spansV, const std::vector<double>& basisV, int firstColumn, int columns, const double* uParams, int uCount, int vCount, XYZ* points)
+	{
+		int degreeU = surface.GetDegreeU();
+		int degreeV = surface.GetDegreeV();
+		LN_ArrayView<double> knotVectorU(surface.GetKnotVectorU());
+		const double* X = surface.GetX().data();
+		const double* Y = surface.GetY().data();
+		const double* Z = surface.GetZ().data();
+		const double* W = surface.GetW().data();
+
+		std::vector<double> isoX(columns), isoY(columns), isoZ(columns), isoW(columns);
+		LN_ScratchBuffer<Polynomials::MaxStackDegree + 1> Nu(degreeU + 1);
+		int spanIndex = -1;
+		for (int i = 0; i < uCount; i++)
+		{
+			spanIndex = Polynomials::GetKnotSpanIndexUnchecked(degreeU, knotVectorU, uParams[i], spanIndex);
+			Polynomials::BasisFunctionsUnchecked(spanIndex, degreeU, knotVectorU, uParams[i], Nu.Data());
+
+			std::fill(isoX.begin(), isoX.end(), 0.0);
+			std::fill(isoY.begin(), isoY.end(), 0.0);
+			std::fill(isoZ.begin(), isoZ.end(), 0.0);
+			std::fill(isoW.begin(), isoW.end(), 0.0);
+			for (int r = 0; r <= degreeU; r++)
+			{
+				int offset = (spanIndex - degreeU + r) * surface.GetColumns() + firstColumn;
+				double coefficient = Nu[r];
+				for (int c = 0; c < columns; c++)
+				{
+					isoX[c] += coefficient * X[offset + c];
+					isoY[c] += coefficient * Y[offset + c];
+					isoZ[c] += coefficient * Z[offset + c];
+					isoW[c] += coefficient * W[offset + c];
+				}
+			}
+
+			for (int j = 0; j < vCount; j++)
+			{
+				const double* Nv = basisV.data() + j * (degreeV + 1);
+				int first = spansV[j] - degreeV - firstColumn;
+				double x = 0.0, y = 0.0, z = 0.0, w = 0.0;
+				for (int s = 0; s <= degreeV; s++)
+				{
+					x += Nv[s] * isoX[first + s];
+					y += Nv[s] * isoY[first + s];
+					z += Nv[s] * isoZ[first + s];
+					w += Nv[s] * isoW[first + s];
+				}
+				points[i * vCount + j] = XYZ(x / w, y / w, z / w);
+			}
+		}
+	}
+
+#if defined(LNLIB_SIMD_X86)
+	/// <summary>
+	/// Gathers base[index[k]] for the four lanes. The masked form with a zeroed source
+	/// avoids the -Wmaybe-uninitialized warnings GCC emits for _mm256_i32gather_pd.
+	/// </summary>
+	LNLIB_AVX2_TARGET
+	inline __m256d Gather(const double* base, __m128i index)
+	{
+		const __m256d allLanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+		return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, index, allLanes, 8);
+	}
+
+	LNLIB_AVX2_TARGET
+	void GetPointsOnCurveAVX2(const LN_CompiledNurbsCurve& curve, const double* paramTs, int count, XYZ* points)
+	{
+		int degree = curve.GetDegree();
+		LN_ArrayView<double> knotVector(curve.GetKnotVector());
+		const double* knots = curve.GetKnotVector().data();
+		const double* X = curve.GetX().data();
+		const double* Y = curve.GetY().data();
+		const double* Z = curve.GetZ().data();
+		const double* W = curve.GetW().data();
+
+		__m256d N[Polynomials::MaxStackDegree + 1];
+		int spans[4];
+		double x[4], y[4], z[4];
+
+		int spanIndex = -1;
+		int i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			for (int k = 0; k < 4; k++)
+			{
+				spanIndex = Polynomials::GetKnotSpanIndexUnchecked(degree, knotVector, paramTs[i + k], spanIndex);
+				spans[k] = spanIndex;
+			}
+			__m128i span = _mm_loadu_si128(reinterpret_cast<const __m128i*>(spans));
+			__m256d t = _mm256_loadu_pd(paramTs + i);
+
+			N[0] = _mm256_set1_pd(1.0);
+			for (int j = 1; j <= degree; j++)
+			{
+				__m256d saved = _mm256_setzero_pd();
+				for (int r = 0; r < j; r++)
+				{
+					__m256d right = _mm256_sub_pd(Gather(knots, _mm_add_epi32(span, _mm_set1_epi32(r + 1))), t);
+					__m256d left = _mm256_sub_pd(t, Gather(knots, _mm_add_epi32(span, _mm_set1_epi32(1 - j + r))));
+					__m256d temp = _mm256_div_pd(N[r], _mm256_add_pd(right, left));
+					N[r] = _mm256_fmadd_pd(right, temp, saved);
+					saved = _mm256_mul_pd(left, temp);
+				}
+				N[j] = saved;
+			}
+
+			__m256d sx = _mm256_setzero_pd();
+			__m256d sy = _mm256_setzero_pd();
+			__m256d sz = _mm256_setzero_pd();
+			__m256d sw = _mm256_setzero_pd();
+			__m128i first = _mm_sub_epi32(span, _mm_set1_epi32(degree));
+			for (int j = 0; j <= degree; j++)
+			{
+				__m128i index = _mm_add_epi32(first, _mm_set1_epi32(j));
+				sx = _mm256_fmadd_pd(N[j], Gather(X, index), sx);
+				sy = _mm256_fmadd_pd(N[j], Gather(Y, index), sy);
+				sz = _mm256_fmadd_pd(N[j], Gather(Z, index), sz);
+				sw = _mm256_fmadd_pd(N[j], Gather(W, index), sw);
+			}
+			_mm256_storeu_pd(x, _mm256_div_pd(sx, sw));
+			_mm256_storeu_pd(y, _mm256_div_pd(sy, sw));
+			_mm256_storeu_pd(z, _mm256_div_pd(sz, sw));
+			for (int k = 0; k < 4; k++)
+			{
+				points[i + k] = XYZ(x[k], y[k], z[k]);
+			}
+		}
+		GetPointsOnCurveScalar(curve, paramTs + i, count - i, points + i);
+	}
+
+	LNLIB_AVX2_TARGET
+	void EvaluateGridAVX2(const LN_CompiledNurbsSurface& surface, const std::vector<int>& spansV, const std::vector<double>& basisV, int firstColumn, int columns, const double* uParams, int uCount, int vCount, XYZ* points)
+	{
+		int degreeU = surface.GetDegreeU();
+		int degreeV = surface.GetDegreeV();
+		LN_ArrayView<double> knotVectorU(surface.GetKnotVectorU());
+
+		std::vector<double, LN_AlignedAllocator<double>> isoX(columns), isoY(columns), isoZ(columns), isoW(columns);
+		LN_ScratchBuffer<Polynomials::MaxStackDegree + 1> Nu(degreeU + 1);
+		double x[4], y[4], z[4];
+
+		int spanIndex = -1;
+		for (int i = 0; i < uCount; i++)
+		{
+			spanIndex = Polynomials::GetKnotSpanIndexUnchecked(degreeU, knotVectorU, uParams[i], spanIndex);
+			Polynomials::BasisFunctionsUnchecked(spanIndex, degreeU, knotVectorU, uParams[i], Nu.Data());
+
+			std::fill(isoX.begin(), isoX.end(), 0.0);
+			std::fill(isoY.begin(), isoY.end(), 0.0);
+			std::fill(isoZ.begin(), isoZ.end(), 0.0);
+			std::fill(isoW.begin(), isoW.end(), 0.0);
+			for (int r = 0; r <= degreeU; r++)
+			{
+				int offset = (spanIndex - degreeU + r) * surface.GetColumns() + firstColumn;
+				const double* rowX = surface.GetX().data() + offset;
+				const double* rowY = surface.GetY().data() + offset;
+				const double* rowZ = surface.GetZ().data() + offset;
+				const double* rowW = surface.GetW().data() + offset;
+				__m256d coefficient = _mm256_set1_pd(Nu[r]);
+				int c = 0;
+				for (; c + 4 <= columns; c += 4)
+				{
+					_mm256_store_pd(&isoX[c], _mm256_fmadd_pd(coefficient, _mm256_loadu_pd(rowX + c), _mm256_load_pd(&isoX[c])));
+					_mm256_store_pd(&isoY[c], _mm256_fmadd_pd(coefficient, _mm256_loadu_pd(rowY + c), _mm256_load_pd(&isoY[c])));
+					_mm256_store_pd(&isoZ[c], _mm256_fmadd_pd(coefficient, _mm256_loadu_pd(rowZ + c), _mm256_load_pd(&isoZ[c])));
+					_mm256_store_pd(&isoW[c], _mm256_fmadd_pd(coefficient, _mm256_loadu_pd(rowW + c), _mm256_load_pd(&isoW[c])));
+				}
+				for (; c < columns; c++)
+				{
+					isoX[c] += Nu[r] * rowX[c];
+					isoY[c] += Nu[r] * rowY[c];
+					isoZ[c] += Nu[r] * rowZ[c];
+					isoW[c] += Nu[r] * rowW[c];
+				}
+			}
+
+			int j = 0;
+			for (; j + 4 <= vCount; j += 4)
+			{
+				__m128i first = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&spansV[j])), _mm_set1_epi32(degreeV + firstColumn));
+				__m256d sx = _mm256_setzero_pd();
+				__m256d sy = _mm256_setzero_pd();
+				__m256d sz = _mm256_setzero_pd();
+				__m256d sw = _mm256_setzero_pd();
+				for (int s = 0; s <= degreeV; s++)
+				{
+					__m256d Nv = _mm256_set_pd(basisV[(j + 3) * (degreeV + 1) + s], basisV[(j + 2) * (degreeV + 1) + s], basisV[(j + 1) * (degreeV + 1) + s], basisV[j * (degreeV + 1) + s]);
+					__m128i index = _mm_add_epi32(first, _mm_set1_epi32(s));
+					sx = _mm256_fmadd_pd(Nv, Gather(isoX.data(), index), sx);
+					sy = _mm256_fmadd_pd(Nv, Gather(isoY.data(), index), sy);
+					sz = _mm256_fmadd_pd(Nv, Gather(isoZ.data(), index), sz);
+					sw = _mm256_fmadd_pd(Nv, Gather(isoW.data(), index), sw);
+				}
+				_mm256_storeu_pd(x, _mm256_div_pd(sx, sw));
+				_mm256_storeu_pd(y, _mm256_div_pd(sy, sw));
+				_mm256_storeu_pd(z, _mm256_div_pd(sz, sw));
+				for (int k = 0; k < 4; k++)
+				{
+					points[i * vCount + j + k] = XYZ(x[k], y[k], z[k]);
+				}
+			}
+			for (; j < vCount; j++)
+			{
+				const double* Nv = basisV.data() + j * (degreeV + 1);
+				int first = spansV[j] - degreeV - firstColumn;
+				double sx = 0.0, sy = 0.0, sz = 0.0, sw = 0.0;
+				for (int s = 0; s <= degreeV; s++)
+				{
+					sx += Nv[s] * isoX[first + s];
+					sy += Nv[s] * isoY[first + s];
+					sz += Nv[s] * isoZ[first + s];
+					sw += Nv[s] * isoW[first + s];
+				}
+				points[i * vCount + j] = XYZ(sx / sw, sy / sw, sz / sw);
+			}
+		}
+	}
+#endif
+}
+
+bool LNLib::SimdKernels::IsAVX2Supported()
+{
+	static const bool supported = DetectAVX2();
+	return supported;
+}
+
+void LNLib::SimdKernels::SetAVX2Enabled(bool enabled)
+{
+	avx2Enabled.store(enabled);
+}
+
+bool LNLib::SimdKernels::IsAVX2Enabled()
+{
+	return avx2Enabled.load() && IsAVX2Supported();
+}
+
+void LNLib::SimdKernels::GetPointsOnCurve(const LN_CompiledNurbsCurve& curve, const double* paramTs, int count, XYZ* points)
+{
+#if defined(LNLIB_SIMD_X86)
+	if (IsAVX2Enabled() && curve.GetDegree() <= Polynomials::MaxStackDegree)
+	{
+		GetPointsOnCurveAVX2(curve, paramTs, count, points);
+		return;
+	}
+#endif
+	GetPointsOnCurveScalar(curve, paramTs, count, points);
+}
+
+void LNLib::SimdKernels::EvaluateGrid(const LN_CompiledNurbsSurface& surface, const double* uParams, int uCount, const double* vParams, int vCount, XYZ* points)
+{
+	if (uCount == 0 || vCount == 0)
+	{
+		return;
+	}
+
+	int degreeV = surface.GetDegreeV();
+	LN_ArrayView<double> knotVectorV(surface.GetKnotVectorV());
+
+	std::vector<int> spansV(vCount);
+	std::vector<double> basisV(vCount * (degreeV + 1));
+	int spanIndex = -1;
+	for (int j = 0; j < vCount; j++)
+	{
+		spanIndex = Polynomials::GetKnotSpanIndexUnchecked(degreeV, knotVectorV, vParams[j], spanIndex);
+		spansV[j] = spanIndex;
+		Polynomials::BasisFunctionsUnchecked(spanIndex, degreeV, knotVectorV, vParams[j], basisV.data() + j * (degreeV + 1));
+	}
+
+	int firstColumn = *std::min_element(spansV.begin(), spansV.end()) - degreeV;
+	int lastColumn = *std::max_element(spansV.begin(), spansV.end());
+	int columns = lastColumn - firstColumn + 1;
+
+#if defined(LNLIB_SIMD_X86)
+	if (IsAVX2Enabled())
+	{
+		EvaluateGridAVX2(surface, spansV, basisV, firstColumn, columns, uParams, uCount, vCount, points);
+		return;
+	}
+#endif
+	EvaluateGridScalar(surface, spansV, basisV, firstColumn, columns, uParams, uCount, vCount, points);
+}
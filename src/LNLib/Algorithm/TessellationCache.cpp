@@ -0,0 +1,267 @@
+/*
+ * Author:
+ * 2026/10/16 - LNLib contributors
+ * Individual authors are recorded in the git history of this file.
+ *
+ * Use of this source code is governed by a GPL-3.0 license that can be found in
+ * the LICENSE file.
+ */
+
+#include "TessellationCache.h"
+#include "NurbsCurve.h"
+#include "NurbsSurface.h"
+#include "XYZW.h"
+#include "LNLibExceptions.h"
+#include <cstring>
+
+using namespace LNLib;
+
+namespace LNLib
+{
+	const unsigned long long FNVOffsetBasis = 14695981039346656037ULL;
+	const unsigned long long FNVPrime = 1099511628211ULL;
+
+	void HashBytes(unsigned long long& hash, const void* data, size_t size)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ bytes[i]) * FNVPrime;
+		}
+	}
+
+	void HashValue(unsigned long long& hash, double value)
+	{
+		// -0.0 compares equal to 0.0 but differs in the sign bit.
+		if (value == 0.0)
+		{
+			value = 0.0;
+		}
+		unsigned long long bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		HashBytes(hash, &bits, sizeof(bits));
+	}
+
+	void HashControlPoints(unsigned long long& hash, const std::vector<XYZW>& controlPoints)
+	{
+		int count = controlPoints.size();
+		HashBytes(hash, &count, sizeof(count));
+		for (int i = 0; i < count; i++)
+		{
+			for (int k = 0; k < 4; k++)
+			{
+				HashValue(hash, controlPoints[i][k]);
+			}
+		}
+	}
+
+	void HashKnots(unsigned long long& hash, const std::vector<double>& knots)
+	{
+		int count = knots.size();
+		HashBytes(hash, &count, sizeof(count));
+		for (int i = 0; i < count; i++)
+		{
+			HashValue(hash, knots[i]);
+		}
+	}
+
+	bool IsSameControlPoints(const std::vector<XYZW>& left, const std::vector<XYZW>& right)
+	{
+		if (left.size() != right.size())
+		{
+			return false;
+		}
+		for (int i = 0; i < left.size(); i++)
+		{
+			for (int k = 0; k < 4; k++)
+			{
+				if (left[i][k] != right[i][k])
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool IsSameCurve(const LN_NurbsCurve& left, const LN_NurbsCurve& right)
+	{
+		return left.Degree == right.Degree && left.KnotVector == right.KnotVector && IsSameControlPoints(left.ControlPoints, right.ControlPoints);
+	}
+
+	bool IsSameSurface(const LN_NurbsSurface& left, const LN_NurbsSurface& right)
+	{
+		if (left.DegreeU != right.DegreeU || left.DegreeV != right.DegreeV || left.KnotVectorU != right.KnotVectorU || left.KnotVectorV != right.KnotVectorV || left.ControlPoints.size() != right.ControlPoints.size())
+		{
+			return false;
+		}
+		for (int i = 0; i < left.ControlPoints.size(); i++)
+		{
+			if (!IsSameControlPoints(left.ControlPoints[i], right.ControlPoints[i]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+LNLib::TessellationCache::TessellationCache(const std::vector<LN_TessellationTolerance>& levels, const LN_ExecutionPolicy& policy)
+{
+	VALIDATE_ARGUMENT(levels.size() > 0, "levels", "Levels must not be empty.");
+	for (int i = 0; i < levels.size(); i++)
+	{
+		VALIDATE_ARGUMENT(levels[i].ChordHeight > 0.0, "levels", "ChordHeight must greater than zero.");
+		VALIDATE_ARGUMENT(levels[i].AngleTolerance > 0.0, "levels", "AngleTolerance must greater than zero.");
+		VALIDATE_ARGUMENT(levels[i].MaxEdgeLength >= 0.0, "levels", "MaxEdgeLength must greater than or equals zero.");
+	}
+	VALIDATE_ARGUMENT(policy.ThreadCount >= 0, "policy", "ThreadCount must greater than or equals zero.");
+
+	m_levels = levels;
+	m_policy = policy;
+	m_curveCount = 0;
+	m_surfaceCount = 0;
+	m_generatedCount = 0;
+}
+
+int LNLib::TessellationCache::GetLevelCount() const
+{
+	return m_levels.size();
+}
+
+const LN_TessellationTolerance& LNLib::TessellationCache::GetLevel(int level) const
+{
+	VALIDATE_ARGUMENT_RANGE(level, 0, GetLevelCount() - 1);
+	return m_levels[level];
+}
+
+int LNLib::TessellationCache::SelectLevel(double chordHeight) const
+{
+	int selected = -1;
+	int finest = 0;
+	for (int i = 0; i < m_levels.size(); i++)
+	{
+		double height = m_levels[i].ChordHeight;
+		if (height <= chordHeight && (selected < 0 || height > m_levels[selected].ChordHeight))
+		{
+			selected = i;
+		}
+		if (height < m_levels[finest].ChordHeight)
+		{
+			finest = i;
+		}
+	}
+	return selected < 0 ? finest : selected;
+}
+
+const LN_Polyline& LNLib::TessellationCache::GetTessellation(const LN_NurbsCurve& curve, int level)
+{
+	VALIDATE_ARGUMENT_RANGE(level, 0, GetLevelCount() - 1);
+
+	// Entries live in lists, so the references handed out survive later insertions.
+	std::list<CurveEntry>& bucket = m_curves[GetHash(curve)];
+	std::list<CurveEntry>::iterator it = bucket.begin();
+	while (it != bucket.end() && !IsSameCurve(it->Curve, curve))
+	{
+		++it;
+	}
+	if (it == bucket.end())
+	{
+		CurveEntry entry;
+		entry.Curve = curve;
+		entry.Levels.resize(m_levels.size());
+		entry.IsGenerated.resize(m_levels.size(), false);
+		it = bucket.insert(bucket.end(), entry);
+		m_curveCount++;
+	}
+
+	CurveEntry& entry = *it;
+	if (!entry.IsGenerated[level])
+	{
+		LN_Polyline& polyline = entry.Levels[level];
+		NurbsCurve::AdaptiveTessellate(entry.Curve, m_levels[level], polyline.Points, polyline.Params);
+		entry.IsGenerated[level] = true;
+		m_generatedCount++;
+	}
+	return entry.Levels[level];
+}
+
+const LN_Mesh& LNLib::TessellationCache::GetTessellation(const LN_NurbsSurface& surface, int level)
+{
+	VALIDATE_ARGUMENT_RANGE(level, 0, GetLevelCount() - 1);
+
+	// Entries live in lists, so the references handed out survive later insertions.
+	std::list<SurfaceEntry>& bucket = m_surfaces[GetHash(surface)];
+	std::list<SurfaceEntry>::iterator it = bucket.begin();
+	while (it != bucket.end() && !IsSameSurface(it->Surface, surface))
+	{
+		++it;
+	}
+	if (it == bucket.end())
+	{
+		SurfaceEntry entry;
+		entry.Surface = surface;
+		entry.Levels.resize(m_levels.size());
+		entry.IsGenerated.resize(m_levels.size(), false);
+		it = bucket.insert(bucket.end(), entry);
+		m_surfaceCount++;
+	}
+
+	SurfaceEntry& entry = *it;
+	if (!entry.IsGenerated[level])
+	{
+		NurbsSurface::AdaptiveTessellate(entry.Surface, m_levels[level], entry.Levels[level], m_policy);
+		entry.IsGenerated[level] = true;
+		m_generatedCount++;
+	}
+	return entry.Levels[level];
+}
+
+int LNLib::TessellationCache::GetCurveCount() const
+{
+	return m_curveCount;
+}
+
+int LNLib::TessellationCache::GetSurfaceCount() const
+{
+	return m_surfaceCount;
+}
+
+int LNLib::TessellationCache::GetGeneratedCount() const
+{
+	return m_generatedCount;
+}
+
+void LNLib::TessellationCache::Clear()
+{
+	m_curves.clear();
+	m_surfaces.clear();
+	m_curveCount = 0;
+	m_surfaceCount = 0;
+	m_generatedCount = 0;
+}
+
+unsigned long long LNLib::TessellationCache::GetHash(const LN_NurbsCurve& curve)
+{
+	unsigned long long hash = FNVOffsetBasis;
+	HashBytes(hash, &curve.Degree, sizeof(curve.Degree));
+	HashKnots(hash, curve.KnotVector);
+	HashControlPoints(hash, curve.ControlPoints);
+	return hash;
+}
+
+unsigned long long LNLib::TessellationCache::GetHash(const LN_NurbsSurface& surface)
+{
+	unsigned long long hash = FNVOffsetBasis;
+	HashBytes(hash, &surface.DegreeU, sizeof(surface.DegreeU));
+	HashBytes(hash, &surface.DegreeV, sizeof(surface.DegreeV));
+	HashKnots(hash, surface.KnotVectorU);
+	HashKnots(hash, surface.KnotVectorV);
+	int rows = surface.ControlPoints.size();
+	HashBytes(hash, &rows, sizeof(rows));
+	for (int i = 0; i < rows; i++)
+	{
+		HashControlPoints(hash, surface.ControlPoints[i]);
+	}
+	return hash;
+}
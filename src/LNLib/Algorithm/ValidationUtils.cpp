@@ -25,6 +25,18 @@ bool LNLib::ValidationUtils::IsValidKnotVector(const std::vector<double>& knotVe
 	return std::is_sorted(knotVector.begin(), knotVector.end());
 }
 
+bool LNLib::ValidationUtils::IsValidKnotVector(const LN_ArrayView<double>& knotVector)
+{
+	for (int i = 1; i < knotVector.size(); i++)
+	{
+		if (knotVector[i] < knotVector[i - 1])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 bool LNLib::ValidationUtils::IsValidBspline(int degree, int knotVectorCount, int controlPointsCount)
 {
 	return (knotVectorCount - 1) == (controlPointsCount - 1) + degree + 1;
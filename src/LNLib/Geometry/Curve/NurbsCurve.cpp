@@ -21,12 +21,19 @@
 #include "Projection.h"
 #include "ValidationUtils.h"
 #include "KnotVectorUtils.h"
+#include "ControlPointsUtils.h"
 #include "Interpolation.h"
 #include "Integrator.h"
+#include "SimdKernels.h"
+#include "ParallelUtils.h"
+#include "TessellationSink.h"
 #include "LNLibExceptions.h"
 #include "LNObject.h"
 #include <vector>
+#include <queue>
+#include <functional>
 #include <algorithm>
+#include <limits>
 
 namespace LNLib
 {
@@ -39,6 +46,132 @@ namespace LNLib
 		}
 	};
 
+	void ComputeRationalDerivatives(const XYZW* ders, int derivative, XYZ* derivatives)
+	{
+		double weight = ders[0].GetW();
+		for (int k = 0; k <= derivative; k++)
+		{
+			const double* binomial = MathUtils::BinomialRow(k);
+			XYZ v = XYZ(ders[k].GetWX(), ders[k].GetWY(), ders[k].GetWZ());
+			for (int i = 1; i <= k; i++)
+			{
+				v = v - (binomial[i] * ders[i].GetW()) * derivatives[k - i];
+			}
+			derivatives[k] = v / weight;
+		}
+	}
+
+	std::vector<XYZ> ComputeRationalDerivatives(const XYZW* ders, int derivative)
+	{
+		std::vector<XYZ> derivatives(derivative + 1);
+		ComputeRationalDerivatives(ders, derivative, derivatives.data());
+		return derivatives;
+	}
+
+	void ComputeCheckedCurveDerivatives(const LN_CheckedNurbsCurve& curve, const XYZW* ders, int derivative, XYZ* derivatives)
+	{
+		if (curve.IsRational())
+		{
+			ComputeRationalDerivatives(ders, derivative, derivatives);
+			return;
+		}
+		for (int k = 0; k <= derivative; k++)
+		{
+			derivatives[k] = XYZ(ders[k].GetWX(), ders[k].GetWY(), ders[k].GetWZ());
+		}
+	}
+
+	double CurvatureFromDerivatives(const std::vector<XYZ>& derivatives)
+	{
+		XYZ d1 = derivatives[1];
+		XYZ d2 = derivatives[2];
+		if (MathUtils::IsAlmostEqualTo(d1.Length(), 1.0))
+		{
+			return d2.Length();
+		}
+		double numerator = d1.CrossProduct(d2).Length();
+		double denominator = pow(d1.Length(), 3);
+		return numerator / denominator;
+	}
+
+	const int MaxTessellationDepth = 16;
+
+	class CurvePointsCollector : public CurveTessellationSink
+	{
+	public:
+		CurvePointsCollector(std::vector<XYZ>& points, std::vector<double>& params) : Points(points), Params(params) {}
+
+		void AddPoints(const XYZ* points, const double* params, int count)
+		{
+			Points.insert(Points.end(), points, points + count);
+			Params.insert(Params.end(), params, params + count);
+		}
+
+	private:
+		std::vector<XYZ>& Points;
+		std::vector<double>& Params;
+	};
+
+	/// <summary>
+	/// Bisects [startT, endT] until it meets tolerance, appending the end point of every accepted edge.
+	/// start, middle and end hold C and C' at startT, the midpoint and endT; the quarter points are sampled as well,
+	/// so an S-shaped edge whose midpoint happens to lie on the chord is still split.
+	/// </summary>
+	void TessellateCurveSegment(const LN_CheckedNurbsCurve& curve, const LN_TessellationTolerance& tolerance, double startT, const std::vector<XYZ>& start, const std::vector<XYZ>& middle, double endT, const std::vector<XYZ>& end, int depth, std::vector<XYZ>& points, std::vector<double>& params)
+	{
+		double middleT = (startT + endT) / 2.0;
+		if (depth < MaxTessellationDepth)
+		{
+			std::vector<XYZ> left = NurbsCurve::ComputeRationalCurveDerivatives(curve, 1, (startT + middleT) / 2.0);
+			std::vector<XYZ> right = NurbsCurve::ComputeRationalCurveDerivatives(curve, 1, (middleT + endT) / 2.0);
+
+			double height = std::max(Projection::DistanceToLine(start[0], end[0], middle[0]), std::max(Projection::DistanceToLine(start[0], end[0], left[0]), Projection::DistanceToLine(start[0], end[0], right[0])));
+			double angle = std::max(start[1].AngleTo(middle[1]), middle[1].AngleTo(end[1]));
+			double length = start[0].Distance(end[0]);
+
+			if (height > tolerance.ChordHeight ||
+				angle > tolerance.AngleTolerance ||
+				(tolerance.MaxEdgeLength > 0.0 && length > tolerance.MaxEdgeLength))
+			{
+				TessellateCurveSegment(curve, tolerance, startT, start, left, middleT, middle, depth + 1, points, params);
+				TessellateCurveSegment(curve, tolerance, middleT, middle, right, endT, end, depth + 1, points, params);
+				return;
+			}
+		}
+		points.emplace_back(end[0]);
+		params.emplace_back(endT);
+	}
+
+	XYZ NormalFromDerivatives(const std::vector<XYZ>& derivatives, CurveNormal normalType)
+	{
+		XYZ tangent = derivatives[1];
+		XYZ der2 = derivatives[2];
+		if (MathUtils::IsAlmostEqualTo(tangent.Length(), 1.0))
+		{
+			XYZ curveNormal = der2 / der2.Length();
+			if (normalType == CurveNormal::Normal)
+			{
+				return curveNormal;
+			}
+			else
+			{
+				return tangent.CrossProduct(curveNormal);
+			}
+		}
+		else
+		{
+			XYZ b = tangent.CrossProduct(der2) / (tangent.CrossProduct(der2).Length());
+			if (normalType == CurveNormal::Binormal)
+			{
+				return b;
+			}
+			else
+			{
+				return b.Normalize().CrossProduct(tangent.Normalize());
+			}
+		}
+	}
+
 	double GetNode(int degree, const std::vector<double>& knotVector, int lastIndex)
 	{
 		double t = 0.0;
@@ -73,167 +206,711 @@ namespace LNLib
 		return length;
 	}
 
-	double GetParamByLength(const LN_NurbsCurve& curve, double start, double end, double givenLength, IntegratorType type)
+	const int MaxArcLengthDepth = 12;
+
+	/// <summary>
+	/// Relative accuracy of arc length tables: interval lengths and inverse lookups agree to this fraction of the length.
+	/// </summary>
+	const double ArcLengthTolerance = 1E-10;
+
+	/// <summary>
+	/// Gauss-Legendre integral of |C'(s)| over [start, end] of a Bezier segment, in its local parameters.
+	/// </summary>
+	double IntegrateSegmentSpeed(const LN_CheckedNurbsCurve& segment, double start, double end)
 	{
+		const std::vector<double>& abscissae = Integrator::GaussLegendreAbscissae;
+		const std::vector<double>& weights = Integrator::GaussLegendreWeights;
+		double half = (end - start) / 2.0;
 		double middle = (start + end) / 2.0;
+		std::vector<double> params(abscissae.size());
+		for (int i = 0; i < abscissae.size(); i++)
+		{
+			params[i] = middle + half * abscissae[i];
+		}
+		std::vector<XYZ> derivatives;
+		NurbsCurve::ComputeRationalCurveDerivatives(segment, 1, params, derivatives);
+		double sum = 0.0;
+		for (int i = 0; i < abscissae.size(); i++)
+		{
+			sum += weights[i] * derivatives[2 * i + 1].Length();
+		}
+		return half * sum;
+	}
 
-		LN_NurbsCurve left;
-		LN_NurbsCurve right;
-		NurbsCurve::SplitAt(curve, middle, left, right);
-		double length = NurbsCurve::ApproximateLength(left, type);
-		if (MathUtils::IsAlmostEqualTo(length, givenLength, Constants::DistanceEpsilon))
+	/// <summary>
+	/// Halves [start, end] of a Bezier segment until the integral over an interval agrees with the sum over its halves
+	/// within max(absoluteTolerance * (end - start), relativeTolerance * length), appending the accepted interval ends and lengths.
+	/// </summary>
+	void RefineArcLengthIntervals(const LN_CheckedNurbsCurve& segment, double start, double end, double length, double absoluteTolerance, double relativeTolerance, int depth, std::vector<double>& ends, std::vector<double>& lengths)
+	{
+		double middle = (start + end) / 2.0;
+		double left = IntegrateSegmentSpeed(segment, start, middle);
+		double right = IntegrateSegmentSpeed(segment, middle, end);
+		double tolerance = std::max(absoluteTolerance * (end - start), relativeTolerance * (left + right));
+		if (depth >= MaxArcLengthDepth || abs(left + right - length) <= tolerance)
+		{
+			ends.emplace_back(end);
+			lengths.emplace_back(left + right);
+			return;
+		}
+		RefineArcLengthIntervals(segment, start, middle, left, absoluteTolerance, relativeTolerance, depth + 1, ends, lengths);
+		RefineArcLengthIntervals(segment, middle, end, right, absoluteTolerance, relativeTolerance, depth + 1, ends, lengths);
+	}
+
+	/// <summary>
+	/// Monotone cubic Hermite inverse of the arc length over [low, high]: the local parameter at arc length target,
+	/// with end slopes 1 / startSpeed and 1 / endSpeed limited as in Fritsch-Carlson so the estimate never runs backwards.
+	/// </summary>
+	double EstimateArcLengthParameter(double low, double high, double startSpeed, double endSpeed, double intervalLength, double target)
+	{
+		double secant = (high - low) / intervalLength;
+		double alpha = 1.0 / std::max(startSpeed * secant, 1.0 / 3.0);
+		double beta = 1.0 / std::max(endSpeed * secant, 1.0 / 3.0);
+		double squared = alpha * alpha + beta * beta;
+		if (squared > 9.0)
+		{
+			double scale = 3.0 / sqrt(squared);
+			alpha *= scale;
+			beta *= scale;
+		}
+		double x = std::min(std::max(target / intervalLength, 0.0), 1.0);
+		double x2 = x * x;
+		double x3 = x2 * x;
+		return low + (high - low) * ((3 * x2 - 2 * x3) + alpha * (x3 - 2 * x2 + x) + beta * (x3 - x2));
+	}
+
+	/// <summary>
+	/// Parameter at arc length givenLength inside interval i of an arc length table.
+	/// Newton starts from the Hermite estimate and integrates only from the previous iterate to the next one.
+	/// </summary>
+	double SolveArcLengthInterval(const LN_ArcLengthTable& table, int i, double givenLength)
+	{
+		double intervalLength = table.Lengths[i + 1] - table.Lengths[i];
+		if (MathUtils::IsAlmostEqualTo(intervalLength, 0.0))
+		{
+			return table.Params[i];
+		}
+
+		double totalLength = table.Lengths[table.Lengths.size() - 1];
+		int k = table.IntervalSegments[i];
+		double a = table.Breakpoints[k];
+		double b = table.Breakpoints[k + 1];
+		const LN_CheckedNurbsCurve& segment = table.CheckedSegments[k];
+		double start = (table.Params[i] - a) / (b - a);
+		double low = start;
+		double high = (table.Params[i + 1] - a) / (b - a);
+		double target = givenLength - table.Lengths[i];
+		double paramS = EstimateArcLengthParameter(low, high, table.Speeds[2 * i] * (b - a), table.Speeds[2 * i + 1] * (b - a), intervalLength, target);
+		double length = IntegrateSegmentSpeed(segment, start, paramS);
+
+		const int maxIterations = 30;
+		for (int iteration = 0; iteration < maxIterations; iteration++)
+		{
+			double difference = length - target;
+			if (abs(difference) <= ArcLengthTolerance * totalLength)
+			{
+				break;
+			}
+			if (difference > 0.0)
+			{
+				high = paramS;
+			}
+			else
+			{
+				low = paramS;
+			}
+			double speed = NurbsCurve::ComputeRationalCurveDerivatives(segment, 1, paramS)[1].Length();
+			double next = MathUtils::IsAlmostEqualTo(speed, 0.0) ? low - 1.0 : paramS - difference / speed;
+			if (next <= low || next >= high)
+			{
+				next = (low + high) / 2.0;
+			}
+			length += IntegrateSegmentSpeed(segment, paramS, next);
+			paramS = next;
+		}
+		return a + paramS * (b - a);
+	}
+
+	/// <summary>
+	/// Interval of an arc length table containing givenLength, searched forward from interval.
+	/// </summary>
+	int FindArcLengthInterval(const LN_ArcLengthTable& table, int interval, double givenLength)
+	{
+		int last = table.IntervalSegments.size() - 1;
+		while (interval < last && table.Lengths[interval + 1] < givenLength)
 		{
-			return middle;
+			interval++;
 		}
-		else if (MathUtils::IsGreaterThan(length, givenLength, Constants::DistanceEpsilon))
+		return interval;
+	}
+
+	XYZ GetPointOnArcLengthTable(const LN_ArcLengthTable& table, int interval, double paramT)
+	{
+		int k = table.IntervalSegments[interval];
+		double a = table.Breakpoints[k];
+		double b = table.Breakpoints[k + 1];
+		return NurbsCurve::GetPointOnCurve(table.CheckedSegments[k], (paramT - a) / (b - a));
+	}
+
+	const int MaxChordIterations = 100;
+
+	/// <summary>
+	/// First point after arc length startLength whose distance to start is chordLength (within tolerance).
+	/// The distance grows at most as fast as the arc length, so stepping the arc length by the missing distance never passes that point;
+	/// once a step lands beyond it the bracket is bisected. Returns false if the curve ends first.
+	/// </summary>
+	bool FindChordPoint(const LN_ArcLengthTable& table, const XYZ& start, int startInterval, double startLength, double chordLength, double tolerance, int& interval, double& length, double& param, XYZ& point)
+	{
+		double totalLength = table.Lengths[table.Lengths.size() - 1];
+		double low = startLength;
+		double high = -1.0;
+		length = std::min(startLength + chordLength, totalLength);
+		for (int iteration = 0; iteration < MaxChordIterations; iteration++)
 		{
-			start = middle;
-			GetParamByLength(curve, start, end, givenLength, type);
+			interval = FindArcLengthInterval(table, startInterval, length);
+			param = SolveArcLengthInterval(table, interval, length);
+			point = GetPointOnArcLengthTable(table, interval, param);
+			double distance = point.Distance(start);
+			if (abs(distance - chordLength) <= tolerance)
+			{
+				return true;
+			}
+			if (distance < chordLength)
+			{
+				if (length >= totalLength)
+				{
+					return false;
+				}
+				low = length;
+			}
+			else
+			{
+				high = length;
+			}
+			length = high < 0.0 ? std::min(length + chordLength - distance, totalLength) : (low + high) / 2.0;
+		}
+		return high >= 0.0;
+	}
+
+	/// <summary>
+	/// Walks equal chords from the start of the curve, stopping after maxCount points or before a point within tolerance of the end of the curve.
+	/// Returns the distance from the last point to the end of the curve.
+	/// </summary>
+	double WalkChords(const LN_ArcLengthTable& table, double chordLength, double tolerance, int maxCount, std::vector<double>& params)
+	{
+		params.clear();
+		double totalLength = table.Lengths[table.Lengths.size() - 1];
+		XYZ end = GetPointOnArcLengthTable(table, table.IntervalSegments.size() - 1, table.Params[table.Params.size() - 1]);
+		XYZ start = GetPointOnArcLengthTable(table, 0, table.Params[0]);
+		int interval = 0;
+		double length = 0.0;
+		while (params.size() < maxCount)
+		{
+			int nextInterval = interval;
+			double nextLength = length;
+			double param = 0.0;
+			XYZ point;
+			if (!FindChordPoint(table, start, interval, length, chordLength, tolerance, nextInterval, nextLength, param, point) ||
+				nextLength >= totalLength - tolerance)
+			{
+				break;
+			}
+			params.emplace_back(param);
+			start = point;
+			interval = nextInterval;
+			length = nextLength;
 		}
-		else if (MathUtils::IsLessThan(length, givenLength, Constants::DistanceEpsilon))
+		return start.Distance(end);
+	}
+
+	const int MaxBVHSubdivisionDepth = 10;
+
+	/// <summary>
+	/// Deviation of a flat piece's control polygon from its chord, relative to the chord length.
+	/// </summary>
+	const double BVHFlatness = 0.05;
+
+	/// <summary>
+	/// A Bezier piece is flat when its control polygon stays close to the chord and advances along it monotonically,
+	/// so the distance to any point has a single minimum over the piece for Newton to find.
+	/// </summary>
+	bool IsFlatBezier(const std::vector<XYZW>& controlPoints)
+	{
+		return ControlPointsUtils::IsFlatPolygon(ControlPointsUtils::ToXYZ(controlPoints), BVHFlatness);
+	}
+
+	/// <summary>
+	/// Halves a Bezier piece of [start, end] by de Casteljau until it is flat, appending the pieces and their parameter ranges.
+	/// </summary>
+	void SubdivideToBVHLeaves(const std::vector<XYZW>& controlPoints, double start, double end, int depth, std::vector<std::vector<XYZW>>& leaves, std::vector<double>& leafParams)
+	{
+		if (depth >= MaxBVHSubdivisionDepth || IsFlatBezier(controlPoints))
 		{
-			end = middle;
-			GetParamByLength(curve, start, end, givenLength, type);
+			leaves.emplace_back(controlPoints);
+			leafParams.emplace_back(start);
+			leafParams.emplace_back(end);
+			return;
 		}
-		return middle;
+
+		int size = controlPoints.size();
+		std::vector<XYZW> temp = controlPoints;
+		std::vector<XYZW> left(size);
+		std::vector<XYZW> right(size);
+		for (int k = 0; k < size; k++)
+		{
+			left[k] = temp[0];
+			right[size - 1 - k] = temp[size - 1 - k];
+			for (int i = 0; i < size - 1 - k; i++)
+			{
+				temp[i] = 0.5 * temp[i];
+				temp[i] += 0.5 * temp[i + 1];
+			}
+		}
+		double middle = (start + end) / 2.0;
+		SubdivideToBVHLeaves(left, start, middle, depth + 1, leaves, leafParams);
+		SubdivideToBVHLeaves(right, middle, end, depth + 1, leaves, leafParams);
 	}
+
+	/// <summary>
+	/// Builds the nodes over leaves [begin, end) by halving the range; leaves follow the curve, so neighbours in the range are close in space.
+	/// </summary>
+	int BuildCurveBVHNodes(const std::vector<LN_NurbsCurve>& leaves, int begin, int end, std::vector<LN_BVHNode>& nodes)
+	{
+		int index = nodes.size();
+		nodes.emplace_back(LN_BVHNode());
+		if (end - begin == 1)
+		{
+			const std::vector<XYZW>& controlPoints = leaves[begin].ControlPoints;
+			XYZ min = controlPoints[0].ToXYZ(true);
+			XYZ max = min;
+			for (int i = 1; i < controlPoints.size(); i++)
+			{
+				XYZ point = controlPoints[i].ToXYZ(true);
+				for (int k = 0; k < 3; k++)
+				{
+					min[k] = std::min(min[k], point[k]);
+					max[k] = std::max(max[k], point[k]);
+				}
+			}
+			nodes[index].Min = min;
+			nodes[index].Max = max;
+			nodes[index].Leaf = begin;
+			return index;
+		}
+
+		int middle = (begin + end) / 2;
+		int left = BuildCurveBVHNodes(leaves, begin, middle, nodes);
+		int right = BuildCurveBVHNodes(leaves, middle, end, nodes);
+		LN_BVHNode& node = nodes[index];
+		node.Left = left;
+		node.Right = right;
+		for (int k = 0; k < 3; k++)
+		{
+			node.Min[k] = std::min(nodes[left].Min[k], nodes[right].Min[k]);
+			node.Max[k] = std::max(nodes[left].Max[k], nodes[right].Max[k]);
+		}
+		return index;
+	}
+
+	/// <summary>
+	/// Newton iterations on f(s) = C'(s) . (C(s) - P) over a flat Bezier piece, from seed or, when seed is negative, from the projection of P onto its chord.
+	/// Returns the parameter on [0, 1] and the distance of its point to P.
+	/// </summary>
+	double ProjectOnBezierLeaf(const LN_CheckedNurbsCurve& checkedLeaf, const XYZ& point, double seed, double& distance)
+	{
+		const LN_ArrayView<XYZW>& controlPoints = checkedLeaf.GetCurve().ControlPoints;
+		XYZ start = controlPoints[0].ToXYZ(checkedLeaf.IsRational());
+		XYZ end = controlPoints[controlPoints.size() - 1].ToXYZ(checkedLeaf.IsRational());
+		XYZ chord = end - start;
+		double squareLength = chord.DotProduct(chord);
+		double paramS = seed;
+		if (paramS < 0.0)
+		{
+			paramS = squareLength == 0.0 ? 0.5 : std::min(std::max((point - start).DotProduct(chord) / squareLength, 0.0), 1.0);
+		}
+
+		const int maxIterations = 20;
+		for (int i = 0; i < maxIterations; i++)
+		{
+			std::vector<XYZ> derivatives = NurbsCurve::ComputeRationalCurveDerivatives(checkedLeaf, 2, paramS);
+			XYZ difference = derivatives[0] - point;
+			double f = derivatives[1].DotProduct(difference);
+			double speed = derivatives[1].DotProduct(derivatives[1]);
+			double df = derivatives[2].DotProduct(difference) + speed;
+			if (df <= 0.0)
+			{
+				df = speed;
+			}
+			// df scales with the square of the curve size, so it is only negligible relative to |C'|^2.
+			if (abs(df) <= Constants::DoubleEpsilon * speed || speed == 0.0)
+			{
+				break;
+			}
+			double next = std::min(std::max(paramS - f / df, 0.0), 1.0);
+			bool isConverged = abs(next - paramS) < Constants::DoubleEpsilon;
+			paramS = next;
+			if (isConverged)
+			{
+				break;
+			}
+		}
+
+		distance = NurbsCurve::GetPointOnCurve(checkedLeaf, paramS).Distance(point);
+		if (start.Distance(point) < distance)
+		{
+			distance = start.Distance(point);
+			paramS = 0.0;
+		}
+		if (end.Distance(point) < distance)
+		{
+			distance = end.Distance(point);
+			paramS = 1.0;
+		}
+		return paramS;
+	}
+
+	/// <summary>
+	/// Closest point query on a curve BVH. leaf and paramS carry the piece and local parameter of a previous answer in and the new answer out;
+	/// with leaf >= 0 that piece is projected first, so a nearby previous point bounds the search from the start.
+	/// </summary>
+	double QueryCurveBVH(const LN_CurveBVH& bvh, const XYZ& point, int& leaf, double& paramS)
+	{
+		double minDistance = Constants::MaxDistance;
+		if (leaf >= 0)
+		{
+			paramS = ProjectOnBezierLeaf(bvh.CheckedLeaves[leaf], point, paramS, minDistance);
+		}
+
+		// Nearest box first; once the nearest remaining box is farther than the best point found, no piece inside can be closer.
+		typedef std::pair<double, int> Candidate;
+		std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+		candidates.push(Candidate(Projection::DistanceToBox(bvh.Nodes[0].Min, bvh.Nodes[0].Max, point), 0));
+		int warmLeaf = leaf;
+		while (!candidates.empty() && candidates.top().first < minDistance)
+		{
+			const LN_BVHNode& node = bvh.Nodes[candidates.top().second];
+			candidates.pop();
+			if (node.Leaf >= 0)
+			{
+				if (node.Leaf == warmLeaf)
+				{
+					continue;
+				}
+				double distance = 0.0;
+				double candidateS = ProjectOnBezierLeaf(bvh.CheckedLeaves[node.Leaf], point, -1.0, distance);
+				if (distance < minDistance)
+				{
+					minDistance = distance;
+					leaf = node.Leaf;
+					paramS = candidateS;
+				}
+				continue;
+			}
+			candidates.push(Candidate(Projection::DistanceToBox(bvh.Nodes[node.Left].Min, bvh.Nodes[node.Left].Max, point), node.Left));
+			candidates.push(Candidate(Projection::DistanceToBox(bvh.Nodes[node.Right].Min, bvh.Nodes[node.Right].Max, point), node.Right));
+		}
+		return minDistance;
+	}
+
+	/// <summary>
+	/// Points per batch projection block. Fixed, so the warm starts and hence the results do not depend on the thread count.
+	/// </summary>
+	const int ProjectionBlockSize = 256;
 }
 
-void LNLib::NurbsCurve::Check(const LN_NurbsCurve& curve)
+LNLib::LN_CheckedNurbsCurve LNLib::NurbsCurve::Check(const LN_NurbsCurve& curve)
 {
 	int degree = curve.Degree;
-	std::vector<double> knotVector = curve.KnotVector;
-	std::vector<XYZW> controlPoints = curve.ControlPoints;
+	const std::vector<double>& knotVector = curve.KnotVector;
+	const std::vector<XYZW>& controlPoints = curve.ControlPoints;
 
 	VALIDATE_ARGUMENT(degree > 0, "degree", "Degree must greater than zero.");
 	VALIDATE_ARGUMENT(knotVector.size() > 0, "knotVector", "KnotVector size must greater than zero.");
 	VALIDATE_ARGUMENT(ValidationUtils::IsValidKnotVector(knotVector), "knotVector", "KnotVector must be a nondecreasing sequence of real numbers.");
 	VALIDATE_ARGUMENT(controlPoints.size() > 0, "controlPoints", "ControlPoints must contains one point at least.");
 	VALIDATE_ARGUMENT(ValidationUtils::IsValidNurbs(degree, knotVector.size(), controlPoints.size()), "controlPoints", "Arguments must fit: m = n + p + 1");
+
+	return LN_CheckedNurbsCurve(curve, ControlPointsUtils::IsRational(controlPoints));
 }
 
 
 LNLib::XYZ LNLib::NurbsCurve::GetPointOnCurve(const LN_NurbsCurve& curve, double paramT)
 {
-	int degree = curve.Degree;
-	std::vector<double> knotVector = curve.KnotVector;
-	std::vector<XYZW> controlPoints = curve.ControlPoints;
+	const std::vector<double>& knotVector = curve.KnotVector;
 
 	VALIDATE_ARGUMENT_RANGE(paramT, knotVector[0], knotVector[knotVector.size() - 1]);
 
-	LN_BsplineCurve<XYZW> bsplineCurve;
-	bsplineCurve.Degree = degree;
-	bsplineCurve.KnotVector = knotVector;
-	bsplineCurve.ControlPoints = controlPoints;
+	LN_BsplineCurveView<XYZW> bsplineCurve(curve);
 
 	XYZW weightPoint = BsplineCurve::GetPointOnCurve(bsplineCurve, paramT);
 	return weightPoint.ToXYZ(true);
 }
 
+LNLib::XYZ LNLib::NurbsCurve::GetPointOnCurve(const LN_CheckedNurbsCurve& curve, double paramT)
+{
+	const LN_ArrayView<double>& knotVector = curve.GetCurve().KnotVector;
+
+	VALIDATE_ARGUMENT_RANGE(paramT, knotVector[0], knotVector[knotVector.size() - 1]);
+
+	XYZW weightPoint = BsplineCurve::GetPointOnCurveUnchecked(curve.GetCurve(), paramT);
+	return weightPoint.ToXYZ(curve.IsRational());
+}
+
 std::vector<LNLib::XYZ> LNLib::NurbsCurve::ComputeRationalCurveDerivatives(const LN_NurbsCurve& curve, int derivative, double paramT)
 {
-	int degree = curve.Degree;
-	std::vector<double> knotVector = curve.KnotVector;
-	std::vector<XYZW> controlPoints = curve.ControlPoints;
+	const std::vector<double>& knotVector = curve.KnotVector;
 
 	VALIDATE_ARGUMENT(derivative > 0, "derivative", "derivative must greater than zero.");	
 	VALIDATE_ARGUMENT_RANGE(paramT, knotVector[0], knotVector[knotVector.size() - 1]);
 
-	std::vector<LNLib::XYZ> derivatives(derivative + 1);
-
-	LN_BsplineCurve<XYZW> bsplineCurve;
-	bsplineCurve.Degree = degree;
-	bsplineCurve.KnotVector = knotVector;
-	bsplineCurve.ControlPoints = controlPoints;
+	LN_BsplineCurveView<XYZW> bsplineCurve(curve);
 
 	std::vector<XYZW> ders = BsplineCurve::ComputeDerivatives(bsplineCurve, derivative, paramT);
+	return ComputeRationalDerivatives(ders.data(), derivative);
+}
 
-	std::vector<XYZ> Aders(derivative + 1);
-	for (int i = 0; i < ders.size(); i++)
+std::vector<LNLib::XYZ> LNLib::NurbsCurve::ComputeRationalCurveDerivatives(const LN_CheckedNurbsCurve& curve, int derivative, double paramT)
+{
+	const LN_ArrayView<double>& knotVector = curve.GetCurve().KnotVector;
+
+	VALIDATE_ARGUMENT(derivative > 0, "derivative", "derivative must greater than zero.");
+	VALIDATE_ARGUMENT_RANGE(paramT, knotVector[0], knotVector[knotVector.size() - 1]);
+
+	std::vector<XYZW> ders = BsplineCurve::ComputeDerivativesUnchecked(curve.GetCurve(), derivative, paramT);
+	std::vector<XYZ> derivatives(derivative + 1);
+	ComputeCheckedCurveDerivatives(curve, ders.data(), derivative, derivatives.data());
+	return derivatives;
+}
+
+void LNLib::NurbsCurve::GetPointsOnCurve(const LN_NurbsCurve& curve, const std::vector<double>& paramTs, std::vector<XYZ>& points)
+{
+	GetPointsOnCurve(Check(curve), paramTs, points);
+}
+
+void LNLib::NurbsCurve::GetPointsOnCurve(const LN_CheckedNurbsCurve& curve, const std::vector<double>& paramTs, std::vector<XYZ>& points)
+{
+	const LN_ArrayView<double>& knotVector = curve.GetCurve().KnotVector;
+	for (int i = 0; i < paramTs.size(); i++)
 	{
-		Aders[i] = ders[i].ToXYZ(false);
+		VALIDATE_ARGUMENT_RANGE(paramTs[i], knotVector[0], knotVector[knotVector.size() - 1]);
 	}
-	std::vector<double> wders(derivative + 1);
-	for (int i = 0; i < ders.size(); i++)
+
+	std::vector<XYZW> weightPoints(paramTs.size());
+	BsplineCurve::GetPointsOnCurveUnchecked(curve.GetCurve(), LN_ArrayView<double>(paramTs), weightPoints.data());
+
+	points.resize(paramTs.size());
+	for (int i = 0; i < paramTs.size(); i++)
 	{
-		wders[i] = ders[i].GetW();
+		points[i] = weightPoints[i].ToXYZ(curve.IsRational());
 	}
+}
 
-	for (int k = 0; k <= derivative; k++)
+void LNLib::NurbsCurve::ComputeRationalCurveDerivatives(const LN_NurbsCurve& curve, int derivative, const std::vector<double>& paramTs, std::vector<std::vector<XYZ>>& derivatives)
+{
+	ComputeRationalCurveDerivatives(Check(curve), derivative, paramTs, derivatives);
+}
+
+void LNLib::NurbsCurve::ComputeRationalCurveDerivatives(const LN_CheckedNurbsCurve& curve, int derivative, const std::vector<double>& paramTs, std::vector<std::vector<XYZ>>& derivatives)
+{
+	const LN_ArrayView<double>& knotVector = curve.GetCurve().KnotVector;
+
+	VALIDATE_ARGUMENT(derivative > 0, "derivative", "derivative must greater than zero.");
+	for (int i = 0; i < paramTs.size(); i++)
 	{
-		XYZ v = Aders[k];
-		for (int i = 1; i <= k; i++)
-		{
-			v = v - MathUtils::Binomial(k, i) * wders[i] * derivatives[k - i];
-		}
-		derivatives[k] = v / wders[0];
+		VALIDATE_ARGUMENT_RANGE(paramTs[i], knotVector[0], knotVector[knotVector.size() - 1]);
+	}
+
+	std::vector<XYZW> ders(paramTs.size() * (derivative + 1));
+	BsplineCurve::ComputeDerivativesUnchecked(curve.GetCurve(), derivative, LN_ArrayView<double>(paramTs), ders.data());
+
+	derivatives.resize(paramTs.size());
+	for (int i = 0; i < paramTs.size(); i++)
+	{
+		derivatives[i].resize(derivative + 1);
+		ComputeCheckedCurveDerivatives(curve, ders.data() + i * (derivative + 1), derivative, derivatives[i].data());
 	}
-	return derivatives;
 }
 
-double LNLib::NurbsCurve::Curvature(const LN_NurbsCurve& curve, double paramT)
+void LNLib::NurbsCurve::ComputeRationalCurveDerivatives(const LN_NurbsCurve& curve, int derivative, const std::vector<double>& paramTs, std::vector<XYZ>& derivatives)
 {
-	int degree = curve.Degree;
-	std::vector<double> knotVector = curve.KnotVector;
-	std::vector<XYZW> controlPoints = curve.ControlPoints;
+	ComputeRationalCurveDerivatives(Check(curve), derivative, paramTs, derivatives);
+}
 
-	VALIDATE_ARGUMENT_RANGE(paramT, knotVector[0], knotVector[knotVector.size() - 1]);
-	
-	std::vector<XYZ> derivatives = ComputeRationalCurveDerivatives(curve, 2, paramT);
-	XYZ d1 = derivatives[1];
-	XYZ d2 = derivatives[2];
-	if (MathUtils::IsAlmostEqualTo(d1.Length(), 1.0))
+void LNLib::NurbsCurve::ComputeRationalCurveDerivatives(const LN_CheckedNurbsCurve& curve, int derivative, const std::vector<double>& paramTs, std::vector<XYZ>& derivatives)
+{
+	const LN_ArrayView<double>& knotVector = curve.GetCurve().KnotVector;
+
+	VALIDATE_ARGUMENT(derivative > 0, "derivative", "derivative must greater than zero.");
+	VALIDATE_ARGUMENT(derivative <= MathUtils::MaxBinomialNumber, "derivative", "derivative must not greater than MaxBinomialNumber.");
+	for (int i = 0; i < paramTs.size(); i++)
+	{
+		VALIDATE_ARGUMENT_RANGE(paramTs[i], knotVector[0], knotVector[knotVector.size() - 1]);
+	}
+
+	int stride = derivative + 1;
+	std::vector<XYZW> ders(paramTs.size() * stride);
+	BsplineCurve::ComputeDerivativesUnchecked(curve.GetCurve(), derivative, LN_ArrayView<double>(paramTs), ders.data());
+
+	derivatives.resize(paramTs.size() * stride);
+	for (int i = 0; i < paramTs.size(); i++)
 	{
-		return d2.Length();
+		ComputeCheckedCurveDerivatives(curve, ders.data() + i * stride, derivative, derivatives.data() + i * stride);
 	}
-	double numerator = d1.CrossProduct(d2).Length();
-	double denominator = pow(d1.Length(), 3);
-	return numerator / denominator;
 }
 
-LNLib::XYZ LNLib::NurbsCurve::Normal(const LN_NurbsCurve& curve, CurveNormal normalType, double paramT)
+LNLib::LN_CompiledNurbsCurve LNLib::NurbsCurve::Compile(const LN_NurbsCurve& curve)
 {
-	int degree = curve.Degree;
-	std::vector<double> knotVector = curve.KnotVector;
-	std::vector<XYZW> controlPoints = curve.ControlPoints;
+	Check(curve);
 
-	VALIDATE_ARGUMENT_RANGE(paramT, knotVector[0], knotVector[knotVector.size() - 1]);
+	LN_CompiledNurbsCurve compiled;
+	compiled.m_degree = curve.Degree;
+	compiled.m_knotVector = curve.KnotVector;
 
-	std::vector<XYZ> derivatives = ComputeRationalCurveDerivatives(curve, 1, paramT);
-	XYZ tangent = derivatives[1];
-	XYZ der2 = derivatives[2];
-	if (MathUtils::IsAlmostEqualTo(tangent.Length(), 1.0))
+	int size = curve.ControlPoints.size();
+	compiled.m_x.resize(size);
+	compiled.m_y.resize(size);
+	compiled.m_z.resize(size);
+	compiled.m_w.resize(size);
+	for (int i = 0; i < size; i++)
 	{
-		XYZ curveNormal = der2 / der2.Length();
-		if (normalType == CurveNormal::Normal)
-		{
-			return curveNormal;
-		}
-		else
-		{
-			return tangent.CrossProduct(curveNormal);
-		}
+		const XYZW& point = curve.ControlPoints[i];
+		compiled.m_x[i] = point.GetWX();
+		compiled.m_y[i] = point.GetWY();
+		compiled.m_z[i] = point.GetWZ();
+		compiled.m_w[i] = point.GetW();
 	}
-	else
+	return compiled;
+}
+
+void LNLib::NurbsCurve::GetPointsOnCurve(const LN_CompiledNurbsCurve& curve, const std::vector<double>& paramTs, std::vector<XYZ>& points)
+{
+	const std::vector<double>& knotVector = curve.GetKnotVector();
+	for (int i = 0; i < paramTs.size(); i++)
 	{
-		XYZ b = tangent.CrossProduct(der2) / (tangent.CrossProduct(der2).Length());
-		if (normalType == CurveNormal::Binormal)
+		VALIDATE_ARGUMENT_RANGE(paramTs[i], knotVector[0], knotVector[knotVector.size() - 1]);
+	}
+
+	points.resize(paramTs.size());
+	SimdKernels::GetPointsOnCurve(curve, paramTs.data(), paramTs.size(), points.data());
+}
+
+LNLib::LN_PowerBasisCurve LNLib::NurbsCurve::ToPowerBasis(const LN_NurbsCurve& curve)
+{
+	Check(curve);
+
+	int degree = curve.Degree;
+	std::vector<LN_NurbsCurve> beziers = DecomposeToBeziers(curve);
+	std::vector<std::vector<double>> matrix = Polynomials::BezierToPowerMatrix(degree);
+
+	LN_PowerBasisCurve powerBasis;
+	powerBasis.Degree = degree;
+	powerBasis.Knots = KnotVectorUtils::GetBreakpoints(degree, curve.KnotVector);
+	powerBasis.Coefficients.resize(beziers.size(), std::vector<XYZW>(degree + 1));
+	for (int s = 0; s < beziers.size(); s++)
+	{
+		const std::vector<XYZW>& bezierPoints = beziers[s].ControlPoints;
+		for (int i = 0; i <= degree; i++)
 		{
-			return b;
+			XYZW coefficient;
+			for (int j = 0; j <= i; j++)
+			{
+				coefficient += matrix[i][j] * bezierPoints[j];
+			}
+			powerBasis.Coefficients[s][i] = coefficient;
 		}
-		else
+	}
+	return powerBasis;
+}
+
+LNLib::XYZ LNLib::NurbsCurve::GetPointOnCurve(const LN_PowerBasisCurve& curve, double paramT)
+{
+	const std::vector<double>& knots = curve.Knots;
+	VALIDATE_ARGUMENT_RANGE(paramT, knots[0], knots[knots.size() - 1]);
+
+	int spanIndex = Polynomials::GetKnotSpanIndexUnchecked(0, LN_ArrayView<double>(knots), paramT);
+	double s = (paramT - knots[spanIndex]) / (knots[spanIndex + 1] - knots[spanIndex]);
+	XYZW point = Polynomials::HornerUnchecked(curve.Degree, curve.Coefficients[spanIndex].data(), s);
+	return point.ToXYZ(true);
+}
+
+std::vector<LNLib::XYZ> LNLib::NurbsCurve::ComputeRationalCurveDerivatives(const LN_PowerBasisCurve& curve, int derivative, double paramT)
+{
+	const std::vector<double>& knots = curve.Knots;
+	VALIDATE_ARGUMENT(derivative > 0, "derivative", "derivative must greater than zero.");
+	VALIDATE_ARGUMENT_RANGE(paramT, knots[0], knots[knots.size() - 1]);
+
+	int spanIndex = Polynomials::GetKnotSpanIndexUnchecked(0, LN_ArrayView<double>(knots), paramT);
+	double length = knots[spanIndex + 1] - knots[spanIndex];
+	double s = (paramT - knots[spanIndex]) / length;
+	const XYZW* coefficients = curve.Coefficients[spanIndex].data();
+
+	std::vector<XYZW> ders(derivative + 1);
+	double scale = 1.0;
+	for (int k = 0; k <= derivative; k++)
+	{
+		ders[k] = scale * Polynomials::HornerDerivativeUnchecked(curve.Degree, k, coefficients, s);
+		scale /= length;
+	}
+	return ComputeRationalDerivatives(ders.data(), derivative);
+}
+
+LNLib::LN_PowerBasisCurve LNLib::NurbsCurve::Differentiate(const LN_PowerBasisCurve& curve)
+{
+	int degree = curve.Degree;
+	VALIDATE_ARGUMENT(degree > 0, "degree", "Degree must greater than zero.");
+
+	const std::vector<double>& knots = curve.Knots;
+	LN_PowerBasisCurve derivative;
+	derivative.Degree = degree - 1;
+	derivative.Knots = knots;
+	derivative.Coefficients.resize(curve.Coefficients.size(), std::vector<XYZW>(degree));
+	for (int s = 0; s < curve.Coefficients.size(); s++)
+	{
+		double inverseLength = 1.0 / (knots[s + 1] - knots[s]);
+		for (int i = 0; i < degree; i++)
 		{
-			return b.Normalize().CrossProduct(tangent.Normalize());
+			derivative.Coefficients[s][i] = ((i + 1) * inverseLength) * curve.Coefficients[s][i + 1];
 		}
 	}
+	return derivative;
+}
+
+double LNLib::NurbsCurve::Curvature(const LN_NurbsCurve& curve, double paramT)
+{
+	const std::vector<double>& knotVector = curve.KnotVector;
+
+	VALIDATE_ARGUMENT_RANGE(paramT, knotVector[0], knotVector[knotVector.size() - 1]);
+	
+	std::vector<XYZ> derivatives = ComputeRationalCurveDerivatives(curve, 2, paramT);
+	return CurvatureFromDerivatives(derivatives);
+}
+
+double LNLib::NurbsCurve::Curvature(const LN_CheckedNurbsCurve& curve, double paramT)
+{
+	std::vector<XYZ> derivatives = ComputeRationalCurveDerivatives(curve, 2, paramT);
+	return CurvatureFromDerivatives(derivatives);
+}
+
+LNLib::XYZ LNLib::NurbsCurve::Normal(const LN_NurbsCurve& curve, CurveNormal normalType, double paramT)
+{
+	const std::vector<double>& knotVector = curve.KnotVector;
+
+	VALIDATE_ARGUMENT_RANGE(paramT, knotVector[0], knotVector[knotVector.size() - 1]);
+
+	std::vector<XYZ> derivatives = ComputeRationalCurveDerivatives(curve, 2, paramT);
+	return NormalFromDerivatives(derivatives, normalType);
+}
+
+LNLib::XYZ LNLib::NurbsCurve::Normal(const LN_CheckedNurbsCurve& curve, CurveNormal normalType, double paramT)
+{
+	std::vector<XYZ> derivatives = ComputeRationalCurveDerivatives(curve, 2, paramT);
+	return NormalFromDerivatives(derivatives, normalType);
 }
 
 
 double LNLib::NurbsCurve::Torsion(const LN_NurbsCurve& curve, double paramT)
 {
-	int degree = curve.Degree;
-	std::vector<double> knotVector = curve.KnotVector;
-	std::vector<XYZW> controlPoints = curve.ControlPoints;
+	const std::vector<double>& knotVector = curve.KnotVector;
 
 	VALIDATE_ARGUMENT_RANGE(paramT, knotVector[0], knotVector[knotVector.size() - 1]);
 
@@ -513,20 +1190,21 @@ std::vector<LNLib::LN_NurbsCurve> LNLib::NurbsCurve::DecomposeToBeziers(const LN
 					beziers[nb + 1].ControlPoints[save] = beziers[nb].ControlPoints[degree];
 				}
 			}
+		}
 
-			nb++;
-			if (b < m)
+		nb++;
+		if (b < m)
+		{
+			for (int i = degree - multi; i <= degree; i++)
 			{
-				for (int i = degree - multi; i <= degree; i++)
-				{
-					beziers[nb].ControlPoints[i] = controlPoints[b - degree + i];
-				}
-
-				a = b;
-				b += 1;
+				beziers[nb].ControlPoints[i] = controlPoints[b - degree + i];
 			}
+
+			a = b;
+			b += 1;
 		}
 	}
+	beziers.resize(nb);
 	return beziers;
 }
 
@@ -955,14 +1633,22 @@ bool LNLib::NurbsCurve::ReduceDegree(const LN_NurbsCurve& curve, LN_NurbsCurve&
 
 void LNLib::NurbsCurve::EquallyTessellate(const LN_NurbsCurve& curve, std::vector<XYZ>& tessellatedPoints, std::vector<double>& correspondingKnots)
 {
-	int degree = curve.Degree;
-	std::vector<double> knotVector = curve.KnotVector;
-	std::vector<XYZW> controlPoints = curve.ControlPoints;
+	CurvePointsCollector collector(tessellatedPoints, correspondingKnots);
+	EquallyTessellate(curve, collector);
+}
+
+void LNLib::NurbsCurve::EquallyTessellate(const LN_NurbsCurve& curve, CurveTessellationSink& sink)
+{
+	const std::vector<double>& knotVector = curve.KnotVector;
+	const std::vector<XYZW>& controlPoints = curve.ControlPoints;
+	LN_CheckedNurbsCurve checkedCurve = Check(curve);
 
 	std::vector<double> uniqueKv = knotVector;
 	uniqueKv.erase(unique(uniqueKv.begin(), uniqueKv.end()), uniqueKv.end());
 	int size = uniqueKv.size();
 	int intervals = 100;
+	std::vector<double> params(intervals);
+	std::vector<XYZ> points;
 	for (int i = 0; i < size - 1; i++)
 	{
 		double currentU = uniqueKv[i];
@@ -970,13 +1656,67 @@ void LNLib::NurbsCurve::EquallyTessellate(const LN_NurbsCurve& curve, std::vecto
 		double step = (nextU - currentU) / intervals;
 		for (int j = 0; j < intervals; j++)
 		{
-			double u = currentU + step * j;
-			correspondingKnots.emplace_back(u);
-			tessellatedPoints.emplace_back(GetPointOnCurve(curve, u));
+			params[j] = currentU + step * j;
+		}
+		GetPointsOnCurve(checkedCurve, params, points);
+		sink.AddPoints(points.data(), params.data(), intervals);
+	}
+
+	double lastKnot = knotVector[knotVector.size() - 1];
+	XYZ lastPoint = controlPoints[controlPoints.size() - 1].ToXYZ(true);
+	sink.AddPoints(&lastPoint, &lastKnot, 1);
+}
+
+void LNLib::NurbsCurve::AdaptiveTessellate(const LN_NurbsCurve& curve, const LN_TessellationTolerance& tolerance, std::vector<XYZ>& tessellatedPoints, std::vector<double>& correspondingKnots)
+{
+	tessellatedPoints.clear();
+	correspondingKnots.clear();
+	CurvePointsCollector collector(tessellatedPoints, correspondingKnots);
+	AdaptiveTessellate(curve, tolerance, collector);
+}
+
+void LNLib::NurbsCurve::AdaptiveTessellate(const LN_NurbsCurve& curve, const LN_TessellationTolerance& tolerance, CurveTessellationSink& sink)
+{
+	VALIDATE_ARGUMENT(tolerance.ChordHeight > 0.0, "tolerance", "ChordHeight must greater than zero.");
+	VALIDATE_ARGUMENT(tolerance.AngleTolerance > 0.0, "tolerance", "AngleTolerance must greater than zero.");
+	VALIDATE_ARGUMENT(tolerance.MaxEdgeLength >= 0.0, "tolerance", "MaxEdgeLength must greater than or equals zero.");
+
+	Check(curve);
+
+	// Each Bezier segment is evaluated on its own, so the tangents at its ends are one-sided even at kinks.
+	// Segments are parameterized over [0, 1] and mapped back onto their knot spans.
+	std::vector<double> breakpoints = KnotVectorUtils::GetBreakpoints(curve.Degree, curve.KnotVector);
+	std::vector<LN_NurbsCurve> bezierCurves = DecomposeToBeziers(curve);
+	VALIDATE_ARGUMENT(bezierCurves.size() == breakpoints.size() - 1, "curve", "KnotVector must not contain almost equal distinct knots.");
+
+	std::vector<XYZ> points;
+	std::vector<double> params;
+	for (int i = 0; i < bezierCurves.size(); i++)
+	{
+		LN_CheckedNurbsCurve bezierCurve = Check(bezierCurves[i]);
+
+		std::vector<XYZ> start = ComputeRationalCurveDerivatives(bezierCurve, 1, 0.0);
+		std::vector<XYZ> middle = ComputeRationalCurveDerivatives(bezierCurve, 1, 0.5);
+		std::vector<XYZ> end = ComputeRationalCurveDerivatives(bezierCurve, 1, 1.0);
+
+		points.clear();
+		params.clear();
+		if (i == 0)
+		{
+			points.emplace_back(start[0]);
+			params.emplace_back(0.0);
+		}
+		TessellateCurveSegment(bezierCurve, tolerance, 0.0, start, middle, 1.0, end, 0, points, params);
+
+		double a = breakpoints[i];
+		double b = breakpoints[i + 1];
+		for (int j = 0; j < params.size(); j++)
+		{
+			params[j] = a + params[j] * (b - a);
 		}
+		params[params.size() - 1] = b;
+		sink.AddPoints(points.data(), params.data(), points.size());
 	}
-	correspondingKnots.emplace_back(knotVector[knotVector.size() - 1]);
-	tessellatedPoints.emplace_back(const_cast<XYZW&>(controlPoints[controlPoints.size() - 1]).ToXYZ(true));
 }
 
 bool LNLib::NurbsCurve::IsClosed(const LN_NurbsCurve& curve)
@@ -1025,115 +1765,73 @@ bool LNLib::NurbsCurve::IsClosed(const LN_NurbsCurve& curve)
 
 double LNLib::NurbsCurve::GetParamOnCurve(const LN_NurbsCurve& curve, const XYZ& givenPoint)
 {
-	int degree = curve.Degree;
-	std::vector<double> knotVector = curve.KnotVector;
-	std::vector<XYZW> controlPoints = curve.ControlPoints;
-
-	double minValue = Constants::MaxDistance;
+	return GetParamOnCurve(BuildBVH(curve), givenPoint);
+}
 
-	int maxIterations = 10;
-	double paramT = Constants::DoubleEpsilon;
-	double minParam = knotVector[0];
-	double maxParam = knotVector[knotVector.size() - 1];
+LNLib::LN_CurveBVH LNLib::NurbsCurve::BuildBVH(const LN_NurbsCurve& curve)
+{
+	Check(curve);
+	std::vector<double> breakpoints = KnotVectorUtils::GetBreakpoints(curve.Degree, curve.KnotVector);
+	std::vector<LN_NurbsCurve> segments = DecomposeToBeziers(curve);
+	VALIDATE_ARGUMENT(segments.size() == breakpoints.size() - 1, "curve", "KnotVector must not contain almost equal distinct knots.");
 
-	std::vector<XYZ> tessellatedPoints;
-	std::vector<double> correspondingKnots;
-	EquallyTessellate(curve, tessellatedPoints, correspondingKnots);
-	for (int i = 0; i < tessellatedPoints.size() - 1; i++)
+	LN_CurveBVH bvh;
+	std::vector<std::vector<XYZW>> leaves;
+	for (int i = 0; i < segments.size(); i++)
 	{
-		double currentU = correspondingKnots[i];
-		double nextU = correspondingKnots[i + 1];
-
-		XYZ currentPoint = tessellatedPoints[i];
-		XYZ nextPoint = tessellatedPoints[i + 1];
-
-		XYZ vector1 = currentPoint - givenPoint;
-		XYZ vector2 = nextPoint - currentPoint;
-		double dot = vector1.DotProduct(vector2);
-
-		XYZ projectPoint;
-		double projectU;
-
-		if (dot < 0)
-		{
-			projectPoint = currentPoint;
-			projectU = currentU;
-		}
-		else if (dot > 1)
-		{
-			projectPoint = nextPoint;
-			projectU = nextU;
-		}
-		else
-		{
-			projectPoint = currentPoint + dot * vector1.Normalize();
-			projectU = currentU + (nextU - currentU) * dot;
-		}
-
-		double distance = (givenPoint - projectPoint).Length();
-		if (distance < minValue)
-		{
-			minValue = distance;
-			paramT = projectU;
-		}
+		SubdivideToBVHLeaves(segments[i].ControlPoints, breakpoints[i], breakpoints[i + 1], 0, leaves, bvh.LeafParams);
 	}
+	bvh.Leaves.resize(leaves.size());
+	for (int i = 0; i < leaves.size(); i++)
+	{
+		bvh.Leaves[i].Degree = curve.Degree;
+		bvh.Leaves[i].KnotVector = segments[0].KnotVector;
+		bvh.Leaves[i].ControlPoints = leaves[i];
+	}
+	BuildCurveBVHNodes(bvh.Leaves, 0, bvh.Leaves.size(), bvh.Nodes);
 
-	bool isClosed = IsClosed(curve);
-	double a = minParam;
-	double b = maxParam;
-
-	int counters = 0;
-	while (counters < maxIterations)
+	// The leaves are final once the nodes are built; checking them here saves every query from validating them again.
+	for (int i = 0; i < bvh.Leaves.size(); i++)
 	{
-		std::vector<XYZ> derivatives = ComputeRationalCurveDerivatives(curve, 2, paramT);
-		XYZ difference = derivatives[0] - givenPoint;
-		double f = derivatives[1].DotProduct(difference);
+		bvh.CheckedLeaves.emplace_back(Check(bvh.Leaves[i]));
+	}
+	return bvh;
+}
 
-		double condition1 = difference.Length();
-		double condition2 = std::abs(f / (derivatives[1].Length() * condition1));
+double LNLib::NurbsCurve::GetParamOnCurve(const LN_CurveBVH& bvh, const XYZ& givenPoint)
+{
+	VALIDATE_ARGUMENT(bvh.Nodes.size() > 0, "bvh", "BVH must be built by BuildBVH.");
 
-		if (condition1 < Constants::DistanceEpsilon &&
-			condition2 < Constants::DistanceEpsilon)
-		{
-			return paramT;
-		}
+	int leaf = -1;
+	double paramS = 0.0;
+	QueryCurveBVH(bvh, givenPoint, leaf, paramS);
+	return bvh.LeafParams[2 * leaf] + paramS * (bvh.LeafParams[2 * leaf + 1] - bvh.LeafParams[2 * leaf]);
+}
 
-		double df = derivatives[2].DotProduct(difference) + derivatives[1] * derivatives[1];
-		double temp = paramT - f / df;
+void LNLib::NurbsCurve::GetParamsOnCurve(const LN_NurbsCurve& curve, const std::vector<XYZ>& points, std::vector<double>& params, std::vector<double>& distances, const LN_ExecutionPolicy& policy)
+{
+	GetParamsOnCurve(BuildBVH(curve), points, params, distances, policy);
+}
 
-		if (isClosed)
-		{
-			if (temp < a)
-			{
-				temp = a;
-			}
-			if (temp > b)
-			{
-				temp = b;
-			}
-		}
-		else
-		{
-			if (temp < a)
-			{
-				temp = b - (a - temp);
-			}
-			if (temp > b)
-			{
-				temp = a + (temp - b);
-			}
-		}
+void LNLib::NurbsCurve::GetParamsOnCurve(const LN_CurveBVH& bvh, const std::vector<XYZ>& points, std::vector<double>& params, std::vector<double>& distances, const LN_ExecutionPolicy& policy)
+{
+	VALIDATE_ARGUMENT(bvh.Nodes.size() > 0, "bvh", "BVH must be built by BuildBVH.");
 
-		double condition4 = ((temp - paramT) * derivatives[1]).Length();
-		if (condition4 < Constants::DistanceEpsilon) 
+	int count = points.size();
+	params.resize(count);
+	distances.resize(count);
+	int blocks = (count + ProjectionBlockSize - 1) / ProjectionBlockSize;
+	ParallelUtils::For(blocks, policy, [&](int block)
+	{
+		int leaf = -1;
+		double paramS = 0.0;
+		int end = std::min(count, (block + 1) * ProjectionBlockSize);
+		for (int i = block * ProjectionBlockSize; i < end; i++)
 		{
-			return paramT;
+			distances[i] = QueryCurveBVH(bvh, points[i], leaf, paramS);
+			params[i] = bvh.LeafParams[2 * leaf] + paramS * (bvh.LeafParams[2 * leaf + 1] - bvh.LeafParams[2 * leaf]);
 		}
-
-		paramT = temp;
-		counters++;
-	}
-	return paramT;
+	});
 }
 
 void LNLib::NurbsCurve::CreateTransformed(const LN_NurbsCurve& curve, const Matrix4d& matrix, LN_NurbsCurve& result)
@@ -1179,7 +1877,7 @@ void LNLib::NurbsCurve::Reparametrize(const LN_NurbsCurve& curve, double alpha,
 			temp = temp * lambda;
 		}
 		double newW = abs(controlPoints[i].GetW() * temp);
-		updatedControlPoints[i] = XYZW(const_cast<XYZW&>(controlPoints[i]).ToXYZ(true), newW);
+		updatedControlPoints[i] = XYZW(controlPoints[i].ToXYZ(true), newW);
 	}
 
 	result.Degree = degree;
@@ -1353,10 +2051,13 @@ void LNLib::NurbsCurve::Offset(const LN_NurbsCurve& curve, double offset, LN_Nur
 	std::vector<double> correspondingKnots;
 	EquallyTessellate(curve, tessellatedPoints, correspondingKnots);
 
+	std::vector<std::vector<XYZ>> derivatives;
+	ComputeRationalCurveDerivatives(curve, 2, correspondingKnots, derivatives);
+
 	std::vector<XYZ> newPoints(tessellatedPoints.size());
 	for (int i = 0; i < tessellatedPoints.size(); i++)
 	{
-		XYZ newPoint = tessellatedPoints[i] + offset * Normal(curve, CurveNormal::Normal, correspondingKnots[i]);
+		XYZ newPoint = tessellatedPoints[i] + offset * NormalFromDerivatives(derivatives[i], CurveNormal::Normal);
 		newPoints[i] = newPoint;
 	}
 
@@ -1462,8 +2163,8 @@ bool LNLib::NurbsCurve::CreateArc(const XYZ& center, const XYZ& xAxis, const XYZ
 		knotVector[3] = knotVector[4] = 0.5;
 		break;
 	case 3:
-		knotVector[3] = knotVector[4] = 1 / 3;
-		knotVector[5] = knotVector[6] = 2 / 3;
+		knotVector[3] = knotVector[4] = 1.0 / 3.0;
+		knotVector[5] = knotVector[6] = 2.0 / 3.0;
 		break;
 	case 4:
 		knotVector[3] = knotVector[4] = 0.25;
@@ -2779,7 +3480,7 @@ void LNLib::NurbsCurve::WeightModification(const LN_NurbsCurve& curve, double pa
 	VALIDATE_ARGUMENT(!MathUtils::IsAlmostEqualTo(moveDistance, 0.0), "moveDistance", "MoveDistance must not be zero.");
 
 	XYZ point = GetPointOnCurve(curve, parameter);
-	XYZ movePoint = const_cast<XYZW&>(controlPoints[moveIndex]).ToXYZ(true);
+	XYZ movePoint = controlPoints[moveIndex].ToXYZ(true);
 	double distance =  point.Distance(movePoint);
 	int spanIndex = Polynomials::GetKnotSpanIndex(degree, knotVector, parameter);
 	double Rkp = Polynomials::BasisFunctions(spanIndex, degree, knotVector, parameter)[0];
@@ -2804,9 +3505,9 @@ bool LNLib::NurbsCurve::NeighborWeightsModification(const LN_NurbsCurve& curve,
 	VALIDATE_ARGUMENT(!MathUtils::IsAlmostEqualTo(scale, 0.0), "scale", "Scale must not be zero.");
 
 	std::vector<XYZW> tempControlPoints = controlPoints;
-	XYZ movePoint1 = const_cast<XYZW&>(tempControlPoints[moveIndex]).ToXYZ(true);
+	XYZ movePoint1 = tempControlPoints[moveIndex].ToXYZ(true);
 	tempControlPoints[moveIndex] = XYZW(movePoint1, 0.0);
-	XYZ movePoint2 = const_cast<XYZW&>(tempControlPoints[moveIndex+1]).ToXYZ(true);
+	XYZ movePoint2 = tempControlPoints[moveIndex+1].ToXYZ(true);
 	tempControlPoints[moveIndex+1] = XYZW(movePoint2, 0.0);
 
 	LN_NurbsCurve tc;
@@ -2920,7 +3621,7 @@ bool LNLib::NurbsCurve::Flattening(const LN_NurbsCurve& curve, XYZ lineStartPoin
 	std::unordered_map<int, XYZ> selectedControlPoints;
 	for (int i = spanMinIndex; i <= spanMaxIndex - degree - 1; i++)
 	{
-		XYZ p = const_cast<XYZW&>(controlPoints[i]).ToXYZ(true);
+		XYZ p = controlPoints[i].ToXYZ(true);
 		selectedControlPoints.insert({ i, p });
 	}
 	
@@ -2965,7 +3666,7 @@ void LNLib::NurbsCurve::Bending(const LN_NurbsCurve& curve, double startParamete
 	std::unordered_map<int, XYZ> selectedControlPoints;
 	for (int i = spanMinIndex; i <= spanMaxIndex - degree - 1; i++)
 	{
-		XYZ p = const_cast<XYZW&>(updatedControlPoints[i]).ToXYZ(true);
+		XYZ p = updatedControlPoints[i].ToXYZ(true);
 		selectedControlPoints.insert({ i, p });
 	}
 
@@ -3302,10 +4003,12 @@ bool LNLib::NurbsCurve::IsArc(const LN_NurbsCurve& curve)
 	double first = knotVector[0];
 	double end = knotVector[knotVector.size() - 1];
 
-	XYZ P0 = GetPointOnCurve(curve, first);
 	double param = IsClosed(curve)?0.5 * first + 0.5 * end : end;
-	XYZ P1 = GetPointOnCurve(curve,0.5 * first + 0.5 * param);
-	XYZ P2 = GetPointOnCurve(curve, param);
+	std::vector<XYZ> points;
+	GetPointsOnCurve(curve, { first, 0.5 * first + 0.5 * param, param }, points);
+	XYZ P0 = points[0];
+	XYZ P1 = points[1];
+	XYZ P2 = points[2];
 
 	XYZ v1 = P1 - P0;
 	XYZ v2 = P2 - P0;
@@ -3372,15 +4075,15 @@ double LNLib::NurbsCurve::ApproximateLength(const LN_NurbsCurve& curve, Integrat
 			std::vector<LN_NurbsCurve> bezierCurves =  DecomposeToBeziers(reCurve);
 			for (int i = 0; i < bezierCurves.size(); i++)
 			{
-				LN_NurbsCurve bezierCurve = bezierCurves[i];
+				const LN_NurbsCurve& bezierCurve = bezierCurves[i];
 
-				std::vector<double> bKnots = bezierCurve.KnotVector;
+				const std::vector<double>& bKnots = bezierCurve.KnotVector;
 				double a = bKnots[0];
 				double b = bKnots[bKnots.size() - 1];
 				double coefficient = (b - a) / 2.0;
 
 				double bLength = 0.0;
-				std::vector<double> abscissae = Integrator::GaussLegendreAbscissae;
+				const std::vector<double>& abscissae = Integrator::GaussLegendreAbscissae;
 				int size = abscissae.size();
 				for (int i = 0; i < size; i++)
 				{
@@ -3397,7 +4100,9 @@ double LNLib::NurbsCurve::ApproximateLength(const LN_NurbsCurve& curve, Integrat
 		}
 		case IntegratorType::Chebyshev:
 		{
-			std::vector<double> series = Integrator::ChebyshevSeries();
+			// The quadrature uses the low end of the series as scratch, so each call works on a copy of the weights.
+			static const std::vector<double> chebyshevSeries = Integrator::ChebyshevSeries();
+			std::vector<double> series = chebyshevSeries;
 			for (int i = degree; i < controlPoints.size(); i++) 
 			{
 				double a = knotVector[i];
@@ -3414,38 +4119,198 @@ double LNLib::NurbsCurve::ApproximateLength(const LN_NurbsCurve& curve, Integrat
 }
 
 
-double LNLib::NurbsCurve::GetParamOnCurve(const LN_NurbsCurve& curve, double givenLength, IntegratorType type)
+double LNLib::NurbsCurve::GetParamOnCurve(const LN_NurbsCurve& curve, double givenLength, IntegratorType /*type*/)
 {
-	std::vector<double> knotVector = curve.KnotVector;
-	double start = knotVector[0];
-	double end = knotVector[knotVector.size() - 1];
-
-	double totalLength = ApproximateLength(curve, type);
+	LN_ArcLengthTable table = BuildArcLengthTable(curve);
+	double totalLength = table.Lengths[table.Lengths.size() - 1];
 	if (MathUtils::IsLessThan(totalLength, givenLength, Constants::DistanceEpsilon))
 	{
-		return end;
+		return table.Params[table.Params.size() - 1];
+	}
+	return GetParamOnCurve(table, std::min(std::max(givenLength, 0.0), totalLength));
+}
+
+LNLib::LN_ArcLengthTable LNLib::NurbsCurve::BuildArcLengthTable(const LN_NurbsCurve& curve, const LN_IntegrationTolerance& tolerance, const LN_ExecutionPolicy& policy)
+{
+	Check(curve);
+	VALIDATE_ARGUMENT(tolerance.Absolute >= 0.0, "tolerance", "Absolute tolerance must greater than or equals zero.");
+	VALIDATE_ARGUMENT(tolerance.Relative >= 0.0, "tolerance", "Relative tolerance must greater than or equals zero.");
+	VALIDATE_ARGUMENT(tolerance.Absolute > 0.0 || tolerance.Relative > 0.0, "tolerance", "Absolute or relative tolerance must greater than zero.");
+	VALIDATE_ARGUMENT(policy.ThreadCount >= 0, "policy", "ThreadCount must greater than or equals zero.");
+
+	LN_ArcLengthTable table;
+	table.Breakpoints = KnotVectorUtils::GetBreakpoints(curve.Degree, curve.KnotVector);
+	table.Segments = DecomposeToBeziers(curve);
+	VALIDATE_ARGUMENT(table.Segments.size() == table.Breakpoints.size() - 1, "curve", "KnotVector must not contain almost equal distinct knots.");
+
+	int segmentCount = table.Segments.size();
+	table.CheckedSegments.reserve(segmentCount);
+	for (int k = 0; k < segmentCount; k++)
+	{
+		table.CheckedSegments.emplace_back(Check(table.Segments[k]));
+	}
+
+	// Segments are refined independently, each with an equal share of the absolute tolerance, and merged in order.
+	// The speeds at the ends of every interval are kept for the inverse lookups.
+	double absoluteTolerance = tolerance.Absolute / segmentCount;
+	std::vector<std::vector<double>> ends(segmentCount);
+	std::vector<std::vector<double>> lengths(segmentCount);
+	std::vector<std::vector<double>> speeds(segmentCount);
+	ParallelUtils::For(segmentCount, policy, [&](int k)
+	{
+		const LN_CheckedNurbsCurve& segment = table.CheckedSegments[k];
+		RefineArcLengthIntervals(segment, 0.0, 1.0, IntegrateSegmentSpeed(segment, 0.0, 1.0), absoluteTolerance, tolerance.Relative, 0, ends[k], lengths[k]);
+
+		std::vector<double> params(1, 0.0);
+		params.insert(params.end(), ends[k].begin(), ends[k].end());
+		std::vector<XYZ> derivatives;
+		ComputeRationalCurveDerivatives(segment, 1, params, derivatives);
+		speeds[k].resize(params.size());
+		for (int i = 0; i < params.size(); i++)
+		{
+			speeds[k][i] = derivatives[2 * i + 1].Length();
+		}
+	});
+
+	table.Params.emplace_back(table.Breakpoints[0]);
+	table.Lengths.emplace_back(0.0);
+	for (int k = 0; k < segmentCount; k++)
+	{
+		double a = table.Breakpoints[k];
+		double b = table.Breakpoints[k + 1];
+		for (int i = 0; i < ends[k].size(); i++)
+		{
+			table.Params.emplace_back(i == ends[k].size() - 1 ? b : a + ends[k][i] * (b - a));
+			table.Lengths.emplace_back(table.Lengths[table.Lengths.size() - 1] + lengths[k][i]);
+			table.Speeds.emplace_back(speeds[k][i] / (b - a));
+			table.Speeds.emplace_back(speeds[k][i + 1] / (b - a));
+			table.IntervalSegments.emplace_back(k);
+		}
 	}
+	return table;
+}
 
-	double param = GetParamByLength(curve, start, end, givenLength, type);
-	return param;
+double LNLib::NurbsCurve::ApproximateLength(const LN_NurbsCurve& curve, const LN_IntegrationTolerance& tolerance, const LN_ExecutionPolicy& policy)
+{
+	LN_ArcLengthTable table = BuildArcLengthTable(curve, tolerance, policy);
+	return table.Lengths[table.Lengths.size() - 1];
 }
 
-std::vector<double> LNLib::NurbsCurve::GetParamsOnCurve(const LN_NurbsCurve& curve, double givenLength, IntegratorType type)
+double LNLib::NurbsCurve::ApproximateLength(const LN_ArcLengthTable& table, double startT, double endT)
 {
+	VALIDATE_ARGUMENT(startT <= endT, "endT", "EndT must greater than or equals startT.");
+	return ApproximateLength(table, endT) - ApproximateLength(table, startT);
+}
+
+double LNLib::NurbsCurve::ApproximateLength(const LN_ArcLengthTable& table, double paramT)
+{
+	VALIDATE_ARGUMENT(table.IntervalSegments.size() > 0, "table", "Table must be built by BuildArcLengthTable.");
+	VALIDATE_ARGUMENT_RANGE(paramT, table.Params[0], table.Params[table.Params.size() - 1]);
+
+	int last = table.IntervalSegments.size() - 1;
+	int i = std::min(std::max(static_cast<int>(std::upper_bound(table.Params.begin(), table.Params.end(), paramT) - table.Params.begin()) - 1, 0), last);
+	int k = table.IntervalSegments[i];
+	double a = table.Breakpoints[k];
+	double b = table.Breakpoints[k + 1];
+	return table.Lengths[i] + IntegrateSegmentSpeed(table.CheckedSegments[k], (table.Params[i] - a) / (b - a), (paramT - a) / (b - a));
+}
+
+double LNLib::NurbsCurve::GetParamOnCurve(const LN_ArcLengthTable& table, double givenLength)
+{
+	VALIDATE_ARGUMENT(table.IntervalSegments.size() > 0, "table", "Table must be built by BuildArcLengthTable.");
+	double totalLength = table.Lengths[table.Lengths.size() - 1];
+	VALIDATE_ARGUMENT_RANGE(givenLength, 0.0, totalLength);
+
+	int last = table.IntervalSegments.size() - 1;
+	int i = std::min(std::max(static_cast<int>(std::upper_bound(table.Lengths.begin(), table.Lengths.end(), givenLength) - table.Lengths.begin()) - 1, 0), last);
+	return SolveArcLengthInterval(table, i, givenLength);
+}
+
+std::vector<double> LNLib::NurbsCurve::GetParamsOnCurve(const LN_NurbsCurve& curve, double givenLength, IntegratorType /*type*/)
+{
+	return DivideByLength(BuildArcLengthTable(curve), givenLength);
+}
+
+std::vector<double> LNLib::NurbsCurve::DivideByLength(const LN_ArcLengthTable& table, double segmentLength, CurveDivisionType type)
+{
+	VALIDATE_ARGUMENT(table.IntervalSegments.size() > 0, "table", "Table must be built by BuildArcLengthTable.");
+	VALIDATE_ARGUMENT(segmentLength > 0.0, "segmentLength", "SegmentLength must greater than zero.");
+
 	std::vector<double> result;
+	if (type == CurveDivisionType::Chord)
+	{
+		WalkChords(table, segmentLength, Constants::DoubleEpsilon * segmentLength, std::numeric_limits<int>::max(), result);
+		return result;
+	}
 
-	std::vector<double> knotVector = curve.KnotVector;
-	double end = knotVector[knotVector.size() - 1];
-	
-	double param = GetParamOnCurve(curve, givenLength, type);
-	while (!MathUtils::IsAlmostEqualTo(param, end))
+	// The end test is relative to the segment, so neither long nor tiny curves gain or lose stations at the end.
+	double totalLength = table.Lengths[table.Lengths.size() - 1];
+	int interval = 0;
+	for (int k = 1; k * segmentLength < totalLength - ArcLengthTolerance * segmentLength; k++)
+	{
+		double length = k * segmentLength;
+		interval = FindArcLengthInterval(table, interval, length);
+		result.emplace_back(SolveArcLengthInterval(table, interval, length));
+	}
+	return result;
+}
+
+std::vector<double> LNLib::NurbsCurve::DivideByCount(const LN_ArcLengthTable& table, int count, CurveDivisionType type, double tolerance)
+{
+	VALIDATE_ARGUMENT(table.IntervalSegments.size() > 0, "table", "Table must be built by BuildArcLengthTable.");
+	VALIDATE_ARGUMENT(count > 0, "count", "Count must greater than zero.");
+	VALIDATE_ARGUMENT(tolerance > 0.0, "tolerance", "Tolerance must greater than zero.");
+
+	std::vector<double> result;
+	if (count == 1)
+	{
+		return result;
+	}
+	double totalLength = table.Lengths[table.Lengths.size() - 1];
+	if (type == CurveDivisionType::ArcLength)
 	{
-		result.emplace_back(param);
+		int interval = 0;
+		for (int k = 1; k < count; k++)
+		{
+			double length = totalLength * k / count;
+			interval = FindArcLengthInterval(table, interval, length);
+			result.emplace_back(SolveArcLengthInterval(table, interval, length));
+		}
+		return result;
+	}
 
-		LN_NurbsCurve left;
-		LN_NurbsCurve right;
-		SplitAt(curve, param, left, right);
-		param = GetParamOnCurve(right, givenLength, type);
+	// A chord is never longer than its arc, so count - 1 chords of totalLength / count leave at most one chord to the end.
+	double low = 0.0;
+	double high = totalLength / count;
+	double best = std::numeric_limits<double>::max();
+	std::vector<double> params;
+	for (int iteration = 0; iteration < MaxChordIterations; iteration++)
+	{
+		double chordLength = (low + high) / 2.0;
+		double remaining = WalkChords(table, chordLength, tolerance / 2.0, count - 1, params);
+		if (params.size() < count - 1)
+		{
+			high = chordLength;
+			continue;
+		}
+		double difference = remaining - chordLength;
+		if (abs(difference) < best)
+		{
+			best = abs(difference);
+			result = params;
+		}
+		if (best <= tolerance)
+		{
+			break;
+		}
+		if (difference > 0.0)
+		{
+			low = chordLength;
+		}
+		else
+		{
+			high = chordLength;
+		}
 	}
 	return result;
 }
@@ -24,8 +24,15 @@
 #include "KnotVectorUtils.h"
 #include "ControlPointsUtils.h"
 #include "Integrator.h"
+#include "SimdKernels.h"
+#include "ParallelUtils.h"
+#include "TessellationSink.h"
 #include "LNLibExceptions.h"
 #include "LNObject.h"
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 #include <algorithm>
 
 namespace LNLib
@@ -62,14 +69,905 @@ namespace LNLib
 	{
 		double operator()(double parameter, void* customData)
 		{
-			static std::vector<double> series;
+			// The quadrature uses the low end of the series as scratch, so the inner integral works on its own copy.
 			AreaCoreFunction areaCoreFunction;
 			AreaData* data = (AreaData*)customData;
+			std::vector<double> series = data->Series;
 			data->ParameterV = parameter;
 			return Integrator::ClenshawCurtisQuadrature(areaCoreFunction, data, data->CurrentKnotU, data->NextKnotU, series);
 		}
 	};
 
+	const int MaxPatchAreaEvaluations = 100000;
+
+	std::vector<double> GetBernsteinValues(int degree, double paramT)
+	{
+		return degree == 0 ? std::vector<double>(1, 1.0) : Polynomials::AllBernstein(degree, paramT);
+	}
+
+	/// <summary>
+	/// Area element |Su x Sv| of a non-rational Bezier patch over [0, 1] x [0, 1] on the grid of us and vs.
+	/// Su and Sv are Bezier patches of degree (p - 1, q) and (p, q - 1) whose control nets are the scaled differences of the patch net;
+	/// they are first contracted with the v basis for each vs[j], then with the u basis for each us[i].
+	/// </summary>
+	void EvaluatePolynomialAreaElements(const std::vector<std::vector<XYZ>>& controlPoints, const std::vector<double>& us, const std::vector<double>& vs, std::vector<double>& values)
+	{
+		int degreeU = controlPoints.size() - 1;
+		int degreeV = controlPoints[0].size() - 1;
+		if (degreeU == 0 || degreeV == 0)
+		{
+			std::fill(values.begin(), values.end(), 0.0);
+			return;
+		}
+
+		int columns = vs.size();
+		std::vector<std::vector<XYZ>> partialsU(degreeU, std::vector<XYZ>(columns));
+		std::vector<std::vector<XYZ>> partialsV(degreeU + 1, std::vector<XYZ>(columns));
+		for (int j = 0; j < columns; j++)
+		{
+			std::vector<double> basisV = GetBernsteinValues(degreeV, vs[j]);
+			std::vector<double> basisDerivativeV = GetBernsteinValues(degreeV - 1, vs[j]);
+			for (int a = 0; a <= degreeU; a++)
+			{
+				if (a < degreeU)
+				{
+					XYZ sum;
+					for (int b = 0; b <= degreeV; b++)
+					{
+						sum += basisV[b] * (controlPoints[a + 1][b] - controlPoints[a][b]);
+					}
+					partialsU[a][j] = degreeU * sum;
+				}
+				XYZ sum;
+				for (int b = 0; b < degreeV; b++)
+				{
+					sum += basisDerivativeV[b] * (controlPoints[a][b + 1] - controlPoints[a][b]);
+				}
+				partialsV[a][j] = degreeV * sum;
+			}
+		}
+
+		for (int i = 0; i < us.size(); i++)
+		{
+			std::vector<double> basisU = GetBernsteinValues(degreeU, us[i]);
+			std::vector<double> basisDerivativeU = GetBernsteinValues(degreeU - 1, us[i]);
+			for (int j = 0; j < columns; j++)
+			{
+				XYZ Su;
+				XYZ Sv;
+				for (int a = 0; a <= degreeU; a++)
+				{
+					if (a < degreeU)
+					{
+						Su += basisDerivativeU[a] * partialsU[a][j];
+					}
+					Sv += basisU[a] * partialsV[a][j];
+				}
+				values[i * columns + j] = Su.CrossProduct(Sv).Length();
+			}
+		}
+	}
+
+	void ComputeRationalDerivativesKL(const XYZW* ders, int derivative, XYZ* derivatives)
+	{
+		int n = derivative + 1;
+		double weight = ders[0].GetW();
+		for (int k = 0; k <= derivative; k++)
+		{
+			const double* binomialK = MathUtils::BinomialRow(k);
+			for (int l = 0; l <= derivative - k; l++)
+			{
+				const double* binomialL = MathUtils::BinomialRow(l);
+				const XYZW& Aders = ders[k * n + l];
+				XYZ v = XYZ(Aders.GetWX(), Aders.GetWY(), Aders.GetWZ());
+				for (int j = 1; j <= l; j++)
+				{
+					v = v - (binomialL[j] * ders[j].GetW()) * derivatives[k * n + l - j];
+				}
+
+				for (int i = 1; i <= k; i++)
+				{
+					v = v - (binomialK[i] * ders[i * n].GetW()) * derivatives[(k - i) * n + l];
+
+					XYZ v2 = XYZ(0, 0, 0);
+					for (int j = 1; j <= l; j++)
+					{
+						v2 = v2 + (binomialL[j] * ders[i * n + j].GetW()) * derivatives[(k - i) * n + l - j];
+					}
+					v = v - binomialK[i] * v2;
+				}
+				derivatives[k * n + l] = v / weight;
+			}
+			for (int l = derivative - k + 1; l <= derivative; l++)
+			{
+				derivatives[k * n + l] = XYZ(0, 0, 0);
+			}
+		}
+	}
+
+	std::vector<std::vector<XYZ>> ComputeRationalDerivativesKL(const XYZW* ders, int derivative)
+	{
+		int n = derivative + 1;
+		LN_ScratchBuffer<16, XYZ> flat(n * n);
+		ComputeRationalDerivativesKL(ders, derivative, flat.Data());
+
+		std::vector<std::vector<XYZ>> derivatives(n, std::vector<XYZ>(n));
+		for (int k = 0; k < n; k++)
+		{
+			for (int l = 0; l < n; l++)
+			{
+				derivatives[k][l] = flat[k * n + l];
+			}
+		}
+		return derivatives;
+	}
+
+	std::vector<std::vector<XYZ>> ComputeRationalDerivativesKL(const std::vector<std::vector<XYZW>>& ders, int derivative)
+	{
+		int n = derivative + 1;
+		LN_ScratchBuffer<16, XYZW> flat(n * n);
+		for (int k = 0; k < n; k++)
+		{
+			for (int l = 0; l < n; l++)
+			{
+				flat[k * n + l] = ders[k][l];
+			}
+		}
+		return ComputeRationalDerivativesKL(flat.Data(), derivative);
+	}
+
+	void ComputeCheckedSurfaceDerivatives(const LN_CheckedNurbsSurface& surface, const XYZW* ders, int derivative, XYZ* derivatives)
+	{
+		if (surface.IsRational())
+		{
+			ComputeRationalDerivativesKL(ders, derivative, derivatives);
+			return;
+		}
+		int n = derivative + 1;
+		for (int i = 0; i < n * n; i++)
+		{
+			derivatives[i] = XYZ(ders[i].GetWX(), ders[i].GetWY(), ders[i].GetWZ());
+		}
+	}
+
+	double CurvatureFromSurfaceDerivatives(const std::vector<std::vector<XYZ>>& ders, SurfaceCurvature curvature)
+	{
+		XYZ Suu = ders[2][0];
+		XYZ Svv = ders[0][2];
+		XYZ Suv = ders[1][1];
+
+		XYZ Su = ders[1][0];
+		XYZ Sv = ders[0][1];
+		XYZ normal = Su.Normalize().CrossProduct(Sv).Normalize();
+
+		double L = Suu.DotProduct(normal);
+		double M = Suv.DotProduct(normal);
+		double N = Svv.DotProduct(normal);
+
+		double E = Su.DotProduct(Su);
+		double F = Su.DotProduct(Sv);
+		double G = Sv.DotProduct(Sv);
+
+		double denominator = E * G - F * F;
+		if (MathUtils::IsAlmostEqualTo(denominator, 0.0))
+		{
+			return 0.0;
+		}
+
+		double K = (L * N - M * M) / denominator;
+		double H = (E * N + G * L - 2 * F * M) / (2 * denominator);
+		double k1 = H + sqrt(abs(H * H - K));
+		double k2 = H - sqrt(abs(H * H - K));
+
+		if (curvature == SurfaceCurvature::Gauss)
+		{
+			return K;
+		}
+		else if (curvature == SurfaceCurvature::Mean)
+		{
+			return H;
+		}
+		else if (curvature == SurfaceCurvature::Maximum)
+		{
+			return k1;
+		}
+		else if (curvature == SurfaceCurvature::Minimum)
+		{
+			return k2;
+		}
+		else if (curvature == SurfaceCurvature::Abs)
+		{
+			return abs(k1) + abs(k2);
+		}
+		else if (curvature == SurfaceCurvature::Rms)
+		{
+			return sqrt(k1 * k1 + k2 * k2);
+		}
+		return 0.0;
+	}
+
+	const int MaxTessellationDepth = 12;
+
+	/// <summary>
+	/// Triangle abc has zero area relative to its edges: the sine of its angle at a is below DoubleEpsilon.
+	/// Unlike an absolute area test, this keeps the small triangles of small or finely tessellated surfaces.
+	/// </summary>
+	bool IsDegenerateTriangle(const XYZ& a, const XYZ& b, const XYZ& c)
+	{
+		XYZ ab = b - a;
+		XYZ ac = c - a;
+		double epsilon = Constants::DoubleEpsilon;
+		return ab.CrossProduct(ac).SqrLength() <= epsilon * epsilon * ab.SqrLength() * ac.SqrLength();
+	}
+
+	class SurfacePointsCollector : public SurfaceTessellationSink
+	{
+	public:
+		SurfacePointsCollector(std::vector<XYZ>& points, std::vector<UV>& uvs) : Points(points), UVs(uvs) {}
+
+		void AddVertices(const XYZ* vertices, const XYZ* /*normals*/, const UV* uvs, int count)
+		{
+			Points.insert(Points.end(), vertices, vertices + count);
+			UVs.insert(UVs.end(), uvs, uvs + count);
+		}
+
+		void AddTriangles(const int* /*indices*/, int /*triangleCount*/)
+		{
+		}
+
+	private:
+		std::vector<XYZ>& Points;
+		std::vector<UV>& UVs;
+	};
+
+	class MeshCollector : public SurfaceTessellationSink
+	{
+	public:
+		MeshCollector(LN_Mesh& mesh) : Mesh(mesh) {}
+
+		void AddVertices(const XYZ* vertices, const XYZ* normals, const UV* uvs, int count)
+		{
+			Mesh.Vertices.insert(Mesh.Vertices.end(), vertices, vertices + count);
+			Mesh.Normals.insert(Mesh.Normals.end(), normals, normals + count);
+			Mesh.UVs.insert(Mesh.UVs.end(), uvs, uvs + count);
+		}
+
+		void AddTriangles(const int* indices, int triangleCount)
+		{
+			Mesh.Triangles.insert(Mesh.Triangles.end(), indices, indices + 3 * triangleCount);
+		}
+
+	private:
+		LN_Mesh& Mesh;
+	};
+
+	/// <summary>
+	/// Checks the isoparametric edge [start, end] x crossParam (or crossParam x [start, end]) of a Bezier patch against tolerance.
+	/// The edge is sampled 2 * degree + 3 times along its direction, so every wiggle a Bezier of that degree can make falls between
+	/// neighbouring samples and none is missed by the chord height check.
+	/// </summary>
+	bool IsIsoEdgeWithinTolerance(const LN_CheckedNurbsSurface& patch, const LN_TessellationTolerance& tolerance, bool isUDirection, double start, double end, double crossParam)
+	{
+		int degree = isUDirection ? patch.GetSurface().DegreeU : patch.GetSurface().DegreeV;
+		int samples = 2 * degree + 3;
+		std::vector<XYZ> points(samples);
+		std::vector<XYZ> normals(samples);
+		for (int i = 0; i < samples; i++)
+		{
+			double param = start + (end - start) * i / (samples - 1);
+			UV uv = isUDirection ? UV(param, crossParam) : UV(crossParam, param);
+			std::vector<std::vector<XYZ>> derivatives = NurbsSurface::ComputeRationalSurfaceDerivatives(patch, 1, uv);
+			points[i] = derivatives[0][0];
+			normals[i] = derivatives[1][0].Normalize().CrossProduct(derivatives[0][1]).Normalize();
+		}
+
+		for (int i = 1; i < samples - 1; i++)
+		{
+			if (Projection::DistanceToLine(points[0], points[samples - 1], points[i]) > tolerance.ChordHeight)
+			{
+				return false;
+			}
+		}
+		int middle = samples / 2;
+		if (std::max(normals[0].AngleTo(normals[middle]), normals[middle].AngleTo(normals[samples - 1])) > tolerance.AngleTolerance)
+		{
+			return false;
+		}
+		if (tolerance.MaxEdgeLength > 0.0 && points[0].Distance(points[samples - 1]) > tolerance.MaxEdgeLength)
+		{
+			return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Bisects [start, end] of the Bezier parameter range until the edges at the borders and the middle of every patch meet tolerance,
+	/// appending the end of every accepted interval.
+	/// </summary>
+	void RefineIsoParameters(const std::vector<LN_CheckedNurbsSurface>& patches, const LN_TessellationTolerance& tolerance, bool isUDirection, double start, double end, int depth, std::vector<double>& params)
+	{
+		if (depth < MaxTessellationDepth)
+		{
+			const double crossParams[3] = { 0.0, 0.5, 1.0 };
+			for (int i = 0; i < patches.size(); i++)
+			{
+				for (int j = 0; j < 3; j++)
+				{
+					if (!IsIsoEdgeWithinTolerance(patches[i], tolerance, isUDirection, start, end, crossParams[j]))
+					{
+						double middle = (start + end) / 2.0;
+						RefineIsoParameters(patches, tolerance, isUDirection, start, middle, depth + 1, params);
+						RefineIsoParameters(patches, tolerance, isUDirection, middle, end, depth + 1, params);
+						return;
+					}
+				}
+			}
+		}
+		params.emplace_back(end);
+	}
+
+	/// <summary>
+	/// Adaptive splits of every knot span: spanParams[i] holds the accepted interval ends of u span i over [0, 1],
+	/// spanParams[spansU + j] those of v span j.
+	/// </summary>
+	void RefineSurfaceSpans(const LN_NurbsSurface& surface, const LN_TessellationTolerance& tolerance, const LN_ExecutionPolicy& policy, std::vector<double>& breakpointsU, std::vector<double>& breakpointsV, std::vector<std::vector<double>>& spanParams)
+	{
+		breakpointsU = KnotVectorUtils::GetBreakpoints(surface.DegreeU, surface.KnotVectorU);
+		breakpointsV = KnotVectorUtils::GetBreakpoints(surface.DegreeV, surface.KnotVectorV);
+		int spansU = breakpointsU.size() - 1;
+		int spansV = breakpointsV.size() - 1;
+
+		// Patches are parameterized over [0, 1] x [0, 1], so normals at their borders are one-sided even along creases.
+		std::vector<LN_NurbsSurface> bezierPatches = NurbsSurface::DecomposeToBeziers(surface);
+		VALIDATE_ARGUMENT(bezierPatches.size() == spansU * spansV, "surface", "KnotVector must not contain almost equal distinct knots.");
+		std::vector<LN_CheckedNurbsSurface> patches;
+		patches.reserve(bezierPatches.size());
+		for (int i = 0; i < bezierPatches.size(); i++)
+		{
+			patches.emplace_back(NurbsSurface::Check(bezierPatches[i]));
+		}
+
+		// Task i < spansU refines u span i over its row of patches, task spansU + j refines v span j over its column.
+		spanParams.assign(spansU + spansV, std::vector<double>());
+		ParallelUtils::For(spansU + spansV, policy, [&](int task)
+		{
+			bool isUDirection = task < spansU;
+			std::vector<LN_CheckedNurbsSurface> stripe;
+			if (isUDirection)
+			{
+				stripe.assign(patches.begin() + task * spansV, patches.begin() + (task + 1) * spansV);
+			}
+			else
+			{
+				for (int i = 0; i < spansU; i++)
+				{
+					stripe.emplace_back(patches[i * spansV + task - spansU]);
+				}
+			}
+			RefineIsoParameters(stripe, tolerance, isUDirection, 0.0, 1.0, 0, spanParams[task]);
+		});
+	}
+
+	/// <summary>
+	/// Maps the splits of knot span [breakpoints[span], breakpoints[span + 1]] to surface parameters and appends them, ending with the exact breakpoint.
+	/// </summary>
+	void AppendSpanParameters(const std::vector<double>& breakpoints, int span, const std::vector<double>& spanParams, std::vector<double>& params)
+	{
+		for (int k = 0; k < spanParams.size() - 1; k++)
+		{
+			params.emplace_back(breakpoints[span] + spanParams[k] * (breakpoints[span + 1] - breakpoints[span]));
+		}
+		params.emplace_back(breakpoints[span + 1]);
+	}
+
+	/// <summary>
+	/// Sides of a surface parameter domain, in the order 0: v = minV, 1: u = maxU, 2: v = maxV, 3: u = minU.
+	/// Even sides run along u, odd sides along v.
+	/// </summary>
+	UV GetSideUV(const LN_CheckedNurbsSurface& checkedSurface, int side, double param)
+	{
+		const LN_BsplineSurfaceView<XYZW>& surface = checkedSurface.GetSurface();
+		switch (side)
+		{
+		case 0:
+			return UV(param, surface.KnotVectorV[0]);
+		case 1:
+			return UV(surface.KnotVectorU[surface.KnotVectorU.size() - 1], param);
+		case 2:
+			return UV(param, surface.KnotVectorV[surface.KnotVectorV.size() - 1]);
+		default:
+			return UV(surface.KnotVectorU[0], param);
+		}
+	}
+
+	const int BoundarySideSamples = 33;
+
+	/// <summary>
+	/// A boundary side sampled at equally spaced parameters, used to seed point inversion onto it.
+	/// </summary>
+	struct BoundarySide
+	{
+		int Surface;
+		int Side;
+		std::vector<double> Params;
+		std::vector<XYZ> Samples;
+	};
+
+	/// <summary>
+	/// Parameter of the point closest to point on a boundary side, by Gauss-Newton iterations from the nearest sample.
+	/// </summary>
+	double InvertOnBoundarySide(const LN_CheckedNurbsSurface& surface, const BoundarySide& side, const XYZ& point, XYZ& closest)
+	{
+		int nearest = 0;
+		for (int i = 1; i < side.Samples.size(); i++)
+		{
+			if (side.Samples[i].Distance(point) < side.Samples[nearest].Distance(point))
+			{
+				nearest = i;
+			}
+		}
+
+		double minParam = side.Params[0];
+		double maxParam = side.Params[side.Params.size() - 1];
+		double param = side.Params[nearest];
+
+		// A tangent is negligible relative to the mean speed of the side, not in absolute terms, so small surfaces still iterate.
+		double sideLength = 0.0;
+		for (int i = 1; i < side.Samples.size(); i++)
+		{
+			sideLength += side.Samples[i].Distance(side.Samples[i - 1]);
+		}
+		double minSpeed = Constants::DoubleEpsilon * sideLength / (maxParam - minParam);
+		const int maxIterations = 32;
+		for (int i = 0; i < maxIterations; i++)
+		{
+			std::vector<std::vector<XYZ>> derivatives = NurbsSurface::ComputeRationalSurfaceDerivatives(surface, 1, GetSideUV(surface, side.Side, param));
+			const XYZ& tangent = side.Side % 2 == 0 ? derivatives[1][0] : derivatives[0][1];
+			double squareLength = tangent.DotProduct(tangent);
+			if (squareLength <= minSpeed * minSpeed)
+			{
+				break;
+			}
+			double next = std::min(std::max(param - tangent.DotProduct(derivatives[0][0] - point) / squareLength, minParam), maxParam);
+			bool isConverged = abs(next - param) <= Constants::DoubleEpsilon * Constants::DoubleEpsilon * (maxParam - minParam);
+			param = next;
+			if (isConverged)
+			{
+				break;
+			}
+		}
+		closest = NurbsSurface::GetPointOnSurface(surface, GetSideUV(surface, side.Side, param));
+		return param;
+	}
+
+	/// <summary>
+	/// Two boundary sides lying on the same curve. Side b runs against side a when isReversed.
+	/// </summary>
+	struct SharedBoundary
+	{
+		int First;
+		int Second;
+		bool IsReversed;
+	};
+
+	/// <summary>
+	/// Sides a and b are shared when their ends coincide and the quarter points of a lie on b.
+	/// Sides collapsed to a point are never shared.
+	/// </summary>
+	bool IsSharedBoundary(const BoundarySide& a, const LN_CheckedNurbsSurface& surfaceB, const BoundarySide& b, bool& isReversed)
+	{
+		const int last = BoundarySideSamples - 1;
+		const XYZ& startA = a.Samples[0];
+		const XYZ& endA = a.Samples[last];
+		const XYZ& startB = b.Samples[0];
+		const XYZ& endB = b.Samples[last];
+		if (startA.Distance(endA) < Constants::DistanceEpsilon && startA.Distance(a.Samples[last / 2]) < Constants::DistanceEpsilon)
+		{
+			return false;
+		}
+		bool isSameEnds = startA.Distance(startB) < Constants::DistanceEpsilon && endA.Distance(endB) < Constants::DistanceEpsilon;
+		bool isOppositeEnds = startA.Distance(endB) < Constants::DistanceEpsilon && endA.Distance(startB) < Constants::DistanceEpsilon;
+		if (!isSameEnds && !isOppositeEnds)
+		{
+			return false;
+		}
+
+		double mapped[3];
+		for (int i = 0; i < 3; i++)
+		{
+			XYZ closest;
+			const XYZ& point = a.Samples[(i + 1) * last / 4];
+			mapped[i] = InvertOnBoundarySide(surfaceB, b, point, closest);
+			if (closest.Distance(point) > Constants::DistanceEpsilon)
+			{
+				return false;
+			}
+		}
+		isReversed = mapped[0] > mapped[2];
+		return isReversed ? isOppositeEnds : isSameEnds;
+	}
+
+	/// <summary>
+	/// Parameters mapped across a shared side land this close (relative to the parameter range) to the ones they came from.
+	/// </summary>
+	const double BoundaryParameterTolerance = 1E-9;
+
+	/// <summary>
+	/// Inserts param into the sorted params unless an almost equal value is already there.
+	/// </summary>
+	bool InsertBoundaryParameter(std::vector<double>& params, double param)
+	{
+		double tolerance = BoundaryParameterTolerance * (params[params.size() - 1] - params[0]);
+		std::vector<double>::iterator position = std::lower_bound(params.begin(), params.end(), param);
+		if ((position != params.end() && *position - param <= tolerance) || (position != params.begin() && param - *(position - 1) <= tolerance))
+		{
+			return false;
+		}
+		params.insert(position, param);
+		return true;
+	}
+
+	/// <summary>
+	/// Adds to the parameters of side "to" the images of the points of side "from", returning whether any was new.
+	/// </summary>
+	bool TransferBoundaryParameters(const LN_CheckedNurbsSurface& from, const BoundarySide& fromSide, const std::vector<double>& fromParams, const LN_CheckedNurbsSurface& to, const BoundarySide& toSide, std::vector<double>& toParams)
+	{
+		bool isChanged = false;
+		for (int i = 0; i < fromParams.size(); i++)
+		{
+			XYZ closest;
+			XYZ point = NurbsSurface::GetPointOnSurface(from, GetSideUV(from, fromSide.Side, fromParams[i]));
+			isChanged |= InsertBoundaryParameter(toParams, InvertOnBoundarySide(to, toSide, point, closest));
+		}
+		return isChanged;
+	}
+
+	/// <summary>
+	/// Grid index of position k along a side of a uCount x vCount grid.
+	/// </summary>
+	int GetSideGridIndex(int side, int k, int uCount, int vCount)
+	{
+		switch (side)
+		{
+		case 0:
+			return k * vCount;
+		case 1:
+			return (uCount - 1) * vCount + k;
+		case 2:
+			return k * vCount + vCount - 1;
+		default:
+			return k;
+		}
+	}
+
+	int FindVertexRoot(std::vector<int>& roots, int index)
+	{
+		while (roots[index] != index)
+		{
+			roots[index] = roots[roots[index]];
+			index = roots[index];
+		}
+		return index;
+	}
+
+	const int MaxBVHSubdivisionDepth = 8;
+
+	/// <summary>
+	/// Deviation of a flat piece's control rows and columns from their chords, relative to the chord length.
+	/// </summary>
+	const double BVHFlatness = 0.05;
+
+	/// <summary>
+	/// de Casteljau split of a Bezier control polygon at its middle.
+	/// </summary>
+	void HalveBezierPolygon(const std::vector<XYZW>& controlPoints, std::vector<XYZW>& left, std::vector<XYZW>& right)
+	{
+		int size = controlPoints.size();
+		std::vector<XYZW> temp = controlPoints;
+		left.resize(size);
+		right.resize(size);
+		for (int k = 0; k < size; k++)
+		{
+			left[k] = temp[0];
+			right[size - 1 - k] = temp[size - 1 - k];
+			for (int i = 0; i < size - 1 - k; i++)
+			{
+				temp[i] = 0.5 * temp[i];
+				temp[i] += 0.5 * temp[i + 1];
+			}
+		}
+	}
+
+	/// <summary>
+	/// Halves a Bezier piece of [startU, endU] x [startV, endV] until every row and column of its control net is flat
+	/// (see ControlPointsUtils::IsFlatPolygon), splitting only along the directions that are not, and appends the pieces and their parameter ranges.
+	/// </summary>
+	void SubdivideToBVHLeaves(const std::vector<std::vector<XYZW>>& controlPoints, double startU, double endU, double startV, double endV, int depthU, int depthV, std::vector<std::vector<std::vector<XYZW>>>& leaves, std::vector<double>& leafParams)
+	{
+		std::vector<std::vector<XYZ>> points = ControlPointsUtils::ToXYZ(controlPoints);
+		int rows = points.size();
+		int columns = points[0].size();
+		bool isFlatU = depthU >= MaxBVHSubdivisionDepth;
+		for (int j = 0; j < columns && !isFlatU; j++)
+		{
+			std::vector<XYZ> column(rows);
+			for (int i = 0; i < rows; i++)
+			{
+				column[i] = points[i][j];
+			}
+			if (!ControlPointsUtils::IsFlatPolygon(column, BVHFlatness))
+			{
+				break;
+			}
+			isFlatU = j == columns - 1;
+		}
+		bool isFlatV = depthV >= MaxBVHSubdivisionDepth;
+		for (int i = 0; i < rows && !isFlatV; i++)
+		{
+			if (!ControlPointsUtils::IsFlatPolygon(points[i], BVHFlatness))
+			{
+				break;
+			}
+			isFlatV = i == rows - 1;
+		}
+		if (isFlatU && isFlatV)
+		{
+			leaves.emplace_back(controlPoints);
+			leafParams.insert(leafParams.end(), { startU, endU, startV, endV });
+			return;
+		}
+
+		std::vector<std::vector<XYZW>> first;
+		std::vector<std::vector<XYZW>> second;
+		if (!isFlatU)
+		{
+			first.assign(rows, std::vector<XYZW>(columns));
+			second.assign(rows, std::vector<XYZW>(columns));
+			std::vector<XYZW> column(rows);
+			std::vector<XYZW> left;
+			std::vector<XYZW> right;
+			for (int j = 0; j < columns; j++)
+			{
+				for (int i = 0; i < rows; i++)
+				{
+					column[i] = controlPoints[i][j];
+				}
+				HalveBezierPolygon(column, left, right);
+				for (int i = 0; i < rows; i++)
+				{
+					first[i][j] = left[i];
+					second[i][j] = right[i];
+				}
+			}
+			double middle = (startU + endU) / 2.0;
+			SubdivideToBVHLeaves(first, startU, middle, startV, endV, depthU + 1, depthV, leaves, leafParams);
+			SubdivideToBVHLeaves(second, middle, endU, startV, endV, depthU + 1, depthV, leaves, leafParams);
+			return;
+		}
+
+		first.resize(rows);
+		second.resize(rows);
+		for (int i = 0; i < rows; i++)
+		{
+			HalveBezierPolygon(controlPoints[i], first[i], second[i]);
+		}
+		double middle = (startV + endV) / 2.0;
+		SubdivideToBVHLeaves(first, startU, endU, startV, middle, depthU, depthV + 1, leaves, leafParams);
+		SubdivideToBVHLeaves(second, startU, endU, middle, endV, depthU, depthV + 1, leaves, leafParams);
+	}
+
+	/// <summary>
+	/// Builds the nodes over order[begin, end), splitting at the median box center along the longest axis of the centers.
+	/// </summary>
+	int BuildSurfaceBVHNodes(const std::vector<LN_BVHNode>& leafBoxes, std::vector<int>& order, int begin, int end, std::vector<LN_BVHNode>& nodes)
+	{
+		int index = nodes.size();
+		if (end - begin == 1)
+		{
+			nodes.emplace_back(leafBoxes[order[begin]]);
+			return index;
+		}
+		nodes.emplace_back(LN_BVHNode());
+
+		XYZ min = 0.5 * (leafBoxes[order[begin]].Min + leafBoxes[order[begin]].Max);
+		XYZ max = min;
+		for (int i = begin + 1; i < end; i++)
+		{
+			XYZ center = 0.5 * (leafBoxes[order[i]].Min + leafBoxes[order[i]].Max);
+			for (int k = 0; k < 3; k++)
+			{
+				min[k] = std::min(min[k], center[k]);
+				max[k] = std::max(max[k], center[k]);
+			}
+		}
+		XYZ extent = max - min;
+		int axis = extent[0] >= extent[1] && extent[0] >= extent[2] ? 0 : (extent[1] >= extent[2] ? 1 : 2);
+		int middle = (begin + end) / 2;
+		std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [&](int a, int b)
+		{
+			return leafBoxes[a].Min[axis] + leafBoxes[a].Max[axis] < leafBoxes[b].Min[axis] + leafBoxes[b].Max[axis];
+		});
+
+		int left = BuildSurfaceBVHNodes(leafBoxes, order, begin, middle, nodes);
+		int right = BuildSurfaceBVHNodes(leafBoxes, order, middle, end, nodes);
+		LN_BVHNode& node = nodes[index];
+		node.Left = left;
+		node.Right = right;
+		for (int k = 0; k < 3; k++)
+		{
+			node.Min[k] = std::min(nodes[left].Min[k], nodes[right].Min[k]);
+			node.Max[k] = std::max(nodes[left].Max[k], nodes[right].Max[k]);
+		}
+		return index;
+	}
+
+	/// <summary>
+	/// Newton iterations on the gradient of |S(s, t) - P|^2 / 2 over a flat Bezier piece, from seed or, when seed is negative,
+	/// from the projection of P onto the corner edges. Steps are clamped to [0, 1] x [0, 1]; a clamped coordinate lets the other one
+	/// continue as a one-dimensional Newton step along the border. Returns the local parameters and the distance of their point to P.
+	/// </summary>
+	UV ProjectOnBezierPatch(const LN_CheckedNurbsSurface& checkedPatch, const XYZ& point, UV seed, double& distance)
+	{
+		const LN_ArrayView<std::vector<XYZW>>& controlPoints = checkedPatch.GetSurface().ControlPoints;
+		int lastU = controlPoints.size() - 1;
+		int lastV = controlPoints[0].size() - 1;
+		XYZ corners[4] = {
+			controlPoints[0][0].ToXYZ(checkedPatch.IsRational()),
+			controlPoints[lastU][0].ToXYZ(checkedPatch.IsRational()),
+			controlPoints[0][lastV].ToXYZ(checkedPatch.IsRational()),
+			controlPoints[lastU][lastV].ToXYZ(checkedPatch.IsRational()) };
+		const UV cornerParams[4] = { UV(0, 0), UV(1, 0), UV(0, 1), UV(1, 1) };
+
+		double s = seed[0];
+		double t = seed[1];
+		if (s < 0.0 || t < 0.0)
+		{
+			XYZ edgeU = corners[1] - corners[0];
+			XYZ edgeV = corners[2] - corners[0];
+			double lengthU = edgeU.DotProduct(edgeU);
+			double lengthV = edgeV.DotProduct(edgeV);
+			s = lengthU == 0.0 ? 0.5 : std::min(std::max((point - corners[0]).DotProduct(edgeU) / lengthU, 0.0), 1.0);
+			t = lengthV == 0.0 ? 0.5 : std::min(std::max((point - corners[0]).DotProduct(edgeV) / lengthV, 0.0), 1.0);
+		}
+
+		const int maxIterations = 20;
+		for (int i = 0; i < maxIterations; i++)
+		{
+			std::vector<std::vector<XYZ>> derivatives = NurbsSurface::ComputeRationalSurfaceDerivatives(checkedPatch, 2, UV(s, t));
+			const XYZ& Su = derivatives[1][0];
+			const XYZ& Sv = derivatives[0][1];
+			XYZ difference = derivatives[0][0] - point;
+			double f = Su.DotProduct(difference);
+			double g = Sv.DotProduct(difference);
+			double a11 = Su.DotProduct(Su) + difference.DotProduct(derivatives[2][0]);
+			double a12 = Su.DotProduct(Sv) + difference.DotProduct(derivatives[1][1]);
+			double a22 = Sv.DotProduct(Sv) + difference.DotProduct(derivatives[0][2]);
+			if (a11 <= 0.0 || a11 * a22 - a12 * a12 <= 0.0)
+			{
+				// Away from a minimum the Hessian may be indefinite; Gauss-Newton still descends.
+				a11 = Su.DotProduct(Su);
+				a12 = Su.DotProduct(Sv);
+				a22 = Sv.DotProduct(Sv);
+			}
+			// The determinant scales with the fourth power of the surface size, so singularity is judged relative to a11 * a22.
+			double determinant = a11 * a22 - a12 * a12;
+			if (abs(determinant) <= Constants::DoubleEpsilon * abs(a11 * a22))
+			{
+				break;
+			}
+
+			double nextS = s - (a22 * f - a12 * g) / determinant;
+			double nextT = t - (a11 * g - a12 * f) / determinant;
+			bool isClampedS = nextS < 0.0 || nextS > 1.0;
+			bool isClampedT = nextT < 0.0 || nextT > 1.0;
+			if (isClampedS && !isClampedT && a22 > 0.0)
+			{
+				nextT = t - g / a22;
+			}
+			else if (isClampedT && !isClampedS && a11 > 0.0)
+			{
+				nextS = s - f / a11;
+			}
+			nextS = std::min(std::max(nextS, 0.0), 1.0);
+			nextT = std::min(std::max(nextT, 0.0), 1.0);
+			bool isConverged = abs(nextS - s) + abs(nextT - t) < Constants::DoubleEpsilon;
+			s = nextS;
+			t = nextT;
+			if (isConverged)
+			{
+				break;
+			}
+		}
+
+		UV param = UV(s, t);
+		distance = NurbsSurface::GetPointOnSurface(checkedPatch, param).Distance(point);
+		for (int i = 0; i < 4; i++)
+		{
+			if (corners[i].Distance(point) < distance)
+			{
+				distance = corners[i].Distance(point);
+				param = cornerParams[i];
+			}
+		}
+		return param;
+	}
+
+	/// <summary>
+	/// Closest point query on a surface BVH. leaf and local carry the piece and local parameters of a previous answer in and the new answer out;
+	/// with leaf >= 0 that piece is projected first, so a nearby previous point bounds the search from the start.
+	/// </summary>
+	double QuerySurfaceBVH(const LN_SurfaceBVH& bvh, const XYZ& point, int& leaf, UV& local)
+	{
+		double minDistance = Constants::MaxDistance;
+		if (leaf >= 0)
+		{
+			local = ProjectOnBezierPatch(bvh.CheckedLeaves[leaf], point, local, minDistance);
+		}
+
+		// Nearest box first; once the nearest remaining box is farther than the best point found, no piece inside can be closer.
+		typedef std::pair<double, int> Candidate;
+		std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+		candidates.push(Candidate(Projection::DistanceToBox(bvh.Nodes[0].Min, bvh.Nodes[0].Max, point), 0));
+		int warmLeaf = leaf;
+		while (!candidates.empty() && candidates.top().first < minDistance)
+		{
+			const LN_BVHNode& node = bvh.Nodes[candidates.top().second];
+			candidates.pop();
+			if (node.Leaf >= 0)
+			{
+				if (node.Leaf == warmLeaf)
+				{
+					continue;
+				}
+				double distance = 0.0;
+				UV candidate = ProjectOnBezierPatch(bvh.CheckedLeaves[node.Leaf], point, UV(-1, -1), distance);
+				if (distance < minDistance)
+				{
+					minDistance = distance;
+					leaf = node.Leaf;
+					local = candidate;
+				}
+				continue;
+			}
+			candidates.push(Candidate(Projection::DistanceToBox(bvh.Nodes[node.Left].Min, bvh.Nodes[node.Left].Max, point), node.Left));
+			candidates.push(Candidate(Projection::DistanceToBox(bvh.Nodes[node.Right].Min, bvh.Nodes[node.Right].Max, point), node.Right));
+		}
+		return minDistance;
+	}
+
+	/// <summary>
+	/// Points per batch projection block. Fixed, so the warm starts, the partial sums and hence the results do not depend on the thread count.
+	/// </summary>
+	const int ProjectionBlockSize = 256;
+
+	/// <summary>
+	/// Partial sums of one block of signed distances, merged in block order.
+	/// </summary>
+	struct DeviationSums
+	{
+		double Min;
+		double Max;
+		double AbsoluteSum;
+		double SignedSum;
+		double SquareSum;
+	};
+
+	UV ToSurfaceParam(const LN_SurfaceBVH& bvh, int leaf, const UV& local)
+	{
+		const double* params = &bvh.LeafParams[4 * leaf];
+		return UV(params[0] + local[0] * (params[1] - params[0]), params[2] + local[1] * (params[3] - params[2]));
+	}
+
+	/// <summary>
+	/// Rows of uParams per grid block: one block when sequential, otherwise a few blocks per thread so uneven rows balance out.
+	/// </summary>
+	int GetGridBlockSize(int uCount, const LN_ExecutionPolicy& policy)
+	{
+		int threadCount = ParallelUtils::GetThreadCount(policy);
+		int blocks = threadCount == 1 ? 1 : 4 * threadCount;
+		return std::max(1, (uCount + blocks - 1) / blocks);
+	}
+
 	std::vector<int> GetIndex(int size)
 	{
 		std::vector<int> ind(2 * (size - 1) + 2);
@@ -88,13 +986,13 @@ namespace LNLib
 	}
 }
 
-void  LNLib::NurbsSurface::Check(const LN_NurbsSurface& surface)
+LNLib::LN_CheckedNurbsSurface LNLib::NurbsSurface::Check(const LN_NurbsSurface& surface)
 {
 	int degreeU = surface.DegreeU;
 	int degreeV = surface.DegreeV;
-	std::vector<double> knotVectorU = surface.KnotVectorU;
-	std::vector<double> knotVectorV = surface.KnotVectorV;
-	std::vector<std::vector<XYZW>> controlPoints = surface.ControlPoints;
+	const std::vector<double>& knotVectorU = surface.KnotVectorU;
+	const std::vector<double>& knotVectorV = surface.KnotVectorV;
+	const std::vector<std::vector<XYZW>>& controlPoints = surface.ControlPoints;
 
 	VALIDATE_ARGUMENT(degreeU > 0, "degreeU", "Degree must greater than zero.");
 	VALIDATE_ARGUMENT(degreeV > 0, "degreeU", "Degree must greater than zero.");
@@ -105,170 +1003,361 @@ void  LNLib::NurbsSurface::Check(const LN_NurbsSurface& surface)
 	VALIDATE_ARGUMENT(controlPoints.size() > 0, "controlPoints", "ControlPoints must contains one point at least.");
 	VALIDATE_ARGUMENT(ValidationUtils::IsValidNurbs(degreeU, knotVectorU.size(), controlPoints.size()), "controlPoints", "Arguments must fit: m = n + p + 1");
 	VALIDATE_ARGUMENT(ValidationUtils::IsValidNurbs(degreeV, knotVectorV.size(), controlPoints[0].size()), "controlPoints", "Arguments must fit: m = n + p + 1");
+
+	return LN_CheckedNurbsSurface(surface, ControlPointsUtils::IsRational(controlPoints));
 }
 
 LNLib::XYZ LNLib::NurbsSurface::GetPointOnSurface(const LN_NurbsSurface& surface, UV uv)
 {
-	int degreeU = surface.DegreeU;
-	int degreeV = surface.DegreeV;
-	std::vector<double> knotVectorU = surface.KnotVectorU;
-	std::vector<double> knotVectorV = surface.KnotVectorV;
-	std::vector<std::vector<XYZW>> controlPoints = surface.ControlPoints;
+	const std::vector<double>& knotVectorU = surface.KnotVectorU;
+	const std::vector<double>& knotVectorV = surface.KnotVectorV;
 
 	VALIDATE_ARGUMENT_RANGE(uv.GetU(), knotVectorU[0], knotVectorU[knotVectorU.size() - 1]);
 	VALIDATE_ARGUMENT_RANGE(uv.GetV(), knotVectorV[0], knotVectorV[knotVectorV.size() - 1]);
 
-	LN_BsplineSurface<XYZW> bsplineSurface;
-	bsplineSurface.DegreeU = degreeU;
-	bsplineSurface.DegreeV = degreeV;
-	bsplineSurface.KnotVectorU = knotVectorU;
-	bsplineSurface.KnotVectorV = knotVectorV;
-	bsplineSurface.ControlPoints = controlPoints;
+	LN_BsplineSurfaceView<XYZW> bsplineSurface(surface);
 
 	XYZW result = BsplineSurface::GetPointOnSurface(bsplineSurface, uv);
 	return result.ToXYZ(true);
 }
 
+LNLib::XYZ LNLib::NurbsSurface::GetPointOnSurface(const LN_CheckedNurbsSurface& surface, UV uv)
+{
+	const LN_ArrayView<double>& knotVectorU = surface.GetSurface().KnotVectorU;
+	const LN_ArrayView<double>& knotVectorV = surface.GetSurface().KnotVectorV;
+
+	VALIDATE_ARGUMENT_RANGE(uv.GetU(), knotVectorU[0], knotVectorU[knotVectorU.size() - 1]);
+	VALIDATE_ARGUMENT_RANGE(uv.GetV(), knotVectorV[0], knotVectorV[knotVectorV.size() - 1]);
+
+	XYZW result = BsplineSurface::GetPointOnSurfaceUnchecked(surface.GetSurface(), uv);
+	return result.ToXYZ(surface.IsRational());
+}
+
 
 std::vector<std::vector<LNLib::XYZ>> LNLib::NurbsSurface::ComputeRationalSurfaceDerivatives(const LN_NurbsSurface& surface, int derivative, UV uv)
 {
-	int degreeU = surface.DegreeU;
-	int degreeV = surface.DegreeV;
-	std::vector<double> knotVectorU = surface.KnotVectorU;
-	std::vector<double> knotVectorV = surface.KnotVectorV;
-	std::vector<std::vector<XYZW>> controlPoints = surface.ControlPoints;
+	const std::vector<double>& knotVectorU = surface.KnotVectorU;
+	const std::vector<double>& knotVectorV = surface.KnotVectorV;
 
 	VALIDATE_ARGUMENT(derivative > 0, "derivative", "derivative must greater than zero.");
 	VALIDATE_ARGUMENT_RANGE(uv.GetU(), knotVectorU[0], knotVectorU[knotVectorU.size() - 1]);
 	VALIDATE_ARGUMENT_RANGE(uv.GetV(), knotVectorV[0], knotVectorV[knotVectorV.size() - 1]);
 
-	std::vector<std::vector<XYZ>> derivatives(derivative + 1, std::vector<XYZ>(derivative + 1));
-
-	LN_BsplineSurface<XYZW> bsplineSurface;
-	bsplineSurface.DegreeU = degreeU;
-	bsplineSurface.DegreeV = degreeV;
-	bsplineSurface.KnotVectorU = knotVectorU;
-	bsplineSurface.KnotVectorV = knotVectorV;
-	bsplineSurface.ControlPoints = controlPoints;
+	LN_BsplineSurfaceView<XYZW> bsplineSurface(surface);
 
 	std::vector<std::vector<XYZW>> ders = BsplineSurface::ComputeDerivatives(bsplineSurface, derivative, uv);
-	std::vector<std::vector<XYZ>> Aders(derivative + 1, std::vector<XYZ>(derivative + 1));
-	std::vector<std::vector<double>> wders(derivative + 1, std::vector<double>(derivative + 1));
-	for (int i = 0; i < ders.size(); i++)
+	return ComputeRationalDerivativesKL(ders, derivative);
+}
+
+std::vector<std::vector<LNLib::XYZ>> LNLib::NurbsSurface::ComputeRationalSurfaceDerivatives(const LN_CheckedNurbsSurface& surface, int derivative, UV uv)
+{
+	const LN_ArrayView<double>& knotVectorU = surface.GetSurface().KnotVectorU;
+	const LN_ArrayView<double>& knotVectorV = surface.GetSurface().KnotVectorV;
+
+	VALIDATE_ARGUMENT(derivative > 0, "derivative", "derivative must greater than zero.");
+	VALIDATE_ARGUMENT(derivative <= surface.GetSurface().DegreeU && derivative <= surface.GetSurface().DegreeV, "derivative", "Derivative must not greater than degree.");
+	VALIDATE_ARGUMENT_RANGE(uv.GetU(), knotVectorU[0], knotVectorU[knotVectorU.size() - 1]);
+	VALIDATE_ARGUMENT_RANGE(uv.GetV(), knotVectorV[0], knotVectorV[knotVectorV.size() - 1]);
+
+	int n = derivative + 1;
+	LN_ScratchBuffer<16, XYZW> ders(n * n);
+	BsplineSurface::ComputeDerivativesUnchecked(surface.GetSurface(), derivative, uv, ders.Data());
+	LN_ScratchBuffer<16, XYZ> flat(n * n);
+	ComputeCheckedSurfaceDerivatives(surface, ders.Data(), derivative, flat.Data());
+
+	std::vector<std::vector<XYZ>> derivatives(n, std::vector<XYZ>(n));
+	for (int k = 0; k < n; k++)
 	{
-		for (int j = 0; j < ders[0].size(); j++)
+		for (int l = 0; l < n; l++)
 		{
-			Aders[i][j] = ders[i][j].ToXYZ(false);
-			wders[i][j] = ders[i][j].GetW();
+			derivatives[k][l] = flat[k * n + l];
 		}
 	}
+	return derivatives;
+}
 
-	for (int k = 0; k <= derivative; k++)
-	{
-		for (int l = 0; l <= derivative - k; l++)
-		{
-			XYZ v = Aders[k][l];
-			for (int j = 1; j <= l; j++)
-			{
-				v = v - MathUtils::Binomial(l, j) * wders[0][j] * derivatives[k][l - j];
-			}
+void LNLib::NurbsSurface::ComputeRationalSurfaceDerivatives(const LN_NurbsSurface& surface, int derivative, const std::vector<UV>& uvs, std::vector<XYZ>& derivatives)
+{
+	ComputeRationalSurfaceDerivatives(Check(surface), derivative, uvs, derivatives);
+}
 
-			for (int i = 1; i <= k; i++)
-			{
-				v = v - MathUtils::Binomial(k, i) * wders[i][0] * derivatives[k - i][l];
+void LNLib::NurbsSurface::ComputeRationalSurfaceDerivatives(const LN_CheckedNurbsSurface& surface, int derivative, const std::vector<UV>& uvs, std::vector<XYZ>& derivatives)
+{
+	const LN_ArrayView<double>& knotVectorU = surface.GetSurface().KnotVectorU;
+	const LN_ArrayView<double>& knotVectorV = surface.GetSurface().KnotVectorV;
 
-				XYZ v2 = XYZ(0, 0, 0);
-				for (int j = 1; j <= l; j++)
-				{
-					v2 = v2 + MathUtils::Binomial(l, j) * wders[i][j] * derivatives[k - i][l - j];
-				}
-				v = v - MathUtils::Binomial(k, i) * v2;
-			}
-			derivatives[k][l] = v / wders[0][0];
-		}
+	VALIDATE_ARGUMENT(derivative > 0, "derivative", "derivative must greater than zero.");
+	VALIDATE_ARGUMENT(derivative <= surface.GetSurface().DegreeU && derivative <= surface.GetSurface().DegreeV, "derivative", "Derivative must not greater than degree.");
+	for (int i = 0; i < uvs.size(); i++)
+	{
+		VALIDATE_ARGUMENT_RANGE(uvs[i].GetU(), knotVectorU[0], knotVectorU[knotVectorU.size() - 1]);
+		VALIDATE_ARGUMENT_RANGE(uvs[i].GetV(), knotVectorV[0], knotVectorV[knotVectorV.size() - 1]);
+	}
+
+	int n = derivative + 1;
+	LN_ScratchBuffer<16, XYZW> ders(n * n);
+	derivatives.resize(uvs.size() * n * n);
+	for (int i = 0; i < uvs.size(); i++)
+	{
+		BsplineSurface::ComputeDerivativesUnchecked(surface.GetSurface(), derivative, uvs[i], ders.Data());
+		ComputeCheckedSurfaceDerivatives(surface, ders.Data(), derivative, derivatives.data() + i * n * n);
 	}
-	return derivatives;
 }
 
 double LNLib::NurbsSurface::Curvature(const LN_NurbsSurface& surface, SurfaceCurvature curvature, UV uv)
 {
-	int degreeU = surface.DegreeU;
-	int degreeV = surface.DegreeV;
-	std::vector<double> knotVectorU = surface.KnotVectorU;
-	std::vector<double> knotVectorV = surface.KnotVectorV;
-	std::vector<std::vector<XYZW>> controlPoints = surface.ControlPoints;
+	const std::vector<double>& knotVectorU = surface.KnotVectorU;
+	const std::vector<double>& knotVectorV = surface.KnotVectorV;
 
 	VALIDATE_ARGUMENT_RANGE(uv.GetU(), knotVectorU[0], knotVectorU[knotVectorU.size() - 1]);
 	VALIDATE_ARGUMENT_RANGE(uv.GetV(), knotVectorV[0], knotVectorV[knotVectorV.size() - 1]);
 
 	std::vector<std::vector<XYZ>> ders = ComputeRationalSurfaceDerivatives(surface, 2, uv);
-	XYZ Suu = ders[2][0];
-	XYZ Svv = ders[0][2];
-	XYZ Suv = ders[1][1];
+	return CurvatureFromSurfaceDerivatives(ders, curvature);
+}
 
-	XYZ Su = ders[1][0];
-	XYZ Sv = ders[0][1];
-	XYZ normal = Normal(surface, uv);
+double LNLib::NurbsSurface::Curvature(const LN_CheckedNurbsSurface& surface, SurfaceCurvature curvature, UV uv)
+{
+	std::vector<std::vector<XYZ>> ders = ComputeRationalSurfaceDerivatives(surface, 2, uv);
+	return CurvatureFromSurfaceDerivatives(ders, curvature);
+}
 
-	double L = Suu.DotProduct(normal);
-	double M = Suv.DotProduct(normal);
-	double N = Svv.DotProduct(normal);
+LNLib::XYZ LNLib::NurbsSurface::Normal(const LN_NurbsSurface& surface, UV uv)
+{
+	const std::vector<double>& knotVectorU = surface.KnotVectorU;
+	const std::vector<double>& knotVectorV = surface.KnotVectorV;
 
-	double E = Su.DotProduct(Su);
-	double F = Su.DotProduct(Sv);
-	double G = Sv.DotProduct(Sv);
+	VALIDATE_ARGUMENT_RANGE(uv.GetU(), knotVectorU[0], knotVectorU[knotVectorU.size() - 1]);
+	VALIDATE_ARGUMENT_RANGE(uv.GetV(), knotVectorV[0], knotVectorV[knotVectorV.size() - 1]);
 
-	double denominator = E * G - F * F;
-	if (MathUtils::IsAlmostEqualTo(denominator, 0.0))
+	std::vector<std::vector<XYZ>> derivatives = ComputeRationalSurfaceDerivatives(surface, 1, uv);
+	return derivatives[1][0].Normalize().CrossProduct(derivatives[0][1]).Normalize();
+}
+
+LNLib::XYZ LNLib::NurbsSurface::Normal(const LN_CheckedNurbsSurface& surface, UV uv)
+{
+	std::vector<std::vector<XYZ>> derivatives = ComputeRationalSurfaceDerivatives(surface, 1, uv);
+	return derivatives[1][0].Normalize().CrossProduct(derivatives[0][1]).Normalize();
+}
+
+void LNLib::NurbsSurface::EvaluateGrid(const LN_NurbsSurface& surface, const std::vector<double>& uParams, const std::vector<double>& vParams, std::vector<XYZ>& points, const LN_ExecutionPolicy& policy)
+{
+	EvaluateGrid(Check(surface), uParams, vParams, points, policy);
+}
+
+void LNLib::NurbsSurface::EvaluateGrid(const LN_NurbsSurface& surface, const std::vector<double>& uParams, const std::vector<double>& vParams, std::vector<XYZ>& points, std::vector<XYZ>& normals, const LN_ExecutionPolicy& policy)
+{
+	EvaluateGrid(Check(surface), uParams, vParams, points, normals, policy);
+}
+
+void LNLib::NurbsSurface::EvaluateGrid(const LN_CheckedNurbsSurface& surface, const std::vector<double>& uParams, const std::vector<double>& vParams, std::vector<XYZ>& points, const LN_ExecutionPolicy& policy)
+{
+	const LN_ArrayView<double>& knotVectorU = surface.GetSurface().KnotVectorU;
+	const LN_ArrayView<double>& knotVectorV = surface.GetSurface().KnotVectorV;
+	for (int i = 0; i < uParams.size(); i++)
 	{
-		return 0.0;
+		VALIDATE_ARGUMENT_RANGE(uParams[i], knotVectorU[0], knotVectorU[knotVectorU.size() - 1]);
 	}
+	for (int j = 0; j < vParams.size(); j++)
+	{
+		VALIDATE_ARGUMENT_RANGE(vParams[j], knotVectorV[0], knotVectorV[knotVectorV.size() - 1]);
+	}
+
+	int uCount = uParams.size();
+	int vCount = vParams.size();
+	points.resize(uCount * vCount);
+
+	int blockSize = GetGridBlockSize(uCount, policy);
+	int blockCount = (uCount + blockSize - 1) / blockSize;
+	ParallelUtils::For(blockCount, policy, [&](int block)
+	{
+		int first = block * blockSize;
+		int rows = std::min(blockSize, uCount - first);
 
-	double K = (L * N - M * M) / denominator;
-	double H = (E * N + G * L - 2 * F * M) / (2 * denominator);
-	double k1 = H + sqrt(abs(H * H - K));
-	double k2 = H - sqrt(abs(H * H - K));
+		std::vector<XYZW> weightPoints(rows * vCount);
+		BsplineSurface::EvaluateGridUnchecked(surface.GetSurface(), 0, LN_ArrayView<double>(uParams.data() + first, rows), LN_ArrayView<double>(vParams), weightPoints.data());
+		for (int i = 0; i < rows * vCount; i++)
+		{
+			points[first * vCount + i] = weightPoints[i].ToXYZ(surface.IsRational());
+		}
+	});
+}
 
-	if (curvature == SurfaceCurvature::Gauss)
+void LNLib::NurbsSurface::EvaluateGrid(const LN_CheckedNurbsSurface& surface, const std::vector<double>& uParams, const std::vector<double>& vParams, std::vector<XYZ>& points, std::vector<XYZ>& normals, const LN_ExecutionPolicy& policy)
+{
+	const LN_ArrayView<double>& knotVectorU = surface.GetSurface().KnotVectorU;
+	const LN_ArrayView<double>& knotVectorV = surface.GetSurface().KnotVectorV;
+	for (int i = 0; i < uParams.size(); i++)
 	{
-		return K;
+		VALIDATE_ARGUMENT_RANGE(uParams[i], knotVectorU[0], knotVectorU[knotVectorU.size() - 1]);
 	}
-	else if (curvature == SurfaceCurvature::Mean)
+	for (int j = 0; j < vParams.size(); j++)
 	{
-		return H;
+		VALIDATE_ARGUMENT_RANGE(vParams[j], knotVectorV[0], knotVectorV[knotVectorV.size() - 1]);
 	}
-	else if (curvature == SurfaceCurvature::Maximum)
+
+	int uCount = uParams.size();
+	int vCount = vParams.size();
+	points.resize(uCount * vCount);
+	normals.resize(uCount * vCount);
+
+	int blockSize = GetGridBlockSize(uCount, policy);
+	int blockCount = (uCount + blockSize - 1) / blockSize;
+	ParallelUtils::For(blockCount, policy, [&](int block)
 	{
-		return k1;
+		int first = block * blockSize;
+		int rows = std::min(blockSize, uCount - first);
+
+		std::vector<XYZW> ders(rows * vCount * 4);
+		BsplineSurface::EvaluateGridUnchecked(surface.GetSurface(), 1, LN_ArrayView<double>(uParams.data() + first, rows), LN_ArrayView<double>(vParams), ders.data());
+		for (int i = 0; i < rows * vCount; i++)
+		{
+			XYZW* SKL = ders.data() + i * 4;
+			double w = SKL[0].GetW();
+			XYZ S = SKL[0].ToXYZ(false) / w;
+			XYZ Su = (SKL[2].ToXYZ(false) - SKL[2].GetW() * S) / w;
+			XYZ Sv = (SKL[1].ToXYZ(false) - SKL[1].GetW() * S) / w;
+			points[first * vCount + i] = S;
+			normals[first * vCount + i] = Su.Normalize().CrossProduct(Sv).Normalize();
+		}
+	});
+}
+
+LNLib::LN_CompiledNurbsSurface LNLib::NurbsSurface::Compile(const LN_NurbsSurface& surface)
+{
+	Check(surface);
+
+	LN_CompiledNurbsSurface compiled;
+	compiled.m_degreeU = surface.DegreeU;
+	compiled.m_degreeV = surface.DegreeV;
+	compiled.m_knotVectorU = surface.KnotVectorU;
+	compiled.m_knotVectorV = surface.KnotVectorV;
+	compiled.m_rows = surface.ControlPoints.size();
+	compiled.m_columns = surface.ControlPoints[0].size();
+
+	int size = compiled.m_rows * compiled.m_columns;
+	compiled.m_x.resize(size);
+	compiled.m_y.resize(size);
+	compiled.m_z.resize(size);
+	compiled.m_w.resize(size);
+	for (int i = 0; i < compiled.m_rows; i++)
+	{
+		for (int j = 0; j < compiled.m_columns; j++)
+		{
+			const XYZW& point = surface.ControlPoints[i][j];
+			int index = i * compiled.m_columns + j;
+			compiled.m_x[index] = point.GetWX();
+			compiled.m_y[index] = point.GetWY();
+			compiled.m_z[index] = point.GetWZ();
+			compiled.m_w[index] = point.GetW();
+		}
 	}
-	else if (curvature == SurfaceCurvature::Minimum)
+	return compiled;
+}
+
+void LNLib::NurbsSurface::EvaluateGrid(const LN_CompiledNurbsSurface& surface, const std::vector<double>& uParams, const std::vector<double>& vParams, std::vector<XYZ>& points)
+{
+	const std::vector<double>& knotVectorU = surface.GetKnotVectorU();
+	const std::vector<double>& knotVectorV = surface.GetKnotVectorV();
+	for (int i = 0; i < uParams.size(); i++)
 	{
-		return k2;
+		VALIDATE_ARGUMENT_RANGE(uParams[i], knotVectorU[0], knotVectorU[knotVectorU.size() - 1]);
 	}
-	else if (curvature == SurfaceCurvature::Abs)
+	for (int j = 0; j < vParams.size(); j++)
 	{
-		return abs(k1) + abs(k2);
+		VALIDATE_ARGUMENT_RANGE(vParams[j], knotVectorV[0], knotVectorV[knotVectorV.size() - 1]);
 	}
-	else if (curvature == SurfaceCurvature::Rms)
+
+	points.resize(uParams.size() * vParams.size());
+	SimdKernels::EvaluateGrid(surface, uParams.data(), uParams.size(), vParams.data(), vParams.size(), points.data());
+}
+
+LNLib::LN_PowerBasisSurface LNLib::NurbsSurface::ToPowerBasis(const LN_NurbsSurface& surface)
+{
+	Check(surface);
+
+	int degreeU = surface.DegreeU;
+	int degreeV = surface.DegreeV;
+	std::vector<LN_NurbsSurface> bezierPatches = DecomposeToBeziers(surface);
+	std::vector<std::vector<double>> matrixU = Polynomials::BezierToPowerMatrix(degreeU);
+	std::vector<std::vector<double>> matrixV = Polynomials::BezierToPowerMatrix(degreeV);
+	std::vector<std::vector<double>> matrixVT;
+	MathUtils::Transpose(matrixV, matrixVT);
+
+	LN_PowerBasisSurface powerBasis;
+	powerBasis.DegreeU = degreeU;
+	powerBasis.DegreeV = degreeV;
+	powerBasis.KnotsU = KnotVectorUtils::GetBreakpoints(degreeU, surface.KnotVectorU);
+	powerBasis.KnotsV = KnotVectorUtils::GetBreakpoints(degreeV, surface.KnotVectorV);
+	powerBasis.Coefficients.resize(bezierPatches.size());
+	for (int i = 0; i < bezierPatches.size(); i++)
+	{
+		std::vector<std::vector<XYZW>> temp = ControlPointsUtils::Multiply(matrixU, bezierPatches[i].ControlPoints);
+		powerBasis.Coefficients[i] = ControlPointsUtils::Multiply(temp, matrixVT);
+	}
+	return powerBasis;
+}
+
+LNLib::XYZ LNLib::NurbsSurface::GetPointOnSurface(const LN_PowerBasisSurface& surface, UV uv)
+{
+	const std::vector<double>& knotsU = surface.KnotsU;
+	const std::vector<double>& knotsV = surface.KnotsV;
+	VALIDATE_ARGUMENT_RANGE(uv.GetU(), knotsU[0], knotsU[knotsU.size() - 1]);
+	VALIDATE_ARGUMENT_RANGE(uv.GetV(), knotsV[0], knotsV[knotsV.size() - 1]);
+
+	int spanU = Polynomials::GetKnotSpanIndexUnchecked(0, LN_ArrayView<double>(knotsU), uv.GetU());
+	int spanV = Polynomials::GetKnotSpanIndexUnchecked(0, LN_ArrayView<double>(knotsV), uv.GetV());
+	double s = (uv.GetU() - knotsU[spanU]) / (knotsU[spanU + 1] - knotsU[spanU]);
+	double t = (uv.GetV() - knotsV[spanV]) / (knotsV[spanV + 1] - knotsV[spanV]);
+
+	int degreeU = surface.DegreeU;
+	int degreeV = surface.DegreeV;
+	const std::vector<std::vector<XYZW>>& coefficients = surface.Coefficients[spanU * (knotsV.size() - 1) + spanV];
+	XYZW point = Polynomials::HornerUnchecked(degreeV, coefficients[degreeU].data(), t);
+	for (int i = degreeU - 1; i >= 0; i--)
 	{
-		return sqrt(k1 * k1 + k2 * k2);
+		point = point * s + Polynomials::HornerUnchecked(degreeV, coefficients[i].data(), t);
 	}
-	return 0.0;
+	return point.ToXYZ(true);
 }
 
-LNLib::XYZ LNLib::NurbsSurface::Normal(const LN_NurbsSurface& surface, UV uv)
+std::vector<std::vector<LNLib::XYZ>> LNLib::NurbsSurface::ComputeRationalSurfaceDerivatives(const LN_PowerBasisSurface& surface, int derivative, UV uv)
 {
+	const std::vector<double>& knotsU = surface.KnotsU;
+	const std::vector<double>& knotsV = surface.KnotsV;
+	VALIDATE_ARGUMENT(derivative > 0, "derivative", "derivative must greater than zero.");
+	VALIDATE_ARGUMENT_RANGE(uv.GetU(), knotsU[0], knotsU[knotsU.size() - 1]);
+	VALIDATE_ARGUMENT_RANGE(uv.GetV(), knotsV[0], knotsV[knotsV.size() - 1]);
+
+	int spanU = Polynomials::GetKnotSpanIndexUnchecked(0, LN_ArrayView<double>(knotsU), uv.GetU());
+	int spanV = Polynomials::GetKnotSpanIndexUnchecked(0, LN_ArrayView<double>(knotsV), uv.GetV());
+	double lengthU = knotsU[spanU + 1] - knotsU[spanU];
+	double lengthV = knotsV[spanV + 1] - knotsV[spanV];
+	double s = (uv.GetU() - knotsU[spanU]) / lengthU;
+	double t = (uv.GetV() - knotsV[spanV]) / lengthV;
+
 	int degreeU = surface.DegreeU;
 	int degreeV = surface.DegreeV;
-	std::vector<double> knotVectorU = surface.KnotVectorU;
-	std::vector<double> knotVectorV = surface.KnotVectorV;
-	std::vector<std::vector<XYZW>> controlPoints = surface.ControlPoints;
+	const std::vector<std::vector<XYZW>>& coefficients = surface.Coefficients[spanU * (knotsV.size() - 1) + spanV];
 
-	VALIDATE_ARGUMENT_RANGE(uv.GetU(), knotVectorU[0], knotVectorU[knotVectorU.size() - 1]);
-	VALIDATE_ARGUMENT_RANGE(uv.GetV(), knotVectorV[0], knotVectorV[knotVectorV.size() - 1]);
-
-	std::vector<std::vector<XYZ>> derivatives = ComputeRationalSurfaceDerivatives(surface, 1, uv);
-	return derivatives[1][0].Normalize().CrossProduct(derivatives[0][1]).Normalize();
+	std::vector<std::vector<XYZW>> ders(derivative + 1, std::vector<XYZW>(derivative + 1));
+	std::vector<XYZW> temp(degreeU + 1);
+	double scaleV = 1.0;
+	for (int l = 0; l <= derivative; l++)
+	{
+		for (int i = 0; i <= degreeU; i++)
+		{
+			temp[i] = Polynomials::HornerDerivativeUnchecked(degreeV, l, coefficients[i].data(), t);
+		}
+		double scale = scaleV;
+		for (int k = 0; k <= derivative - l; k++)
+		{
+			ders[k][l] = scale * Polynomials::HornerDerivativeUnchecked(degreeU, k, temp.data(), s);
+			scale /= lengthU;
+		}
+		scaleV /= lengthV;
+	}
+	return ComputeRationalDerivativesKL(ders, derivative);
 }
 
 void LNLib::NurbsSurface::Swap(const LN_NurbsSurface& surface, LN_NurbsSurface& result)
@@ -680,6 +1769,7 @@ std::vector<LNLib::LN_NurbsSurface> LNLib::NurbsSurface::DecomposeToBeziers(cons
 		}
 	}
 
+	tempBezierPatches.resize(nb);
 	std::vector<LNLib::LN_NurbsSurface> bezierPatches(tempBezierPatches.size() * (columns - degreeV));
 	for (int i = 0; i < bezierPatches.size(); i++)
 	{
@@ -691,7 +1781,7 @@ std::vector<LNLib::LN_NurbsSurface> LNLib::NurbsSurface::DecomposeToBeziers(cons
 	}
 
 	nb = 0;
-	for (int np = 0; np < nb; np++)
+	for (int np = 0; np < tempBezierPatches.size(); np++)
 	{
 		for (int i = 0; i <= degreeU; i++)
 		{
@@ -749,7 +1839,7 @@ std::vector<LNLib::LN_NurbsSurface> LNLib::NurbsSurface::DecomposeToBeziers(cons
 				{
 					for (int row = 0; row <= degreeU; row++)
 					{
-						bezierPatches[nb].ControlPoints[row][i] = bezierPatches[np].ControlPoints[row][b - degreeV + i];
+						bezierPatches[nb].ControlPoints[row][i] = tempBezierPatches[np].ControlPoints[row][b - degreeV + i];
 					}
 				}
 				a = b;
@@ -757,6 +1847,7 @@ std::vector<LNLib::LN_NurbsSurface> LNLib::NurbsSurface::DecomposeToBeziers(cons
 			}
 		}
 	}
+	bezierPatches.resize(nb);
 	return bezierPatches;
 }
 
@@ -961,11 +2052,16 @@ bool LNLib::NurbsSurface::ReduceDegree(const LN_NurbsSurface& surface, bool isUD
 
 void LNLib::NurbsSurface::EquallyTessellate(const LN_NurbsSurface& surface, std::vector<XYZ>& tessellatedPoints, std::vector<UV>& correspondingKnots)
 {
-	int degreeU = surface.DegreeU;
-	int degreeV = surface.DegreeV;
-	std::vector<double> knotVectorU = surface.KnotVectorU;
-	std::vector<double> knotVectorV = surface.KnotVectorV;
-	std::vector<std::vector<XYZW>> controlPoints = surface.ControlPoints;
+	SurfacePointsCollector collector(tessellatedPoints, correspondingKnots);
+	EquallyTessellate(surface, collector);
+}
+
+void LNLib::NurbsSurface::EquallyTessellate(const LN_NurbsSurface& surface, SurfaceTessellationSink& sink)
+{
+	const std::vector<double>& knotVectorU = surface.KnotVectorU;
+	const std::vector<double>& knotVectorV = surface.KnotVectorV;
+	const std::vector<std::vector<XYZW>>& controlPoints = surface.ControlPoints;
+	LN_CheckedNurbsSurface checkedSurface = Check(surface);
 
 	std::vector<double> uniqueKvU = knotVectorU;
 	uniqueKvU.erase(unique(uniqueKvU.begin(), uniqueKvU.end()), uniqueKvU.end());
@@ -975,8 +2071,23 @@ void LNLib::NurbsSurface::EquallyTessellate(const LN_NurbsSurface& surface, std:
 	uniqueKvV.erase(unique(uniqueKvV.begin(), uniqueKvV.end()), uniqueKvV.end());
 	int sizeV = uniqueKvV.size();
 
-	std::vector<double> tessellatedU;
 	int intervals = 100;
+	std::vector<double> tessellatedV;
+	for (int i = 0; i < sizeV - 1; i++)
+	{
+		double currentV = uniqueKvV[i];
+		double nextV = uniqueKvV[i + 1];
+		double stepV = (nextV - currentV) / intervals;
+		for (int j = 0; j < intervals; j++)
+		{
+			double v = currentV + stepV * j;
+			tessellatedV.emplace_back(v);
+		}
+	}
+
+	std::vector<double> tessellatedU(intervals);
+	std::vector<XYZ> points;
+	std::vector<UV> uvs(intervals * tessellatedV.size());
 	for (int i = 0; i < sizeU - 1; i++)
 	{
 		double currentU = uniqueKvU[i];
@@ -984,35 +2095,348 @@ void LNLib::NurbsSurface::EquallyTessellate(const LN_NurbsSurface& surface, std:
 		double stepU = (nextU - currentU) / intervals;
 		for (int j = 0; j < intervals; j++)
 		{
-			double u = currentU + stepU * j;
-			tessellatedU.emplace_back(u);
+			tessellatedU[j] = currentU + stepU * j;
+			for (int k = 0; k < tessellatedV.size(); k++)
+			{
+				uvs[j * tessellatedV.size() + k] = UV(tessellatedU[j], tessellatedV[k]);
+			}
 		}
+		EvaluateGrid(checkedSurface, tessellatedU, tessellatedV, points);
+		sink.AddVertices(points.data(), nullptr, uvs.data(), points.size());
 	}
-	std::vector<double> tessellatedV;
-	for (int i = 0; i < sizeV - 1; i++)
+
+	UV lastUV = UV(knotVectorU[knotVectorU.size() - 1], knotVectorV[knotVectorV.size() - 1]);
+	XYZ lastPoint = controlPoints[controlPoints.size() - 1][controlPoints[0].size() - 1].ToXYZ(true);
+	sink.AddVertices(&lastPoint, nullptr, &lastUV, 1);
+}
+
+void LNLib::NurbsSurface::AdaptiveTessellate(const LN_NurbsSurface& surface, const LN_TessellationTolerance& tolerance, LN_Mesh& mesh, const LN_ExecutionPolicy& policy)
+{
+	mesh = LN_Mesh();
+	MeshCollector collector(mesh);
+	AdaptiveTessellate(surface, tolerance, collector, policy);
+}
+
+void LNLib::NurbsSurface::AdaptiveTessellate(const LN_NurbsSurface& surface, const LN_TessellationTolerance& tolerance, SurfaceTessellationSink& sink, const LN_ExecutionPolicy& policy)
+{
+	VALIDATE_ARGUMENT(tolerance.ChordHeight > 0.0, "tolerance", "ChordHeight must greater than zero.");
+	VALIDATE_ARGUMENT(tolerance.AngleTolerance > 0.0, "tolerance", "AngleTolerance must greater than zero.");
+	VALIDATE_ARGUMENT(tolerance.MaxEdgeLength >= 0.0, "tolerance", "MaxEdgeLength must greater than or equals zero.");
+
+	LN_CheckedNurbsSurface checkedSurface = Check(surface);
+	std::vector<double> breakpointsU;
+	std::vector<double> breakpointsV;
+	std::vector<std::vector<double>> spanParams;
+	RefineSurfaceSpans(surface, tolerance, policy, breakpointsU, breakpointsV, spanParams);
+	int spansU = breakpointsU.size() - 1;
+	int spansV = breakpointsV.size() - 1;
+
+	std::vector<double> vParams(1, breakpointsV[0]);
+	for (int j = 0; j < spansV; j++)
+	{
+		AppendSpanParameters(breakpointsV, j, spanParams[spansU + j], vParams);
+	}
+
+	// Rows of vertices are evaluated and delivered one row of patches at a time.
+	// Rows are evaluated on the policy's threads, but each waits for its turn so the sink sees them in order;
+	// since rows are claimed in order, at most one row per thread is held in memory.
+	// Only the last row of the previous chunk is kept, to triangulate the cells between the two chunks.
+	int vCount = vParams.size();
+	std::vector<XYZ> previousRow;
+	int firstRow = 0;
+	int turn = 0;
+	bool aborted = false;
+	std::mutex turnMutex;
+	std::condition_variable turnChanged;
+	ParallelUtils::For(spansU, policy, [&](int i)
+	{
+		std::vector<double> rowParams;
+		std::vector<XYZ> points;
+		std::vector<XYZ> normals;
+		std::vector<UV> uvs;
+		std::vector<int> triangles;
+		try
+		{
+			if (i == 0)
+			{
+				rowParams.emplace_back(breakpointsU[0]);
+			}
+			AppendSpanParameters(breakpointsU, i, spanParams[i], rowParams);
+
+			int rows = rowParams.size();
+			EvaluateGrid(checkedSurface, rowParams, vParams, points, normals);
+			uvs.resize(rows * vCount);
+			for (int r = 0; r < rows; r++)
+			{
+				for (int j = 0; j < vCount; j++)
+				{
+					uvs[r * vCount + j] = UV(rowParams[r], vParams[j]);
+				}
+			}
+
+			std::unique_lock<std::mutex> lock(turnMutex);
+			turnChanged.wait(lock, [&]() { return turn == i || aborted; });
+			if (aborted)
+			{
+				return;
+			}
+			sink.AddVertices(points.data(), normals.data(), uvs.data(), points.size());
+
+			for (int r = 0; r < rows; r++)
+			{
+				int row = firstRow + r;
+				if (row == 0)
+				{
+					continue;
+				}
+				const XYZ* lower = r == 0 ? previousRow.data() : points.data() + (r - 1) * vCount;
+				const XYZ* upper = points.data() + r * vCount;
+				for (int j = 0; j < vCount - 1; j++)
+				{
+					int corners[4] = { (row - 1) * vCount + j, row * vCount + j, row * vCount + j + 1, (row - 1) * vCount + j + 1 };
+					const XYZ* positions[4] = { lower + j, upper + j, upper + j + 1, lower + j + 1 };
+					for (int k = 1; k <= 2; k++)
+					{
+						// Cells collapsed at poles or degenerate edges give zero area triangles, which are dropped.
+						if (IsDegenerateTriangle(*positions[0], *positions[k], *positions[k + 1]))
+						{
+							continue;
+						}
+						triangles.emplace_back(corners[0]);
+						triangles.emplace_back(corners[k]);
+						triangles.emplace_back(corners[k + 1]);
+					}
+				}
+			}
+			if (triangles.size() > 0)
+			{
+				sink.AddTriangles(triangles.data(), triangles.size() / 3);
+			}
+
+			previousRow.assign(points.end() - vCount, points.end());
+			firstRow += rows;
+			turn++;
+		}
+		catch (...)
+		{
+			// Later rows would wait forever for this one; release them before the exception reaches ParallelUtils::For.
+			std::lock_guard<std::mutex> lock(turnMutex);
+			aborted = true;
+			turnChanged.notify_all();
+			throw;
+		}
+		turnChanged.notify_all();
+	});
+}
+
+void LNLib::NurbsSurface::AdaptiveTessellate(const std::vector<LN_NurbsSurface>& surfaces, const std::vector<LN_TessellationTolerance>& tolerances, LN_Mesh& mesh, const LN_ExecutionPolicy& policy)
+{
+	VALIDATE_ARGUMENT(surfaces.size() > 0, "surfaces", "Surfaces must not be empty.");
+	VALIDATE_ARGUMENT(tolerances.size() == 1 || tolerances.size() == surfaces.size(), "tolerances", "Tolerances must hold one entry or one entry per surface.");
+
+	int surfaceCount = surfaces.size();
+	std::vector<LN_CheckedNurbsSurface> checkedSurfaces;
+	std::vector<std::vector<double>> uParams(surfaceCount);
+	std::vector<std::vector<double>> vParams(surfaceCount);
+	for (int s = 0; s < surfaceCount; s++)
+	{
+		const LN_TessellationTolerance& tolerance = tolerances[tolerances.size() == 1 ? 0 : s];
+		VALIDATE_ARGUMENT(tolerance.ChordHeight > 0.0, "tolerances", "ChordHeight must greater than zero.");
+		VALIDATE_ARGUMENT(tolerance.AngleTolerance > 0.0, "tolerances", "AngleTolerance must greater than zero.");
+		VALIDATE_ARGUMENT(tolerance.MaxEdgeLength >= 0.0, "tolerances", "MaxEdgeLength must greater than or equals zero.");
+
+		checkedSurfaces.emplace_back(Check(surfaces[s]));
+		std::vector<double> breakpointsU;
+		std::vector<double> breakpointsV;
+		std::vector<std::vector<double>> spanParams;
+		RefineSurfaceSpans(surfaces[s], tolerance, policy, breakpointsU, breakpointsV, spanParams);
+		int spansU = breakpointsU.size() - 1;
+		uParams[s].assign(1, breakpointsU[0]);
+		for (int i = 0; i < spansU; i++)
+		{
+			AppendSpanParameters(breakpointsU, i, spanParams[i], uParams[s]);
+		}
+		vParams[s].assign(1, breakpointsV[0]);
+		for (int j = 0; j < breakpointsV.size() - 1; j++)
+		{
+			AppendSpanParameters(breakpointsV, j, spanParams[spansU + j], vParams[s]);
+		}
+	}
+
+	// Side 4 * s + k is side k of surface s.
+	std::vector<BoundarySide> sides(4 * surfaceCount);
+	for (int s = 0; s < surfaceCount; s++)
 	{
-		double currentV = uniqueKvV[i];
-		double nextV = uniqueKvV[i + 1];
-		double stepV = (nextV - currentV) / intervals;
-		for (int j = 0; j < intervals; j++)
+		for (int k = 0; k < 4; k++)
 		{
-			double v = currentV + stepV * j;
-			tessellatedV.emplace_back(v);
+			BoundarySide& side = sides[4 * s + k];
+			side.Surface = s;
+			side.Side = k;
+			const std::vector<double>& knots = k % 2 == 0 ? surfaces[s].KnotVectorU : surfaces[s].KnotVectorV;
+			double first = knots[0];
+			double last = knots[knots.size() - 1];
+			for (int i = 0; i < BoundarySideSamples; i++)
+			{
+				double param = i == BoundarySideSamples - 1 ? last : first + (last - first) * i / (BoundarySideSamples - 1);
+				side.Params.emplace_back(param);
+				side.Samples.emplace_back(GetPointOnSurface(checkedSurfaces[s], GetSideUV(checkedSurfaces[s], k, param)));
+			}
+		}
+	}
+
+	// Each side is shared at most once, with the first matching side after it, so both sides of a closed surface match too.
+	std::vector<SharedBoundary> boundaries;
+	std::vector<int> sideBoundary(sides.size(), -1);
+	for (int a = 0; a < sides.size(); a++)
+	{
+		for (int b = a + 1; b < sides.size() && sideBoundary[a] < 0; b++)
+		{
+			bool isReversed = false;
+			if (sideBoundary[b] < 0 && IsSharedBoundary(sides[a], checkedSurfaces[sides[b].Surface], sides[b], isReversed))
+			{
+				SharedBoundary boundary;
+				boundary.First = a;
+				boundary.Second = b;
+				boundary.IsReversed = isReversed;
+				sideBoundary[a] = sideBoundary[b] = boundaries.size();
+				boundaries.emplace_back(boundary);
+			}
 		}
 	}
 
-	for (int i = 0; i < tessellatedU.size(); i++)
+	// A shared side gets the splits of both neighbours, so it meets the tighter tolerance.
+	// Splits move on through the opposite side of each surface, hence the repetition until nothing changes.
+	std::vector<std::vector<double>*> sideParams(sides.size());
+	for (int i = 0; i < sides.size(); i++)
+	{
+		sideParams[i] = sides[i].Side % 2 == 0 ? &uParams[sides[i].Surface] : &vParams[sides[i].Surface];
+	}
+	bool isChanged = true;
+	for (int pass = 0; pass <= boundaries.size() && isChanged; pass++)
+	{
+		isChanged = false;
+		for (int i = 0; i < boundaries.size(); i++)
+		{
+			const BoundarySide& first = sides[boundaries[i].First];
+			const BoundarySide& second = sides[boundaries[i].Second];
+			isChanged |= TransferBoundaryParameters(checkedSurfaces[first.Surface], first, *sideParams[boundaries[i].First], checkedSurfaces[second.Surface], second, *sideParams[boundaries[i].Second]);
+			isChanged |= TransferBoundaryParameters(checkedSurfaces[second.Surface], second, *sideParams[boundaries[i].Second], checkedSurfaces[first.Surface], first, *sideParams[boundaries[i].First]);
+		}
+	}
+	for (int i = 0; i < boundaries.size(); i++)
 	{
-		for (int j = 0; j < tessellatedV.size(); j++)
+		VALIDATE_ARGUMENT(sideParams[boundaries[i].First]->size() == sideParams[boundaries[i].Second]->size(), "surfaces", "Shared boundary sides could not be split alike, the mesh would not be watertight.");
+	}
+
+	// Vertices of a shared side are emitted by its first side only; the second side refers to them.
+	// Corners reached through different sides are joined, and every vertex is finally replaced by its root.
+	mesh = LN_Mesh();
+	std::vector<std::vector<int>> boundaryVertices(boundaries.size());
+	std::vector<int> roots;
+	std::vector<int> triangles;
+	std::vector<XYZ> points;
+	std::vector<XYZ> normals;
+	for (int s = 0; s < surfaceCount; s++)
+	{
+		int uCount = uParams[s].size();
+		int vCount = vParams[s].size();
+		EvaluateGrid(checkedSurfaces[s], uParams[s], vParams[s], points, normals, policy);
+		std::vector<int> indices(uCount * vCount, -1);
+		auto addVertex = [&](int gridIndex)
+		{
+			indices[gridIndex] = mesh.Vertices.size();
+			roots.emplace_back(mesh.Vertices.size());
+			mesh.Vertices.emplace_back(points[gridIndex]);
+			mesh.Normals.emplace_back(normals[gridIndex]);
+			mesh.UVs.emplace_back(UV(uParams[s][gridIndex / vCount], vParams[s][gridIndex % vCount]));
+		};
+
+		for (int k = 0; k < 4; k++)
+		{
+			int side = 4 * s + k;
+			int boundaryIndex = sideBoundary[side];
+			int count = k % 2 == 0 ? uCount : vCount;
+			if (boundaryIndex < 0)
+			{
+				continue;
+			}
+			const SharedBoundary& boundary = boundaries[boundaryIndex];
+			std::vector<int>& shared = boundaryVertices[boundaryIndex];
+			for (int i = 0; i < count; i++)
+			{
+				int gridIndex = GetSideGridIndex(k, i, uCount, vCount);
+				if (boundary.First == side)
+				{
+					if (indices[gridIndex] < 0)
+					{
+						addVertex(gridIndex);
+					}
+					shared.emplace_back(indices[gridIndex]);
+					continue;
+				}
+				int vertex = shared[boundary.IsReversed ? count - 1 - i : i];
+				if (indices[gridIndex] < 0)
+				{
+					indices[gridIndex] = vertex;
+				}
+				else
+				{
+					roots[FindVertexRoot(roots, indices[gridIndex])] = FindVertexRoot(roots, vertex);
+				}
+			}
+		}
+		for (int i = 0; i < indices.size(); i++)
+		{
+			if (indices[i] < 0)
+			{
+				addVertex(i);
+			}
+		}
+
+		for (int i = 1; i < uCount; i++)
 		{
-			UV uv = UV(tessellatedU[i], tessellatedV[j]);
-			correspondingKnots.emplace_back(uv);
-			tessellatedPoints.emplace_back(GetPointOnSurface(surface, uv));
+			for (int j = 0; j < vCount - 1; j++)
+			{
+				int corners[4] = { indices[(i - 1) * vCount + j], indices[i * vCount + j], indices[i * vCount + j + 1], indices[(i - 1) * vCount + j + 1] };
+				for (int k = 1; k <= 2; k++)
+				{
+					triangles.emplace_back(corners[0]);
+					triangles.emplace_back(corners[k]);
+					triangles.emplace_back(corners[k + 1]);
+				}
+			}
 		}
 	}
 
-	correspondingKnots.emplace_back(UV(knotVectorU[knotVectorU.size() - 1], knotVectorV[knotVectorV.size() - 1]));
-	tessellatedPoints.emplace_back(const_cast<XYZW&>(controlPoints[controlPoints.size() - 1][controlPoints[0].size() - 1]).ToXYZ(true));
+	std::vector<int> compacted(roots.size(), -1);
+	int vertexCount = 0;
+	for (int i = 0; i < roots.size(); i++)
+	{
+		if (FindVertexRoot(roots, i) == i)
+		{
+			mesh.Vertices[vertexCount] = mesh.Vertices[i];
+			mesh.Normals[vertexCount] = mesh.Normals[i];
+			mesh.UVs[vertexCount] = mesh.UVs[i];
+			compacted[i] = vertexCount++;
+		}
+	}
+	mesh.Vertices.resize(vertexCount);
+	mesh.Normals.resize(vertexCount);
+	mesh.UVs.resize(vertexCount);
+	for (int i = 0; i < triangles.size(); i += 3)
+	{
+		int a = compacted[FindVertexRoot(roots, triangles[i])];
+		int b = compacted[FindVertexRoot(roots, triangles[i + 1])];
+		int c = compacted[FindVertexRoot(roots, triangles[i + 2])];
+		// Cells collapsed at poles or degenerate edges give zero area triangles, which are dropped.
+		if (IsDegenerateTriangle(mesh.Vertices[a], mesh.Vertices[b], mesh.Vertices[c]))
+		{
+			continue;
+		}
+		mesh.Triangles.emplace_back(a);
+		mesh.Triangles.emplace_back(b);
+		mesh.Triangles.emplace_back(c);
+	}
 }
 
 bool LNLib::NurbsSurface::IsClosed(const LN_NurbsSurface& surface, bool isUDirection)
@@ -1060,174 +2484,176 @@ bool LNLib::NurbsSurface::IsClosed(const LN_NurbsSurface& surface, bool isUDirec
 
 LNLib::UV LNLib::NurbsSurface::GetParamOnSurface(const LN_NurbsSurface& surface, const XYZ& givenPoint)
 {
-	int degreeU = surface.DegreeU;
-	int degreeV = surface.DegreeV;
-	std::vector<double> knotVectorU = surface.KnotVectorU;
-	std::vector<double> knotVectorV = surface.KnotVectorV;
-	std::vector<std::vector<XYZW>> controlPoints = surface.ControlPoints;
-
-	double minValue = Constants::MaxDistance;
-
-	int maxIterations = 10;
-	UV param = UV(Constants::DoubleEpsilon, Constants::DoubleEpsilon);
-
-	double minUParam = knotVectorU[0];
-	double maxUParam = knotVectorU[knotVectorU.size() - 1];
-	double minVParam = knotVectorV[0];
-	double maxVParam = knotVectorV[knotVectorV.size() - 1];
-
-	double a = minUParam;
-	double b = maxUParam;
-	double c = minVParam;
-	double d = maxVParam;
-
-	bool isClosedU = IsClosed(surface, true);
-	bool isClosedV = IsClosed(surface, false);
-
-	std::vector<XYZ> tessellatedPoints;
-	std::vector<UV> correspondingKnots;
-	EquallyTessellate(surface, tessellatedPoints, correspondingKnots);
-	for (int i = 0; i < tessellatedPoints.size() - 1; i++)
-	{
-		UV currentUV = correspondingKnots[i];
-		UV nextUV = correspondingKnots[i + 1];
-
-		XYZ currentPoint = tessellatedPoints[i];
-		XYZ nextPoint = tessellatedPoints[i + 1];
-
-		XYZ vector1 = currentPoint - givenPoint;
-		XYZ vector2 = nextPoint - currentPoint;
-		double dot = vector1.DotProduct(vector2);
-
-		XYZ projectPoint;
-		UV project = UV(Constants::DoubleEpsilon, Constants::DoubleEpsilon);
+	return GetParamOnSurface(BuildBVH(surface), givenPoint);
+}
 
-		if (dot < 0)
-		{
-			projectPoint = currentPoint;
-			project = currentUV;
-		}
-		else if (dot > 1)
-		{
-			projectPoint = nextPoint;
-			project = nextUV;
-		}
-		else
+LNLib::LN_SurfaceBVH LNLib::NurbsSurface::BuildBVH(const LN_NurbsSurface& surface)
+{
+	Check(surface);
+	std::vector<double> breakpointsU = KnotVectorUtils::GetBreakpoints(surface.DegreeU, surface.KnotVectorU);
+	std::vector<double> breakpointsV = KnotVectorUtils::GetBreakpoints(surface.DegreeV, surface.KnotVectorV);
+	int spansU = breakpointsU.size() - 1;
+	int spansV = breakpointsV.size() - 1;
+	std::vector<LN_NurbsSurface> patches = DecomposeToBeziers(surface);
+	VALIDATE_ARGUMENT(patches.size() == spansU * spansV, "surface", "KnotVector must not contain almost equal distinct knots.");
+
+	LN_SurfaceBVH bvh;
+	std::vector<std::vector<std::vector<XYZW>>> leaves;
+	for (int i = 0; i < spansU; i++)
+	{
+		for (int j = 0; j < spansV; j++)
 		{
-			projectPoint = currentPoint + dot * vector1.Normalize();
-			project = currentUV + (nextUV - currentUV) * dot;
+			SubdivideToBVHLeaves(patches[i * spansV + j].ControlPoints, breakpointsU[i], breakpointsU[i + 1], breakpointsV[j], breakpointsV[j + 1], 0, 0, leaves, bvh.LeafParams);
 		}
+	}
 
-		double distance = (givenPoint - projectPoint).Length();
-		if (distance < minValue)
+	int count = leaves.size();
+	bvh.Leaves.resize(count);
+	std::vector<LN_BVHNode> leafBoxes(count);
+	std::vector<int> order(count);
+	for (int i = 0; i < count; i++)
+	{
+		LN_NurbsSurface& leaf = bvh.Leaves[i];
+		leaf.DegreeU = surface.DegreeU;
+		leaf.DegreeV = surface.DegreeV;
+		leaf.KnotVectorU = patches[0].KnotVectorU;
+		leaf.KnotVectorV = patches[0].KnotVectorV;
+		leaf.ControlPoints = leaves[i];
+
+		std::vector<std::vector<XYZ>> points = ControlPointsUtils::ToXYZ(leaves[i]);
+		LN_BVHNode& box = leafBoxes[i];
+		box.Min = points[0][0];
+		box.Max = points[0][0];
+		for (int r = 0; r < points.size(); r++)
 		{
-			minValue = distance;
-			param = project;
+			for (int c = 0; c < points[r].size(); c++)
+			{
+				for (int k = 0; k < 3; k++)
+				{
+					box.Min[k] = std::min(box.Min[k], points[r][c][k]);
+					box.Max[k] = std::max(box.Max[k], points[r][c][k]);
+				}
+			}
 		}
+		box.Leaf = i;
+		order[i] = i;
 	}
+	BuildSurfaceBVHNodes(leafBoxes, order, 0, count, bvh.Nodes);
 
-	int counters = 0;
-	while (counters < maxIterations)
+	// The leaves are final once the nodes are built; checking them here saves every query from validating them again.
+	for (int i = 0; i < count; i++)
 	{
-		std::vector<std::vector<XYZ>> derivatives = ComputeRationalSurfaceDerivatives(surface, 2, param);
-		XYZ difference = derivatives[0][0] - givenPoint;
-		double fa = derivatives[1][0].DotProduct(difference);
-		double fb = derivatives[0][1].DotProduct(difference);
-
-		double condition1 = difference.Length();
-		double condition2a = std::abs(fa / (derivatives[1][0].Length() * condition1));
-		double condition2b = std::abs(fb / (derivatives[0][1].Length() * condition1));
-
-		if (condition1 < Constants::DistanceEpsilon &&
-			condition2a < Constants::DistanceEpsilon &&
-			condition2b < Constants::DistanceEpsilon)
-		{
-			return param;
-		}
-
-		XYZ Su = derivatives[1][0];
-		XYZ Sv = derivatives[0][1];
-
-		XYZ Suu = derivatives[2][0];
-		XYZ Svv = derivatives[0][2];
+		bvh.CheckedLeaves.emplace_back(Check(bvh.Leaves[i]));
+	}
+	return bvh;
+}
 
-		XYZ Suv, Svu = derivatives[1][1];
+LNLib::UV LNLib::NurbsSurface::GetParamOnSurface(const LN_SurfaceBVH& bvh, const XYZ& givenPoint)
+{
+	VALIDATE_ARGUMENT(bvh.Nodes.size() > 0, "bvh", "BVH must be built by BuildBVH.");
 
-		double fuv = -Su.DotProduct(difference);
-		double guv = -Sv.DotProduct(difference);
+	int leaf = -1;
+	UV local;
+	QuerySurfaceBVH(bvh, givenPoint, leaf, local);
+	return ToSurfaceParam(bvh, leaf, local);
+}
 
-		double fu = Su.DotProduct(Su) + difference.DotProduct(Suu);
-		double fv = Su.DotProduct(Sv) + difference.DotProduct(Suv);
-		double gu = Su.DotProduct(Sv) + difference.DotProduct(Svu);
-		double gv = Sv.DotProduct(Sv) + difference.DotProduct(Svv);
+void LNLib::NurbsSurface::GetParamsOnSurface(const LN_NurbsSurface& surface, const std::vector<XYZ>& points, std::vector<UV>& params, std::vector<XYZ>& closestPoints, std::vector<double>& signedDistances, LN_DeviationStatistics& statistics, int histogramBinCount, const LN_ExecutionPolicy& policy)
+{
+	GetParamsOnSurface(BuildBVH(surface), points, params, closestPoints, signedDistances, statistics, histogramBinCount, policy);
+}
 
-		if (MathUtils::IsAlmostEqualTo(fu * gv, fv * gu))
+void LNLib::NurbsSurface::GetParamsOnSurface(const LN_SurfaceBVH& bvh, const std::vector<XYZ>& points, std::vector<UV>& params, std::vector<XYZ>& closestPoints, std::vector<double>& signedDistances, LN_DeviationStatistics& statistics, int histogramBinCount, const LN_ExecutionPolicy& policy)
+{
+	VALIDATE_ARGUMENT(bvh.Nodes.size() > 0, "bvh", "BVH must be built by BuildBVH.");
+	VALIDATE_ARGUMENT(histogramBinCount > 0, "histogramBinCount", "HistogramBinCount must greater than zero.");
+
+	int count = points.size();
+	params.resize(count);
+	closestPoints.resize(count);
+	signedDistances.resize(count);
+	int blocks = (count + ProjectionBlockSize - 1) / ProjectionBlockSize;
+	std::vector<DeviationSums> sums(blocks);
+	ParallelUtils::For(blocks, policy, [&](int block)
+	{
+		int leaf = -1;
+		UV local;
+		DeviationSums& sum = sums[block];
+		sum.Min = Constants::MaxDistance;
+		sum.Max = -Constants::MaxDistance;
+		sum.AbsoluteSum = 0.0;
+		sum.SignedSum = 0.0;
+		sum.SquareSum = 0.0;
+		int end = std::min(count, (block + 1) * ProjectionBlockSize);
+		for (int i = block * ProjectionBlockSize; i < end; i++)
 		{
-			counters++;
-			continue;
+			double distance = QuerySurfaceBVH(bvh, points[i], leaf, local);
+			std::vector<std::vector<XYZ>> derivatives = ComputeRationalSurfaceDerivatives(bvh.CheckedLeaves[leaf], 1, local);
+			XYZ normal = derivatives[1][0].CrossProduct(derivatives[0][1]);
+			double signedDistance = (points[i] - derivatives[0][0]).DotProduct(normal) < 0.0 ? -distance : distance;
+
+			params[i] = ToSurfaceParam(bvh, leaf, local);
+			closestPoints[i] = derivatives[0][0];
+			signedDistances[i] = signedDistance;
+			sum.Min = std::min(sum.Min, signedDistance);
+			sum.Max = std::max(sum.Max, signedDistance);
+			sum.AbsoluteSum += distance;
+			sum.SignedSum += signedDistance;
+			sum.SquareSum += distance * distance;
 		}
+	});
 
-		double deltaU = ((-fuv * gv) - fv * (-guv)) / (fu * gv - fv * gu);
-		double deltaV = (fu * (-guv) - (-fuv) * gu) / (fu * gv - fv * gu);
-
-		UV delta = UV(deltaU, deltaV);
-		UV temp = param + delta;
-
-		if (!isClosedU)
-		{
-			if (param[0] < a)
-			{
-				param = UV(a, param[1]);
-			}
-			if (param[0] > b)
-			{
-				param = UV(b, param[1]);
-			}
-		}
-		if (!isClosedV)
-		{
-			if (param[1] < c)
-			{
-				param = UV(param[0], c);
-			}
-			if (param[1] > d)
-			{
-				param = UV(param[0], d);
-			}
-		}
-		if (isClosedU)
+	statistics = LN_DeviationStatistics();
+	statistics.Count = count;
+	statistics.Histogram.assign(histogramBinCount, 0);
+	if (count == 0)
+	{
+		return;
+	}
+	double absoluteSum = 0.0;
+	double signedSum = 0.0;
+	double squareSum = 0.0;
+	statistics.MinSignedDistance = sums[0].Min;
+	statistics.MaxSignedDistance = sums[0].Max;
+	for (int b = 0; b < blocks; b++)
+	{
+		statistics.MinSignedDistance = std::min(statistics.MinSignedDistance, sums[b].Min);
+		statistics.MaxSignedDistance = std::max(statistics.MaxSignedDistance, sums[b].Max);
+		absoluteSum += sums[b].AbsoluteSum;
+		signedSum += sums[b].SignedSum;
+		squareSum += sums[b].SquareSum;
+	}
+	statistics.MaxAbsoluteDistance = std::max(std::abs(statistics.MinSignedDistance), std::abs(statistics.MaxSignedDistance));
+	statistics.MeanAbsoluteDistance = absoluteSum / count;
+	statistics.MeanSignedDistance = signedSum / count;
+	statistics.RMSDistance = sqrt(squareSum / count);
+	statistics.HistogramStart = statistics.MinSignedDistance;
+	statistics.HistogramBinWidth = (statistics.MaxSignedDistance - statistics.MinSignedDistance) / histogramBinCount;
+
+	// Per block histograms are added in block order, as the sums above.
+	std::vector<std::vector<int>> histograms(blocks);
+	ParallelUtils::For(blocks, policy, [&](int block)
+	{
+		std::vector<int>& histogram = histograms[block];
+		histogram.assign(histogramBinCount, 0);
+		int end = std::min(count, (block + 1) * ProjectionBlockSize);
+		for (int i = block * ProjectionBlockSize; i < end; i++)
 		{
-			if (param[0] < a)
-			{
-				param = UV(b - (a - param[0]), param[1]);
-			}
-			if (param[0] > b)
+			int bin = 0;
+			if (statistics.HistogramBinWidth > 0.0)
 			{
-				param = UV(a + (param[0] - b), param[1]);
+				bin = std::min(static_cast<int>((signedDistances[i] - statistics.HistogramStart) / statistics.HistogramBinWidth), histogramBinCount - 1);
 			}
+			histogram[bin]++;
 		}
-		if (isClosedV)
+	});
+	for (int b = 0; b < blocks; b++)
+	{
+		for (int k = 0; k < histogramBinCount; k++)
 		{
-			if (param[1] < c)
-			{
-				param = UV(param[0], d - (c - param[1]));
-			}
-			if (param[1] > d)
-			{
-				param = UV(param[0], c + (param[1] - d));
-			}
-		}
-
-		double condition4a = ((temp[0] - param[0]) * derivatives[1][0]).Length();
-		double condition4b = ((temp[1] - param[1]) * derivatives[0][1]).Length();
-		if (condition4a + condition4b < Constants::DistanceEpsilon) {
-			return param;
+			statistics.Histogram[k] += histograms[b][k];
 		}
-
-		param = temp;
-		counters++;
 	}
-	return param;
 }
 
 void LNLib::NurbsSurface::Reparametrize(const LN_NurbsSurface& surface, double minU, double maxU, double minV, double maxV, LN_NurbsSurface& result)
@@ -2775,7 +4201,7 @@ void LNLib::NurbsSurface::CreateCoonsSurface(const LN_NurbsCurve& curve0, const
 	surface.ControlPoints = controlPoints;
 }
 
-double LNLib::NurbsSurface::ApproximateArea(const LN_NurbsSurface& surface, IntegratorType type)
+double LNLib::NurbsSurface::ApproximateArea(const LN_NurbsSurface& surface, IntegratorType type, const LN_ExecutionPolicy& policy)
 {
 	LN_NurbsSurface reSurface;
 	Reparametrize(surface, 0.0, 1.0, 0.0, 1.0, reSurface);
@@ -2786,81 +4212,42 @@ double LNLib::NurbsSurface::ApproximateArea(const LN_NurbsSurface& surface, Inte
 	std::vector<double> knotVectorV = reSurface.KnotVectorV;
 	std::vector<std::vector<XYZW>> controlPoints = reSurface.ControlPoints;
 
-	double startU = knotVectorU[0];
-	double endU = knotVectorU[knotVectorU.size() - 1];
-	double startV = knotVectorV[0];
-	double endV = knotVectorV[knotVectorV.size() - 1];
-
 	double area = 0.0;
 	switch (type)
 	{
 		case IntegratorType::Simpson:
 		{
-			double halfV = (startV + endV) / 2.0;
-			XYZ halfStart = GetPointOnSurface(reSurface, UV(startU, halfV));
-			XYZ halfEnd = GetPointOnSurface(reSurface, UV(endU, halfV));
-			double totalWidth = halfStart.Distance(halfEnd);
-			int count = floor(totalWidth / Constants::DistanceEpsilon);
-
-			XYZ start1 = GetPointOnSurface(reSurface, UV(startU, startV));
-			XYZ start2 = GetPointOnSurface(reSurface, UV(startU, endV));
-			double startLength = start1.Distance(start2);
-
-			int size = (count / 2.0) + 1;
-			std::vector<double> odds;
-			std::vector<double> evens;
-
-			for (int i = 1; i < count; i++)
-			{
-				XYZ current = halfStart + (halfEnd - halfStart).Normalize() * Constants::DistanceEpsilon * i;
-				UV uv = GetParamOnSurface(reSurface, current);
-				XYZ point1 = GetPointOnSurface(reSurface, UV(uv.GetU(), startV));
-				XYZ point2 = GetPointOnSurface(reSurface, UV(uv.GetU(), endV));
-				double length = point1.Distance(point2);
-
-				if (i % 2 == 0)
-				{
-					evens.emplace_back(length);
-				}
-				else
-				{
-					odds.emplace_back(length);
-				}
-			}
-
-			XYZ end1 = GetPointOnSurface(reSurface, UV(endU, startV));
-			XYZ end2 = GetPointOnSurface(reSurface, UV(endU, endV));
-			double endLength = end1.Distance(end2);
-
-			area = Integrator::Simpson(startLength, endLength, odds, evens, Constants::DistanceEpsilon);
+			area = ApproximateArea(surface, LN_IntegrationTolerance(0.0, 1E-6), policy).Area;
 			break;
 		}
 		case IntegratorType::Gauss_Legendre:
 		{
 			std::vector<LN_NurbsSurface> bezierSurfaces = DecomposeToBeziers(reSurface);
-			for (int i = 0; i < bezierSurfaces.size(); i++)
+			std::vector<double> bezierAreas(bezierSurfaces.size());
+			ParallelUtils::For(bezierSurfaces.size(), policy, [&](int index)
 			{
-				LN_NurbsSurface bezierSurface = bezierSurfaces[i];
+				const LN_NurbsSurface& bezier = bezierSurfaces[index];
+				LN_CheckedNurbsSurface bezierSurface = Check(bezier);
 
-				std::vector<double> bKnotsU = bezierSurface.KnotVectorU;
+				const std::vector<double>& bKnotsU = bezier.KnotVectorU;
 				double a = bKnotsU[0];
 				double b = bKnotsU[bKnotsU.size() - 1];
 				double coefficient1 = (b - a) / 2.0;
 
-				std::vector<double> bKnotsV = bezierSurface.KnotVectorV;
+				const std::vector<double>& bKnotsV = bezier.KnotVectorV;
 				double c = bKnotsV[0];
 				double d = bKnotsV[bKnotsV.size() - 1];
 				double coefficient2 = (d - c) / 2.0;
 
 				double bArea = 0.0;
-				std::vector<double> abscissae = Integrator::GaussLegendreAbscissae;
+				const std::vector<double>& abscissae = Integrator::GaussLegendreAbscissae;
 				int size = abscissae.size();
 				for (int i = 0; i < size; i++)
 				{
 					double u = coefficient1 * abscissae[i] + (a + b) / 2.0;
 					for (int j = 0; j < size; j++)
 					{
-						double v = coefficient2 * abscissae[i] + (c + d) / 2.0;
+						double v = coefficient2 * abscissae[j] + (c + d) / 2.0;
 						std::vector<std::vector<XYZ>> derivatives = ComputeRationalSurfaceDerivatives(bezierSurface, 1, UV(u,v));
 						XYZ Su = derivatives[1][0];
 						XYZ Sv = derivatives[0][1];
@@ -2868,27 +4255,40 @@ double LNLib::NurbsSurface::ApproximateArea(const LN_NurbsSurface& surface, Inte
 						double F = Su.DotProduct(Sv);
 						double G = Sv.DotProduct(Sv);
 						double ds = sqrt(E * G - F * F);
-						bArea += Integrator::GaussLegendreWeights[i] * Integrator::GaussLegendreWeights[i] * ds;
+						bArea += Integrator::GaussLegendreWeights[i] * Integrator::GaussLegendreWeights[j] * ds;
 					}
 				}
-				bArea = coefficient1 * coefficient2 * bArea;
-				area += bArea;
+				bezierAreas[index] = coefficient1 * coefficient2 * bArea;
+			});
+			for (int i = 0; i < bezierAreas.size(); i++)
+			{
+				area += bezierAreas[i];
 			}
 			break;
 		}
 		case IntegratorType::Chebyshev:
 		{
-			std::vector<double> series = Integrator::ChebyshevSeries();
+			// The quadrature uses the low end of the series as scratch, so the weights handed to the inner integrals stay untouched.
+			static const std::vector<double> chebyshevSeries = Integrator::ChebyshevSeries();
+			std::vector<double> series = chebyshevSeries;
+			AreaData data(reSurface, chebyshevSeries);
+			AreaWrapperFunction function;
 			for (int i = degreeU; i < controlPoints.size(); i++) 
 			{
-				double a = knotVectorU[i];
-				double b = knotVectorU[i + 1];
+				data.CurrentKnotU = knotVectorU[i];
+				data.NextKnotU = knotVectorU[i + 1];
+				if (MathUtils::IsAlmostEqualTo(data.CurrentKnotU, data.NextKnotU))
+				{
+					continue;
+				}
 				for (int j = degreeV; j < controlPoints[0].size(); j++) 
 				{
-					double c = knotVectorV[i];
-					double d = knotVectorV[i + 1];
-					AreaData data(reSurface, series);
-					AreaWrapperFunction function;
+					double c = knotVectorV[j];
+					double d = knotVectorV[j + 1];
+					if (MathUtils::IsAlmostEqualTo(c, d))
+					{
+						continue;
+					}
 					area += Integrator::ClenshawCurtisQuadrature(function, (void*)&data, c, d, series);
 				}
 			}
@@ -2900,4 +4300,86 @@ double LNLib::NurbsSurface::ApproximateArea(const LN_NurbsSurface& surface, Inte
 	return area;
 }
 
+LNLib::LN_SurfaceArea LNLib::NurbsSurface::ApproximateArea(const LN_NurbsSurface& surface, const LN_IntegrationTolerance& tolerance, const LN_ExecutionPolicy& policy)
+{
+	Check(surface);
+	VALIDATE_ARGUMENT(tolerance.Absolute >= 0.0, "tolerance", "Absolute tolerance must greater than or equals zero.");
+	VALIDATE_ARGUMENT(tolerance.Relative >= 0.0, "tolerance", "Relative tolerance must greater than or equals zero.");
+	VALIDATE_ARGUMENT(tolerance.Absolute > 0.0 || tolerance.Relative > 0.0, "tolerance", "Absolute or relative tolerance must greater than zero.");
+	VALIDATE_ARGUMENT(policy.ThreadCount >= 0, "policy", "ThreadCount must greater than or equals zero.");
+
+	std::vector<double> breakpointsU = KnotVectorUtils::GetBreakpoints(surface.DegreeU, surface.KnotVectorU);
+	std::vector<double> breakpointsV = KnotVectorUtils::GetBreakpoints(surface.DegreeV, surface.KnotVectorV);
+	std::vector<LN_NurbsSurface> patches = DecomposeToBeziers(surface);
+
+	LN_SurfaceArea result;
+	result.PatchCountU = breakpointsU.size() - 1;
+	result.PatchCountV = breakpointsV.size() - 1;
+	VALIDATE_ARGUMENT(patches.size() == result.PatchCountU * result.PatchCountV, "surface", "KnotVectors must not contain almost equal distinct knots.");
+
+	int patchCount = patches.size();
+	double parameterArea = (breakpointsU[result.PatchCountU] - breakpointsU[0]) * (breakpointsV[result.PatchCountV] - breakpointsV[0]);
+	result.PatchAreas.resize(patchCount);
+	result.PatchErrors.resize(patchCount);
+	std::vector<int> evaluations(patchCount);
+	std::vector<char> isConverged(patchCount);
+	ParallelUtils::For(patchCount, policy, [&](int index)
+	{
+		int i = index / result.PatchCountV;
+		int j = index % result.PatchCountV;
+		double share = (breakpointsU[i + 1] - breakpointsU[i]) * (breakpointsV[j + 1] - breakpointsV[j]) / parameterArea;
+		LN_IntegrationTolerance patchTolerance(tolerance.Absolute * share, tolerance.Relative);
+
+		LN_CheckedNurbsSurface patch = Check(patches[index]);
+		std::function<void(const std::vector<double>&, const std::vector<double>&, std::vector<double>&)> areaElements;
+		std::vector<std::vector<XYZ>> controlPoints;
+		std::vector<UV> uvs;
+		std::vector<XYZ> derivatives;
+		if (!patch.IsRational())
+		{
+			controlPoints = ControlPointsUtils::ToXYZ(patches[index].ControlPoints);
+			areaElements = [&](const std::vector<double>& us, const std::vector<double>& vs, std::vector<double>& values)
+			{
+				EvaluatePolynomialAreaElements(controlPoints, us, vs, values);
+			};
+		}
+		else
+		{
+			areaElements = [&](const std::vector<double>& us, const std::vector<double>& vs, std::vector<double>& values)
+			{
+				uvs.clear();
+				for (int s = 0; s < us.size(); s++)
+				{
+					for (int t = 0; t < vs.size(); t++)
+					{
+						uvs.emplace_back(UV(us[s], vs[t]));
+					}
+				}
+				ComputeRationalSurfaceDerivatives(patch, 1, uvs, derivatives);
+				for (int k = 0; k < uvs.size(); k++)
+				{
+					const XYZ& Su = derivatives[(k * 2 + 1) * 2];
+					const XYZ& Sv = derivatives[k * 2 * 2 + 1];
+					values[k] = Su.CrossProduct(Sv).Length();
+				}
+			};
+		}
+
+		LN_IntegrationResult patchArea = Integrator::GaussKronrodCubature(areaElements, 0.0, 1.0, 0.0, 1.0, patchTolerance, MaxPatchAreaEvaluations);
+		result.PatchAreas[index] = patchArea.Value;
+		result.PatchErrors[index] = patchArea.Error;
+		evaluations[index] = patchArea.Evaluations;
+		isConverged[index] = patchArea.IsConverged;
+	});
+
+	for (int index = 0; index < patchCount; index++)
+	{
+		result.Area += result.PatchAreas[index];
+		result.Error += result.PatchErrors[index];
+		result.Evaluations += evaluations[index];
+		result.IsConverged = result.IsConverged && isConverged[index];
+	}
+	return result;
+}
+
 
@@ -9,6 +9,7 @@
  */
 
 #include "MathUtils.h"
+#include "LNLibExceptions.h"
 #include <limits>
 
 namespace LNLib
@@ -50,6 +51,31 @@ namespace LNLib
             }
         }
     }
+
+    struct PascalTriangle
+    {
+        double Values[(MathUtils::MaxBinomialNumber + 1) * (MathUtils::MaxBinomialNumber + 2) / 2];
+
+        PascalTriangle()
+        {
+            for (int n = 0; n <= MathUtils::MaxBinomialNumber; n++)
+            {
+                double* row = Values + n * (n + 1) / 2;
+                const double* previous = row - n;
+                row[0] = row[n] = 1.0;
+                for (int i = 1; i < n; i++)
+                {
+                    row[i] = previous[i - 1] + previous[i];
+                }
+            }
+        }
+    };
+
+    const PascalTriangle& GetPascalTriangle()
+    {
+        static const PascalTriangle triangle;
+        return triangle;
+    }
 }
 
 bool LNLib::MathUtils::IsAlmostEqualTo(double value1, double value2, double tolerance)
@@ -121,7 +147,22 @@ int LNLib::MathUtils::Factorial(int number)
 
 double LNLib::MathUtils::Binomial(int number, int i)
 {
-    return Factorial(number) / (Factorial(i) * Factorial(number - 1));
+    if (i < 0 || i > number)
+        return 0.0;
+    if (i > number - i)
+        i = number - i;
+    double result = 1.0;
+    for (int k = 1; k <= i; k++)
+    {
+        result = result * (number - i + k) / k;
+    }
+    return result;
+}
+
+const double* LNLib::MathUtils::BinomialRow(int number)
+{
+    VALIDATE_ARGUMENT_RANGE(number, 0, MaxBinomialNumber);
+    return GetPascalTriangle().Values + number * (number + 1) / 2;
 }
 
 double LNLib::MathUtils::ComputerCubicEquationsWithOneVariable(double cubic, double quadratic, double linear, double constant)
@@ -29,8 +29,8 @@ namespace LNLib
 		static void Check(const LN_BsplineCurve<T>& curve)
 		{
 			int degree = curve.Degree;
-			std::vector<double> knotVectors = curve.KnotVector;
-			std::vector<T> controlPoints = curve.ControlPoints;
+			const std::vector<double>& knotVector = curve.KnotVector;
+			const std::vector<T>& controlPoints = curve.ControlPoints;
 
 			VALIDATE_ARGUMENT(degree > 0, "degree", "Degree must greater than zero.");
 			VALIDATE_ARGUMENT(knotVector.size() > 0, "knotVector", "KnotVector size must greater than zero.");
@@ -47,15 +47,35 @@ namespace LNLib
 		template <typename T>
 		static T GetPointOnCurve(const LN_BsplineCurve<T>& curve, double paramT)
 		{
-			int degree = curve.Degree;
-			std::vector<double> knotVector = curve.KnotVector;
-			std::vector<T> controlPoints = curve.ControlPoints;
+			return GetPointOnCurve(LN_BsplineCurveView<T>(curve), paramT);
+		}
+
+		template <typename T>
+		static T GetPointOnCurve(const LN_BsplineCurveView<T>& curve, double paramT)
+		{
+			const LN_ArrayView<double>& knotVector = curve.KnotVector;
 
+			VALIDATE_ARGUMENT(knotVector.size() > 0, "knotVector", "KnotVector size must greater than zero.");
+			VALIDATE_ARGUMENT(ValidationUtils::IsValidKnotVector(knotVector), "knotVector", "KnotVector must be a nondecreasing sequence of real numbers.");
 			VALIDATE_ARGUMENT_RANGE(paramT, knotVector[0], knotVector[knotVector.size() - 1]);
 
+			return GetPointOnCurveUnchecked(curve, paramT);
+		}
+
+		/// <summary>
+		/// A3.1 without argument validation, for curves that already passed Check.
+		/// </summary>
+		template <typename T>
+		static T GetPointOnCurveUnchecked(const LN_BsplineCurveView<T>& curve, double paramT)
+		{
+			int degree = curve.Degree;
+			const LN_ArrayView<double>& knotVector = curve.KnotVector;
+			const LN_ArrayView<T>& controlPoints = curve.ControlPoints;
+
 			T point;
-			int spanIndex = Polynomials::GetKnotSpanIndex(degree, knotVector, paramT);
-			std::vector<double> N = Polynomials::BasisFunctions(spanIndex, degree, knotVector, paramT);
+			int spanIndex = Polynomials::GetKnotSpanIndexUnchecked(degree, knotVector, paramT);
+			LN_ScratchBuffer<Polynomials::MaxStackDegree + 1> N(degree + 1);
+			Polynomials::BasisFunctionsUnchecked(spanIndex, degree, knotVector, paramT, N.Data());
 
 			for (int i = 0; i <= degree; i++)
 			{
@@ -72,30 +92,124 @@ namespace LNLib
 		template<typename T>
 		static std::vector<T> ComputeDerivatives(const LN_BsplineCurve<T>& curve, int derivative, double paramT)
 		{
-			int degree = curve.Degree;
-			std::vector<double> knotVector = curve.KnotVector;
-			std::vector<T> controlPoints = curve.ControlPoints;
+			return ComputeDerivatives(LN_BsplineCurveView<T>(curve), derivative, paramT);
+		}
+
+		template<typename T>
+		static std::vector<T> ComputeDerivatives(const LN_BsplineCurveView<T>& curve, int derivative, double paramT)
+		{
+			const LN_ArrayView<double>& knotVector = curve.KnotVector;
 
 			VALIDATE_ARGUMENT(derivative > 0, "derivative", "derivative must greater than zero.");
+			VALIDATE_ARGUMENT(knotVector.size() > 0, "knotVector", "KnotVector size must greater than zero.");
+			VALIDATE_ARGUMENT(ValidationUtils::IsValidKnotVector(knotVector), "knotVector", "KnotVector must be a nondecreasing sequence of real numbers.");
 			VALIDATE_ARGUMENT_RANGE(paramT, knotVector[0], knotVector[knotVector.size() - 1]);				
 			
+			return ComputeDerivativesUnchecked(curve, derivative, paramT);
+		}
+
+		/// <summary>
+		/// A3.2 without argument validation, for curves that already passed Check.
+		/// </summary>
+		template<typename T>
+		static std::vector<T> ComputeDerivativesUnchecked(const LN_BsplineCurveView<T>& curve, int derivative, double paramT)
+		{
+			int degree = curve.Degree;
+			const LN_ArrayView<double>& knotVector = curve.KnotVector;
+			const LN_ArrayView<T>& controlPoints = curve.ControlPoints;
+
 			std::vector<T> derivatives(derivative + 1);
 
 			int du = std::min(derivative, degree);
-			int spanIndex = Polynomials::GetKnotSpanIndex(degree, knotVector, paramT);
-			std::vector<std::vector<double>> nders = 
-				Polynomials::BasisFunctionsDerivatives(spanIndex, degree, du, knotVector, paramT);
+			int spanIndex = Polynomials::GetKnotSpanIndexUnchecked(degree, knotVector, paramT);
+			LN_ScratchBuffer<(Polynomials::MaxStackDegree + 1) * (Polynomials::MaxStackDegree + 1)> nders((du + 1) * (degree + 1));
+			Polynomials::BasisFunctionsDerivativesUnchecked(spanIndex, degree, du, knotVector, paramT, nders.Data());
 
 			for (int k = 0; k <= du; k++)
 			{
 				for (int j = 0; j <= degree; j++)
 				{
-					derivatives[k] += nders[k][j] * controlPoints[spanIndex - degree + j];
+					derivatives[k] += nders[k * (degree + 1) + j] * controlPoints[spanIndex - degree + j];
 				}
 			}
 			return derivatives;
 		}
 
+		/// <summary>
+		/// Batch A3.1 and A3.2 for curves that already passed Check.
+		/// For sorted paramTs the span index only walks forward instead of being searched again, and the A2.2 and A2.3 denominators are computed once per span.
+		/// Unsorted paramTs are still evaluated correctly, through the binary search.
+		/// points holds paramTs.size() values; derivatives holds paramTs.size() * (derivative + 1) values, row i at derivatives[i * (derivative + 1)].
+		/// </summary>
+		template <typename T>
+		static void GetPointsOnCurveUnchecked(const LN_BsplineCurveView<T>& curve, const LN_ArrayView<double>& paramTs, T* points)
+		{
+			int degree = curve.Degree;
+			const LN_ArrayView<double>& knotVector = curve.KnotVector;
+			const LN_ArrayView<T>& controlPoints = curve.ControlPoints;
+
+			LN_ScratchBuffer<Polynomials::MaxStackDegree + 1> N(degree + 1);
+			LN_ScratchBuffer<Polynomials::MaxStackDegree * (Polynomials::MaxStackDegree + 1) / 2> inverseDenominators(degree * (degree + 1) / 2);
+
+			int spanIndex = -1;
+			for (int i = 0; i < paramTs.size(); i++)
+			{
+				double paramT = paramTs[i];
+				int previousSpanIndex = spanIndex;
+				spanIndex = Polynomials::GetKnotSpanIndexUnchecked(degree, knotVector, paramT, spanIndex);
+				if (spanIndex != previousSpanIndex)
+				{
+					Polynomials::ComputeInverseDenominators(spanIndex, degree, knotVector, inverseDenominators.Data());
+				}
+				Polynomials::BasisFunctionsUnchecked(spanIndex, degree, knotVector, paramT, inverseDenominators.Data(), N.Data());
+
+				T point;
+				for (int j = 0; j <= degree; j++)
+				{
+					point += N[j] * controlPoints[spanIndex - degree + j];
+				}
+				points[i] = point;
+			}
+		}
+
+		template <typename T>
+		static void ComputeDerivativesUnchecked(const LN_BsplineCurveView<T>& curve, int derivative, const LN_ArrayView<double>& paramTs, T* derivatives)
+		{
+			int degree = curve.Degree;
+			const LN_ArrayView<double>& knotVector = curve.KnotVector;
+			const LN_ArrayView<T>& controlPoints = curve.ControlPoints;
+
+			int du = std::min(derivative, degree);
+			LN_ScratchBuffer<(Polynomials::MaxStackDegree + 1) * (Polynomials::MaxStackDegree + 1)> nders((du + 1) * (degree + 1));
+			LN_ScratchBuffer<Polynomials::MaxStackDegree * (Polynomials::MaxStackDegree + 1) / 2> inverseDenominators(degree * (degree + 1) / 2);
+
+			int spanIndex = -1;
+			for (int i = 0; i < paramTs.size(); i++)
+			{
+				double paramT = paramTs[i];
+				int previousSpanIndex = spanIndex;
+				spanIndex = Polynomials::GetKnotSpanIndexUnchecked(degree, knotVector, paramT, spanIndex);
+				if (spanIndex != previousSpanIndex)
+				{
+					Polynomials::ComputeInverseDenominators(spanIndex, degree, knotVector, inverseDenominators.Data());
+				}
+				Polynomials::BasisFunctionsDerivativesUnchecked(spanIndex, degree, du, knotVector, paramT, inverseDenominators.Data(), nders.Data());
+
+				T* row = derivatives + i * (derivative + 1);
+				for (int k = 0; k <= derivative; k++)
+				{
+					row[k] = T();
+				}
+				for (int k = 0; k <= du; k++)
+				{
+					for (int j = 0; j <= degree; j++)
+					{
+						row[k] += nders[k * (degree + 1) + j] * controlPoints[spanIndex - degree + j];
+					}
+				}
+			}
+		}
+
 		/// <summary>
 		/// The NURBS Book 2nd Edition Page98
 		/// Algorithm A3.3
@@ -103,13 +217,19 @@ namespace LNLib
 		/// </summary>
 		template<typename T>
 		static std::vector<std::vector<T>> ComputeControlPointsOfDerivatives(const LN_BsplineCurve<T>& curve, int derivative, int minSpanIndex, int maxSpanIndex)
+		{
+			return ComputeControlPointsOfDerivatives(LN_BsplineCurveView<T>(curve), derivative, minSpanIndex, maxSpanIndex);
+		}
+
+		template<typename T>
+		static std::vector<std::vector<T>> ComputeControlPointsOfDerivatives(const LN_BsplineCurveView<T>& curve, int derivative, int minSpanIndex, int maxSpanIndex)
 		{
 			VALIDATE_ARGUMENT(derivative > 0, "derivative", "derivative must greater than zero.");
 			VALIDATE_ARGUMENT_RANGE(minSpanIndex, 0, maxSpanIndex);
 
 			int degree = curve.Degree;
-			std::vector<double> knotVector = curve.KnotVector;
-			std::vector<T> controlPoints = curve.ControlPoints;
+			const LN_ArrayView<double>& knotVector = curve.KnotVector;
+			const LN_ArrayView<T>& controlPoints = curve.ControlPoints;
 
 			int range = maxSpanIndex - minSpanIndex;
 			std::vector<std::vector<T>> PK(derivative + 1, std::vector<T>(range + 1));
@@ -136,10 +256,15 @@ namespace LNLib
 		/// </summary>
 		template<typename T>
 		static std::vector<T> ComputeDerivativesByAllBasisFunctions(const LN_BsplineCurve<T>& curve, int derivative, double paramT)
+		{
+			return ComputeDerivativesByAllBasisFunctions(LN_BsplineCurveView<T>(curve), derivative, paramT);
+		}
+
+		template<typename T>
+		static std::vector<T> ComputeDerivativesByAllBasisFunctions(const LN_BsplineCurveView<T>& curve, int derivative, double paramT)
 		{
 			int degree = curve.Degree;
-			std::vector<double> knotVector = curve.KnotVector;
-			std::vector<T> controlPoints = curve.ControlPoints;
+			const LN_ArrayView<double>& knotVector = curve.KnotVector;
 
 			VALIDATE_ARGUMENT(derivative > 0, "derivative", "derivative must greater than zero.");
 			VALIDATE_ARGUMENT_RANGE(paramT, knotVector[0], knotVector[knotVector.size() - 1]);
@@ -149,13 +274,7 @@ namespace LNLib
 			std::vector<std::vector<double>> N = Polynomials::AllBasisFunctions(spanIndex, degree, knotVector, paramT);
 
 			int du = std::min(derivative, degree);
-
-			LN_BsplineCurve<T> bsplineCurve;
-			bsplineCurve.Degree = degree;
-			bsplineCurve.KnotVector = knotVector;
-			bsplineCurve.ControlPoints = controlPoints;
-
-			std::vector<std::vector<T>> PK = ComputeControlPointsOfDerivatives(bsplineCurve, du, spanIndex - degree, spanIndex);
+			std::vector<std::vector<T>> PK = ComputeControlPointsOfDerivatives(curve, du, spanIndex - degree, spanIndex);
 
 			for (int k = 0; k <= du; k++)
 			{
@@ -17,6 +17,7 @@
 #include "LNLibExceptions.h"
 #include "LNObject.h"
 #include <vector>
+#include <algorithm>
 
 namespace LNLib
 {
@@ -31,9 +32,9 @@ namespace LNLib
 		{
 			int degreeU = surface.DegreeU;
 			int degreeV = surface.DegreeV;
-			std::vector<double> knotVectorU = surface.KnotVectorU;
-			std::vector<double> knotVectorV = surface.KnotVectorV;
-			std::vector<std::vector<T>> controlPoints = surface.ControlPoints;
+			const std::vector<double>& knotVectorU = surface.KnotVectorU;
+			const std::vector<double>& knotVectorV = surface.KnotVectorV;
+			const std::vector<std::vector<T>>& controlPoints = surface.ControlPoints;
 
 			VALIDATE_ARGUMENT(degreeU > 0, "degreeU", "Degree must greater than zero.");
 			VALIDATE_ARGUMENT(degreeV > 0, "degreeV", "Degree must greater than zero.");
@@ -54,20 +55,42 @@ namespace LNLib
 		template <typename T>
 		static T GetPointOnSurface(const LN_BsplineSurface<T>& surface, UV uv)
 		{
-			int degreeU = surface.DegreeU;
-			int degreeV = surface.DegreeV;
-			std::vector<double> knotVectorU = surface.KnotVectorU;
-			std::vector<double> knotVectorV = surface.KnotVectorV;
-			std::vector<std::vector<T>> controlPoints = surface.ControlPoints;
+			return GetPointOnSurface(LN_BsplineSurfaceView<T>(surface), uv);
+		}
 
+		template <typename T>
+		static T GetPointOnSurface(const LN_BsplineSurfaceView<T>& surface, UV uv)
+		{
+			const LN_ArrayView<double>& knotVectorU = surface.KnotVectorU;
+			const LN_ArrayView<double>& knotVectorV = surface.KnotVectorV;
+
+			VALIDATE_ARGUMENT(ValidationUtils::IsValidKnotVector(knotVectorU), "knotVectorU", "KnotVector must be a nondecreasing sequence of real numbers.");
+			VALIDATE_ARGUMENT(ValidationUtils::IsValidKnotVector(knotVectorV), "knotVectorV", "KnotVector must be a nondecreasing sequence of real numbers.");
 			VALIDATE_ARGUMENT_RANGE(uv.GetU(), knotVectorU[0], knotVectorU[knotVectorU.size() - 1]);
 			VALIDATE_ARGUMENT_RANGE(uv.GetV(), knotVectorV[0], knotVectorV[knotVectorV.size() - 1]);			
 
-			int uSpanIndex = Polynomials::GetKnotSpanIndex(degreeU, knotVectorU, uv.GetU());
-			std::vector<double> Nu = Polynomials::BasisFunctions(uSpanIndex, degreeU, knotVectorU, uv.GetU());
+			return GetPointOnSurfaceUnchecked(surface, uv);
+		}
 
-			int vSpanIndex = Polynomials::GetKnotSpanIndex(degreeV, knotVectorV, uv.GetV());
-			std::vector<double> Nv = Polynomials::BasisFunctions(vSpanIndex, degreeV, knotVectorV, uv.GetV());
+		/// <summary>
+		/// A3.5 without argument validation, for surfaces that already passed Check.
+		/// </summary>
+		template <typename T>
+		static T GetPointOnSurfaceUnchecked(const LN_BsplineSurfaceView<T>& surface, UV uv)
+		{
+			int degreeU = surface.DegreeU;
+			int degreeV = surface.DegreeV;
+			const LN_ArrayView<double>& knotVectorU = surface.KnotVectorU;
+			const LN_ArrayView<double>& knotVectorV = surface.KnotVectorV;
+			const LN_ArrayView<std::vector<T>>& controlPoints = surface.ControlPoints;
+
+			int uSpanIndex = Polynomials::GetKnotSpanIndexUnchecked(degreeU, knotVectorU, uv.GetU());
+			LN_ScratchBuffer<Polynomials::MaxStackDegree + 1> Nu(degreeU + 1);
+			Polynomials::BasisFunctionsUnchecked(uSpanIndex, degreeU, knotVectorU, uv.GetU(), Nu.Data());
+
+			int vSpanIndex = Polynomials::GetKnotSpanIndexUnchecked(degreeV, knotVectorV, uv.GetV());
+			LN_ScratchBuffer<Polynomials::MaxStackDegree + 1> Nv(degreeV + 1);
+			Polynomials::BasisFunctionsUnchecked(vSpanIndex, degreeV, knotVectorV, uv.GetV(), Nv.Data());
 
 			int uind = uSpanIndex - degreeU;
 			T point;
@@ -92,28 +115,76 @@ namespace LNLib
 		template <typename T>
 		static std::vector<std::vector<T>> ComputeDerivatives(const LN_BsplineSurface<T>& surface, int derivative, UV uv)
 		{
-			int degreeU = surface.DegreeU;
-			int degreeV = surface.DegreeV;
-			std::vector<double> knotVectorU = surface.KnotVectorU;
-			std::vector<double> knotVectorV = surface.KnotVectorV;
-			std::vector<std::vector<T>> controlPoints = surface.ControlPoints;
+			return ComputeDerivatives(LN_BsplineSurfaceView<T>(surface), derivative, uv);
+		}
+
+		template <typename T>
+		static std::vector<std::vector<T>> ComputeDerivatives(const LN_BsplineSurfaceView<T>& surface, int derivative, UV uv)
+		{
+			const LN_ArrayView<double>& knotVectorU = surface.KnotVectorU;
+			const LN_ArrayView<double>& knotVectorV = surface.KnotVectorV;
 
 			VALIDATE_ARGUMENT(derivative > 0, "derivative", "derivative must greater than zero.");	
+			VALIDATE_ARGUMENT(derivative <= surface.DegreeU && derivative <= surface.DegreeV, "derivative", "Derivative must not greater than degree.");
+			VALIDATE_ARGUMENT(ValidationUtils::IsValidKnotVector(knotVectorU), "knotVectorU", "KnotVector must be a nondecreasing sequence of real numbers.");
+			VALIDATE_ARGUMENT(ValidationUtils::IsValidKnotVector(knotVectorV), "knotVectorV", "KnotVector must be a nondecreasing sequence of real numbers.");
 			VALIDATE_ARGUMENT_RANGE(uv.GetU(), knotVectorU[0], knotVectorU[knotVectorU.size() - 1]);
 			VALIDATE_ARGUMENT_RANGE(uv.GetV(), knotVectorV[0], knotVectorV[knotVectorV.size() - 1]);		
 
-			std::vector<std::vector<T>> derivatives(derivative + 1, std::vector<T>(derivative + 1));
+			return ComputeDerivativesUnchecked(surface, derivative, uv);
+		}
 
-			int uSpanIndex = Polynomials::GetKnotSpanIndex(degreeU, knotVectorU, uv.GetU());
-			std::vector<std::vector<double>> Nu = Polynomials::BasisFunctionsDerivatives(uSpanIndex, degreeU, derivative, knotVectorU, uv.GetU());
+		/// <summary>
+		/// A3.6 without argument validation, for surfaces that already passed Check.
+		/// </summary>
+		template <typename T>
+		static std::vector<std::vector<T>> ComputeDerivativesUnchecked(const LN_BsplineSurfaceView<T>& surface, int derivative, UV uv)
+		{
+			int n = derivative + 1;
+			LN_ScratchBuffer<16, T> ders(n * n);
+			ComputeDerivativesUnchecked(surface, derivative, uv, ders.Data());
 
-			int vSpanIndex = Polynomials::GetKnotSpanIndex(degreeV, knotVectorV, uv.GetV());
-			std::vector<std::vector<double>> Nv = Polynomials::BasisFunctionsDerivatives(vSpanIndex, degreeV, derivative, knotVectorV, uv.GetV());
+			std::vector<std::vector<T>> derivatives(n, std::vector<T>(n));
+			for (int k = 0; k < n; k++)
+			{
+				for (int l = 0; l < n; l++)
+				{
+					derivatives[k][l] = ders[k * n + l];
+				}
+			}
+			return derivatives;
+		}
+
+		/// <summary>
+		/// Buffer form of the unchecked A3.6: derivatives holds (derivative + 1) * (derivative + 1) values, SKL[k][l] at derivatives[k * (derivative + 1) + l].
+		/// </summary>
+		template <typename T>
+		static void ComputeDerivativesUnchecked(const LN_BsplineSurfaceView<T>& surface, int derivative, UV uv, T* derivatives)
+		{
+			int degreeU = surface.DegreeU;
+			int degreeV = surface.DegreeV;
+			const LN_ArrayView<double>& knotVectorU = surface.KnotVectorU;
+			const LN_ArrayView<double>& knotVectorV = surface.KnotVectorV;
+			const LN_ArrayView<std::vector<T>>& controlPoints = surface.ControlPoints;
+
+			int n = derivative + 1;
+			for (int k = 0; k < n * n; k++)
+			{
+				derivatives[k] = T();
+			}
 
 			int du = std::min(derivative, degreeU);
 			int dv = std::min(derivative, degreeV);
 
-			std::vector<T> temp(degreeV + 1);
+			int uSpanIndex = Polynomials::GetKnotSpanIndexUnchecked(degreeU, knotVectorU, uv.GetU());
+			LN_ScratchBuffer<(Polynomials::MaxStackDegree + 1) * (Polynomials::MaxStackDegree + 1)> Nu((du + 1) * (degreeU + 1));
+			Polynomials::BasisFunctionsDerivativesUnchecked(uSpanIndex, degreeU, du, knotVectorU, uv.GetU(), Nu.Data());
+
+			int vSpanIndex = Polynomials::GetKnotSpanIndexUnchecked(degreeV, knotVectorV, uv.GetV());
+			LN_ScratchBuffer<(Polynomials::MaxStackDegree + 1) * (Polynomials::MaxStackDegree + 1)> Nv((dv + 1) * (degreeV + 1));
+			Polynomials::BasisFunctionsDerivativesUnchecked(vSpanIndex, degreeV, dv, knotVectorV, uv.GetV(), Nv.Data());
+
+			LN_ScratchBuffer<Polynomials::MaxStackDegree + 1, T> temp(degreeV + 1);
 
 			for (int k = 0; k <= du; k++)
 			{
@@ -122,7 +193,7 @@ namespace LNLib
 					temp[s] = T();
 					for (int r = 0; r <= degreeU; r++)
 					{
-						temp[s] += Nu[k][r] * controlPoints[uSpanIndex - degreeU + r][vSpanIndex - degreeV + s];
+						temp[s] += Nu[k * (degreeU + 1) + r] * controlPoints[uSpanIndex - degreeU + r][vSpanIndex - degreeV + s];
 					}
 				}
 				int dd = std::min(derivative, dv);
@@ -130,11 +201,10 @@ namespace LNLib
 				{
 					for (int s = 0; s <= degreeV; s++)
 					{
-						derivatives[k][l] += Nv[l][s] * temp[s];
+						derivatives[k * n + l] += Nv[l * (degreeV + 1) + s] * temp[s];
 					}
 				}
 			}
-			return derivatives;
 		}
 
 		/// <summary>
@@ -144,12 +214,18 @@ namespace LNLib
 		/// </summary>
 		template <typename T>
 		static std::vector<std::vector<std::vector<std::vector<T>>>> ComputeControlPointsOfDerivatives(const LN_BsplineSurface<T>& surface, int derivative, int minSpanIndexU, int maxSpanIndexU, int minSpanIndexV, int maxSpanIndexV, UV uv)
+		{
+			return ComputeControlPointsOfDerivatives(LN_BsplineSurfaceView<T>(surface), derivative, minSpanIndexU, maxSpanIndexU, minSpanIndexV, maxSpanIndexV, uv);
+		}
+
+		template <typename T>
+		static std::vector<std::vector<std::vector<std::vector<T>>>> ComputeControlPointsOfDerivatives(const LN_BsplineSurfaceView<T>& surface, int derivative, int minSpanIndexU, int maxSpanIndexU, int minSpanIndexV, int maxSpanIndexV, UV uv)
 		{
 			int degreeU = surface.DegreeU;
 			int degreeV = surface.DegreeV;
-			std::vector<double> knotVectorU = surface.KnotVectorU;
-			std::vector<double> knotVectorV = surface.KnotVectorV;
-			std::vector<std::vector<T>> controlPoints = surface.ControlPoints;
+			const LN_ArrayView<double>& knotVectorU = surface.KnotVectorU;
+			const LN_ArrayView<double>& knotVectorV = surface.KnotVectorV;
+			const LN_ArrayView<std::vector<T>>& controlPoints = surface.ControlPoints;
 
 			VALIDATE_ARGUMENT(derivative > 0, "derivative", "derivative must greater than zero.");
 			VALIDATE_ARGUMENT_RANGE(minSpanIndexU, 0, maxSpanIndexU);
@@ -166,18 +242,16 @@ namespace LNLib
 			int rangeU = maxSpanIndexU - minSpanIndexU;
 			int rangeV = maxSpanIndexV - minSpanIndexV;
 
+			// Only rows [minSpanIndexU, maxSpanIndexU] are read by A3.3, so gather just those.
+			std::vector<T> points(maxSpanIndexU + 1);
 			for (int j = minSpanIndexV; j <= maxSpanIndexV; j++)
 			{
-				std::vector<T> points;
-				for (int i = 0; i < controlPoints.size(); i++)
+				for (int i = minSpanIndexU; i <= maxSpanIndexU; i++)
 				{
-					points.emplace_back(controlPoints[i][j]);
+					points[i] = controlPoints[i][j];
 				}
 
-				LN_BsplineCurve<T> bsplineCurve;
-				bsplineCurve.Degree = degreeU;
-				bsplineCurve.KnotVector = knotVectorU;
-				bsplineCurve.ControlPoints = points;
+				LN_BsplineCurveView<T> bsplineCurve(degreeU, knotVectorU, LN_ArrayView<T>(points));
 
 				std::vector<std::vector<T>> temp = BsplineCurve::ComputeControlPointsOfDerivatives(bsplineCurve, du, minSpanIndexU, maxSpanIndexU);
 				for (int k = 0; k <= du; k++)
@@ -195,10 +269,7 @@ namespace LNLib
 				{
 					int dd = std::min(derivative - k, dv);
 
-					LN_BsplineCurve<T> bsplineCurve;
-					bsplineCurve.Degree = degreeV;
-					bsplineCurve.KnotVector = tempKv;
-					bsplineCurve.ControlPoints = PKL[k][0][i];
+					LN_BsplineCurveView<T> bsplineCurve(degreeV, LN_ArrayView<double>(tempKv), LN_ArrayView<T>(PKL[k][0][i]));
 
 					std::vector<std::vector<T>> temp = BsplineCurve::ComputeControlPointsOfDerivatives(bsplineCurve, dd, 0, rangeV);
 					for (int l = 1; l <= dd; l++)
@@ -220,12 +291,17 @@ namespace LNLib
 		/// </summary>
 		template <typename T>
 		static std::vector<std::vector<T>> ComputeDerivativesByAllBasisFunctions(const LN_BsplineSurface<T>& surface, int derivative, UV uv)
+		{
+			return ComputeDerivativesByAllBasisFunctions(LN_BsplineSurfaceView<T>(surface), derivative, uv);
+		}
+
+		template <typename T>
+		static std::vector<std::vector<T>> ComputeDerivativesByAllBasisFunctions(const LN_BsplineSurfaceView<T>& surface, int derivative, UV uv)
 		{
 			int degreeU = surface.DegreeU;
 			int degreeV = surface.DegreeV;
-			std::vector<double> knotVectorU = surface.KnotVectorU;
-			std::vector<double> knotVectorV = surface.KnotVectorV;
-			std::vector<std::vector<T>> controlPoints = surface.ControlPoints;
+			const LN_ArrayView<double>& knotVectorU = surface.KnotVectorU;
+			const LN_ArrayView<double>& knotVectorV = surface.KnotVectorV;
 
 			VALIDATE_ARGUMENT(derivative > 0, "derivative", "derivative must greater than zero.");
 			VALIDATE_ARGUMENT_RANGE(uv.GetU(), knotVectorU[0], knotVectorU[knotVectorU.size() - 1]);
@@ -238,14 +314,7 @@ namespace LNLib
 			std::vector<std::vector<double>> Nu = Polynomials::AllBasisFunctions(uSpanIndex, degreeU, knotVectorU, uv.GetU());
 			std::vector<std::vector<double>> Nv = Polynomials::AllBasisFunctions(vSpanIndex, degreeV, knotVectorV, uv.GetV());
 
-			LN_BsplineSurface<T> bsplineSurface;
-			bsplineSurface.DegreeU = degreeU;
-			bsplineSurface.DegreeV = degreeV;
-			bsplineSurface.KnotVectorU = knotVectorU;
-			bsplineSurface.KnotVectorV = knotVectorV;
-			bsplineSurface.ControlPoints = controlPoints;
-
-			std::vector<std::vector<std::vector<std::vector<T>>>> PKL = ComputeControlPointsOfDerivatives(bsplineSurface, derivative, uSpanIndex - degreeU, uSpanIndex, vSpanIndex - degreeV, vSpanIndex, uv);
+			std::vector<std::vector<std::vector<std::vector<T>>>> PKL = ComputeControlPointsOfDerivatives(surface, derivative, uSpanIndex - degreeU, uSpanIndex, vSpanIndex - degreeV, vSpanIndex, uv);
 
 			int du = std::min(derivative, degreeU);
 			int dv = std::min(derivative, degreeV);
@@ -269,6 +338,102 @@ namespace LNLib
 			}
 			return SKL;
 		}
+
+		/// <summary>
+		/// Tensor-product grid evaluation for surfaces that already passed Check.
+		/// The u basis is computed once per u value and the v basis once per v value.
+		/// Each u value contracts the control net into the control points of one isoparametric curve, which every v value then shares.
+		/// results holds (derivative + 1) * (derivative + 1) values per grid point, S(k,l) of uParams[i], vParams[j]
+		/// at results[((i * vParams.size() + j) * (derivative + 1) + k) * (derivative + 1) + l].
+		/// </summary>
+		template <typename T>
+		static void EvaluateGridUnchecked(const LN_BsplineSurfaceView<T>& surface, int derivative, const LN_ArrayView<double>& uParams, const LN_ArrayView<double>& vParams, T* results)
+		{
+			int degreeU = surface.DegreeU;
+			int degreeV = surface.DegreeV;
+			const LN_ArrayView<double>& knotVectorU = surface.KnotVectorU;
+			const LN_ArrayView<double>& knotVectorV = surface.KnotVectorV;
+			const LN_ArrayView<std::vector<T>>& controlPoints = surface.ControlPoints;
+
+			int uCount = uParams.size();
+			int vCount = vParams.size();
+			if (uCount == 0 || vCount == 0)
+			{
+				return;
+			}
+
+			int du = std::min(derivative, degreeU);
+			int dv = std::min(derivative, degreeV);
+			int strideU = (du + 1) * (degreeU + 1);
+			int strideV = (dv + 1) * (degreeV + 1);
+
+			std::vector<int> spansU(uCount);
+			std::vector<double> basisU(uCount * strideU);
+			int spanIndex = -1;
+			for (int i = 0; i < uCount; i++)
+			{
+				spanIndex = Polynomials::GetKnotSpanIndexUnchecked(degreeU, knotVectorU, uParams[i], spanIndex);
+				spansU[i] = spanIndex;
+				Polynomials::BasisFunctionsDerivativesUnchecked(spanIndex, degreeU, du, knotVectorU, uParams[i], basisU.data() + i * strideU);
+			}
+
+			std::vector<int> spansV(vCount);
+			std::vector<double> basisV(vCount * strideV);
+			spanIndex = -1;
+			for (int j = 0; j < vCount; j++)
+			{
+				spanIndex = Polynomials::GetKnotSpanIndexUnchecked(degreeV, knotVectorV, vParams[j], spanIndex);
+				spansV[j] = spanIndex;
+				Polynomials::BasisFunctionsDerivativesUnchecked(spanIndex, degreeV, dv, knotVectorV, vParams[j], basisV.data() + j * strideV);
+			}
+
+			int firstColumn = *std::min_element(spansV.begin(), spansV.end()) - degreeV;
+			int lastColumn = *std::max_element(spansV.begin(), spansV.end());
+			int columns = lastColumn - firstColumn + 1;
+
+			int n = derivative + 1;
+			std::vector<T> isoCurve((du + 1) * columns);
+			for (int i = 0; i < uCount; i++)
+			{
+				const double* Nu = basisU.data() + i * strideU;
+				int uind = spansU[i] - degreeU;
+				for (int k = 0; k <= du; k++)
+				{
+					for (int c = 0; c < columns; c++)
+					{
+						T temp = T();
+						for (int r = 0; r <= degreeU; r++)
+						{
+							temp += Nu[k * (degreeU + 1) + r] * controlPoints[uind + r][firstColumn + c];
+						}
+						isoCurve[k * columns + c] = temp;
+					}
+				}
+
+				for (int j = 0; j < vCount; j++)
+				{
+					const double* Nv = basisV.data() + j * strideV;
+					int vind = spansV[j] - degreeV - firstColumn;
+					T* SKL = results + (i * vCount + j) * n * n;
+					for (int k = 0; k < n * n; k++)
+					{
+						SKL[k] = T();
+					}
+					for (int k = 0; k <= du; k++)
+					{
+						for (int l = 0; l <= dv; l++)
+						{
+							T temp = T();
+							for (int s = 0; s <= degreeV; s++)
+							{
+								temp += Nv[l * (degreeV + 1) + s] * isoCurve[k * columns + vind + s];
+							}
+							SKL[k * n + l] = temp;
+						}
+					}
+				}
+			}
+		}
 	};
 }
 
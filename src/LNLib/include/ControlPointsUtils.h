@@ -27,6 +27,19 @@ namespace LNLib
 
 		static std::vector<std::vector<XYZW>> ToXYZW(const std::vector<std::vector<XYZ>>& points);
 
+		/// <summary>
+		/// False when every weight is exactly 1, i.e. the NURBS is a plain B-spline.
+		/// </summary>
+		static bool IsRational(const std::vector<XYZW>& weightedControlPoints);
+
+		static bool IsRational(const std::vector<std::vector<XYZW>>& weightedControlPoints);
+
+		/// <summary>
+		/// True when every point of the polygon lies within flatness times the chord length of its chord (first to last point)
+		/// and the polygon advances monotonically along the chord. A polygon whose ends coincide is flat only when all its points do.
+		/// </summary>
+		static bool IsFlatPolygon(const std::vector<XYZ>& points, double flatness);
+
 		static std::vector<std::vector<XYZW>> Multiply(const std::vector<std::vector<XYZW>>& points, const std::vector<std::vector<double>>& coefficient);
 
 		static std::vector<std::vector<XYZW>> Multiply(const std::vector<std::vector<double>>& coefficient, const std::vector<std::vector<XYZW>>& points);
@@ -10,8 +10,10 @@
 
 #pragma once
 #include "LNLibDefinitions.h"
+#include "LNEnums.h"
 #include "LNObject.h"
 #include <vector>
+#include <functional>
 
 namespace LNLib
 {
@@ -40,6 +42,21 @@ namespace LNLib
 		/// </summary>
 		static std::vector<double> ChebyshevSeries(int size = 100);
 		static double ClenshawCurtisQuadrature(IntegrationFunction& function, void* customData, double start, double end, std::vector<double>& series, double epsilon = Constants::DistanceEpsilon);	
+
+		/// <summary>
+		/// Globally adaptive Gauss-Kronrod quadrature. The interval with the largest error estimate |Kronrod - Gauss| is bisected
+		/// until the summed estimate is at most max(tolerance.Absolute, tolerance.Relative * |value|), or until another bisection
+		/// would exceed maxEvaluations integrand evaluations. Smooth integrands usually finish on the first 15 (21) point rule.
+		/// </summary>
+		static LN_IntegrationResult GaussKronrod(IntegrationFunction& function, void* customData, double start, double end, const LN_IntegrationTolerance& tolerance = LN_IntegrationTolerance(), int maxEvaluations = 10000, GaussKronrodRule rule = GaussKronrodRule::G7K15);
+		static LN_IntegrationResult GaussKronrod(const std::function<double(double)>& function, double start, double end, const LN_IntegrationTolerance& tolerance = LN_IntegrationTolerance(), int maxEvaluations = 10000, GaussKronrodRule rule = GaussKronrodRule::G7K15);
+
+		/// <summary>
+		/// Adaptive tensor product Gauss-Kronrod cubature over [startU, endU] x [startV, endV]. function evaluates the integrand on the grid
+		/// of us and vs, values[i * vs.size() + j] = f(us[i], vs[j]), so it can share work along grid lines. The rectangle with the largest
+		/// error estimate is quartered until the summed estimate meets the tolerance or the next split would exceed maxEvaluations.
+		/// </summary>
+		static LN_IntegrationResult GaussKronrodCubature(const std::function<void(const std::vector<double>&, const std::vector<double>&, std::vector<double>&)>& function, double startU, double endU, double startV, double endV, const LN_IntegrationTolerance& tolerance = LN_IntegrationTolerance(), int maxEvaluations = 100000, GaussKronrodRule rule = GaussKronrodRule::G7K15);
 	};
 }
 
@@ -53,6 +53,7 @@ namespace LNLib
 
 		/// <summary>
 		/// Get internal knot multiplcity map.
+		/// The first and last knot values are removed; every interior knot keeps its multiplicity.
 		/// </summary>
 		static std::unordered_map<double, int, std::hash<double>, CustomDoubleEqual> GetInternalKnotMultiplicityMap(const std::vector<double>& knotVector);
 
@@ -72,6 +73,12 @@ namespace LNLib
 		/// The NURBS Book 2nd Edition Page572
 		/// </summary>
 		static bool IsUniform(const std::vector<double>& knotVector);
+
+		/// <summary>
+		/// Get the distinct knots of the valid parameter range [knotVector[degree], knotVector[n + 1]] in increasing order,
+		/// i.e. the ends of the nonzero knot spans, one more than the number of Bezier segments of the curve.
+		/// </summary>
+		static std::vector<double> GetBreakpoints(int degree, const std::vector<double>& knotVector);
 	};
 
 }
@@ -58,6 +58,18 @@ namespace LNLib
 		Chebyshev = 2,
 	};
 
+	enum class GaussKronrodRule :int
+	{
+		G7K15 = 0,
+		G10K21 = 1,
+	};
+
+	enum class CurveDivisionType :int
+	{
+		ArcLength = 0,
+		Chord = 1,
+	};
+
 }
 
 
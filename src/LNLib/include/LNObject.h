@@ -10,9 +10,13 @@
 
 #pragma once
 #include "LNLibDefinitions.h"
+#include "UV.h"
 #include "XYZ.h"
 #include "XYZW.h"
 #include <vector>
+#include <new>
+#include <cstddef>
+#include <cstdint>
 
 namespace LNLib
 {
@@ -64,7 +68,514 @@ namespace LNLib
 		std::vector<double> KnotVectorV;
 		std::vector<std::vector<XYZW>> ControlPoints;
 	};
-}
 
+	/// <summary>
+	/// Non-owning view over an array (pointer + size + stride).
+	/// The viewed storage must outlive the view and must not be reallocated while it is in use; views of temporary vectors do not compile.
+	/// </summary>
+	template <typename T>
+	struct LN_ArrayView
+	{
+		const T* Data;
+		int Count;
+		int Stride;
+
+		LN_ArrayView() : Data(nullptr), Count(0), Stride(1) {}
+		LN_ArrayView(const T* data, int count, int stride = 1) : Data(data), Count(count), Stride(stride) {}
+		LN_ArrayView(const std::vector<T>& data) : Data(data.data()), Count(static_cast<int>(data.size())), Stride(1) {}
+		LN_ArrayView(std::vector<T>&&) = delete;
+
+		int size() const { return Count; }
+		const T& operator[](int index) const { return Data[index * Stride]; }
+	};
+
+	/// <summary>
+	/// Scratch array (of doubles unless T says otherwise) that lives on the stack while size fits in Capacity.
+	/// Larger sizes fall back to one heap allocation, so callers never need to check the size themselves.
+	/// </summary>
+	template <int Capacity, typename T = double>
+	struct LN_ScratchBuffer
+	{
+		explicit LN_ScratchBuffer(int size) : m_data(m_stack)
+		{
+			if (size > Capacity)
+			{
+				m_heap.resize(size);
+				m_data = m_heap.data();
+			}
+		}
+
+		T* Data() { return m_data; }
+		T& operator[](int index) { return m_data[index]; }
+
+	private:
+		LN_ScratchBuffer(const LN_ScratchBuffer&);
+		LN_ScratchBuffer& operator=(const LN_ScratchBuffer&);
+
+		T m_stack[Capacity];
+		std::vector<T> m_heap;
+		T* m_data;
+	};
+
+	/// <summary>
+	/// Non-owning view of a B-spline curve used by the evaluation templates in BsplineCurve.
+	/// Converting LN_BsplineCurve or LN_NurbsCurve (as XYZW) to a view copies no knots or control points.
+	/// </summary>
+	template <typename T>
+	struct LN_BsplineCurveView
+	{
+		int Degree;
+		LN_ArrayView<double> KnotVector;
+		LN_ArrayView<T> ControlPoints;
+
+		LN_BsplineCurveView() : Degree(0) {}
+		LN_BsplineCurveView(int degree, const LN_ArrayView<double>& knotVector, const LN_ArrayView<T>& controlPoints) :
+			Degree(degree), KnotVector(knotVector), ControlPoints(controlPoints) {}
+		LN_BsplineCurveView(const LN_BsplineCurve<T>& curve) :
+			Degree(curve.Degree), KnotVector(curve.KnotVector), ControlPoints(curve.ControlPoints) {}
+		LN_BsplineCurveView(const LN_NurbsCurve& curve) :
+			Degree(curve.Degree), KnotVector(curve.KnotVector), ControlPoints(curve.ControlPoints) {}
+	};
+
+	/// <summary>
+	/// Non-owning view of a B-spline surface used by the evaluation templates in BsplineSurface.
+	/// ControlPoints views the rows of the control net, so ControlPoints[i][j] addresses the original storage.
+	/// </summary>
+	template <typename T>
+	struct LN_BsplineSurfaceView
+	{
+		int DegreeU;
+		int DegreeV;
+		LN_ArrayView<double> KnotVectorU;
+		LN_ArrayView<double> KnotVectorV;
+		LN_ArrayView<std::vector<T>> ControlPoints;
+
+		LN_BsplineSurfaceView() : DegreeU(0), DegreeV(0) {}
+		LN_BsplineSurfaceView(const LN_BsplineSurface<T>& surface) :
+			DegreeU(surface.DegreeU), DegreeV(surface.DegreeV), KnotVectorU(surface.KnotVectorU), KnotVectorV(surface.KnotVectorV), ControlPoints(surface.ControlPoints) {}
+		LN_BsplineSurfaceView(const LN_NurbsSurface& surface) :
+			DegreeU(surface.DegreeU), DegreeV(surface.DegreeV), KnotVectorU(surface.KnotVectorU), KnotVectorV(surface.KnotVectorV), ControlPoints(surface.ControlPoints) {}
+	};
+
+	class NurbsCurve;
+	class NurbsSurface;
+
+	/// <summary>
+	/// A NURBS curve that already passed NurbsCurve::Check.
+	/// Only NurbsCurve::Check creates it, so the evaluation overloads taking it skip knot vector validation.
+	/// It views the checked curve and must not outlive it. The view is read-only, so a handle cannot be pointed at an unchecked curve.
+	/// IsRational() is false when every weight is exactly 1; the curve is then evaluated as a plain B-spline.
+	/// </summary>
+	struct LN_CheckedNurbsCurve
+	{
+		bool IsRational() const { return m_isRational; }
+		const LN_BsplineCurveView<XYZW>& GetCurve() const { return m_curve; }
+
+	private:
+		friend class NurbsCurve;
+		friend struct LN_CurveBVH;
+		friend struct LN_ArcLengthTable;
+		LN_CheckedNurbsCurve(const LN_NurbsCurve& curve, bool isRational) : m_isRational(isRational), m_curve(curve) {}
 
+		bool m_isRational;
+		LN_BsplineCurveView<XYZW> m_curve;
+	};
+
+	/// <summary>
+	/// A NURBS surface that already passed NurbsSurface::Check.
+	/// Only NurbsSurface::Check creates it, so the evaluation overloads taking it skip knot vector validation.
+	/// It views the checked surface and must not outlive it. The view is read-only, so a handle cannot be pointed at an unchecked surface.
+	/// IsRational() is false when every weight is exactly 1; the surface is then evaluated as a plain B-spline.
+	/// </summary>
+	struct LN_CheckedNurbsSurface
+	{
+		bool IsRational() const { return m_isRational; }
+		const LN_BsplineSurfaceView<XYZW>& GetSurface() const { return m_surface; }
+
+	private:
+		friend class NurbsSurface;
+		friend struct LN_SurfaceBVH;
+		LN_CheckedNurbsSurface(const LN_NurbsSurface& surface, bool isRational) : m_isRational(isRational), m_surface(surface) {}
+
+		bool m_isRational;
+		LN_BsplineSurfaceView<XYZW> m_surface;
+	};
+
+	/// <summary>
+	/// Allocator returning Alignment-byte aligned storage, for arrays that SIMD kernels load directly.
+	/// </summary>
+	template <typename T, int Alignment = 32>
+	struct LN_AlignedAllocator
+	{
+		typedef T value_type;
+		template <typename U>
+		struct rebind
+		{
+			typedef LN_AlignedAllocator<U, Alignment> other;
+		};
+
+		LN_AlignedAllocator() {}
+		template <typename U>
+		LN_AlignedAllocator(const LN_AlignedAllocator<U, Alignment>&) {}
+
+		T* allocate(std::size_t count)
+		{
+			char* raw = static_cast<char*>(::operator new(count * sizeof(T) + Alignment + sizeof(void*)));
+			std::uintptr_t address = reinterpret_cast<std::uintptr_t>(raw + sizeof(void*));
+			char* aligned = raw + sizeof(void*) + (Alignment - address % Alignment) % Alignment;
+			reinterpret_cast<void**>(aligned)[-1] = raw;
+			return reinterpret_cast<T*>(aligned);
+		}
+
+		void deallocate(T* pointer, std::size_t)
+		{
+			::operator delete(reinterpret_cast<void**>(pointer)[-1]);
+		}
+
+		template <typename U>
+		bool operator==(const LN_AlignedAllocator<U, Alignment>&) const { return true; }
+		template <typename U>
+		bool operator!=(const LN_AlignedAllocator<U, Alignment>&) const { return false; }
+	};
+
+	/// <summary>
+	/// Structure-of-arrays form of a NURBS curve, built by NurbsCurve::Compile.
+	/// The weighted control points are split into contiguous 32-byte aligned X, Y, Z and W arrays (wx, wy, wz, w).
+	/// Only NurbsCurve::Compile creates it and its arrays are read-only, so the SIMD kernels can trust their sizes.
+	/// </summary>
+	struct LN_CompiledNurbsCurve
+	{
+		int GetDegree() const { return m_degree; }
+		const std::vector<double>& GetKnotVector() const { return m_knotVector; }
+		const std::vector<double, LN_AlignedAllocator<double>>& GetX() const { return m_x; }
+		const std::vector<double, LN_AlignedAllocator<double>>& GetY() const { return m_y; }
+		const std::vector<double, LN_AlignedAllocator<double>>& GetZ() const { return m_z; }
+		const std::vector<double, LN_AlignedAllocator<double>>& GetW() const { return m_w; }
+
+	private:
+		friend class NurbsCurve;
+		LN_CompiledNurbsCurve() : m_degree(0) {}
+
+		int m_degree;
+		std::vector<double> m_knotVector;
+		std::vector<double, LN_AlignedAllocator<double>> m_x;
+		std::vector<double, LN_AlignedAllocator<double>> m_y;
+		std::vector<double, LN_AlignedAllocator<double>> m_z;
+		std::vector<double, LN_AlignedAllocator<double>> m_w;
+	};
+
+	/// <summary>
+	/// Structure-of-arrays form of a NURBS surface, built by NurbsSurface::Compile.
+	/// X, Y, Z and W store the weighted control net row by row: ControlPoints[i][j] is at index i * Columns + j.
+	/// Only NurbsSurface::Compile creates it and its arrays are read-only, so the SIMD kernels can trust their sizes.
+	/// </summary>
+	struct LN_CompiledNurbsSurface
+	{
+		int GetDegreeU() const { return m_degreeU; }
+		int GetDegreeV() const { return m_degreeV; }
+		const std::vector<double>& GetKnotVectorU() const { return m_knotVectorU; }
+		const std::vector<double>& GetKnotVectorV() const { return m_knotVectorV; }
+		int GetRows() const { return m_rows; }
+		int GetColumns() const { return m_columns; }
+		const std::vector<double, LN_AlignedAllocator<double>>& GetX() const { return m_x; }
+		const std::vector<double, LN_AlignedAllocator<double>>& GetY() const { return m_y; }
+		const std::vector<double, LN_AlignedAllocator<double>>& GetZ() const { return m_z; }
+		const std::vector<double, LN_AlignedAllocator<double>>& GetW() const { return m_w; }
+
+	private:
+		friend class NurbsSurface;
+		LN_CompiledNurbsSurface() : m_degreeU(0), m_degreeV(0), m_rows(0), m_columns(0) {}
+
+		int m_degreeU;
+		int m_degreeV;
+		std::vector<double> m_knotVectorU;
+		std::vector<double> m_knotVectorV;
+		int m_rows;
+		int m_columns;
+		std::vector<double, LN_AlignedAllocator<double>> m_x;
+		std::vector<double, LN_AlignedAllocator<double>> m_y;
+		std::vector<double, LN_AlignedAllocator<double>> m_z;
+		std::vector<double, LN_AlignedAllocator<double>> m_w;
+	};
+
+	/// <summary>
+	/// Piecewise power basis form of a NURBS curve, built by NurbsCurve::ToPowerBasis.
+	/// Span i covers [Knots[i], Knots[i + 1]] and holds Degree + 1 weighted coefficients in the local parameter
+	/// s = (t - Knots[i]) / (Knots[i + 1] - Knots[i]), so that Cw(t) = Coefficients[i][0] + Coefficients[i][1] * s + ... .
+	/// </summary>
+	struct LN_PowerBasisCurve
+	{
+		int Degree;
+		std::vector<double> Knots;
+		std::vector<std::vector<XYZW>> Coefficients;
+
+		LN_PowerBasisCurve() : Degree(0) {}
+	};
+
+	/// <summary>
+	/// Piecewise power basis form of a NURBS surface, built by NurbsSurface::ToPowerBasis.
+	/// Patch (i, j) covers [KnotsU[i], KnotsU[i + 1]] x [KnotsV[j], KnotsV[j + 1]] and is stored at Coefficients[i * (KnotsV.size() - 1) + j]
+	/// as a (DegreeU + 1) x (DegreeV + 1) matrix in the local parameters, laid out like the coefficients of the 2D Polynomials::Horner.
+	/// </summary>
+	struct LN_PowerBasisSurface
+	{
+		int DegreeU;
+		int DegreeV;
+		std::vector<double> KnotsU;
+		std::vector<double> KnotsV;
+		std::vector<std::vector<std::vector<XYZW>>> Coefficients;
+
+		LN_PowerBasisSurface() : DegreeU(0), DegreeV(0) {}
+	};
+
+	/// <summary>
+	/// Node of a bounding volume hierarchy. Min and Max bound the control points below the node;
+	/// an inner node has children Left and Right, a leaf has Left = Right = -1 and refers to Leaf.
+	/// </summary>
+	struct LN_BVHNode
+	{
+		XYZ Min;
+		XYZ Max;
+		int Left;
+		int Right;
+		int Leaf;
+
+		LN_BVHNode() : Left(-1), Right(-1), Leaf(-1) {}
+	};
+
+	/// <summary>
+	/// Projection accelerator of a NURBS curve, built by NurbsCurve::BuildBVH. Leaves[i] is a flat Bezier piece of the curve,
+	/// parameterized over [0, 1] and mapping linearly onto [LeafParams[2 * i], LeafParams[2 * i + 1]] of the curve.
+	/// CheckedLeaves[i] is Leaves[i] checked once at build time; copies rebind it to their own leaves.
+	/// Nodes[0] is the root.
+	/// </summary>
+	struct LN_CurveBVH
+	{
+		std::vector<LN_BVHNode> Nodes;
+		std::vector<LN_NurbsCurve> Leaves;
+		std::vector<LN_CheckedNurbsCurve> CheckedLeaves;
+		std::vector<double> LeafParams;
+
+		LN_CurveBVH() {}
+		LN_CurveBVH(const LN_CurveBVH& other) :
+			Nodes(other.Nodes), Leaves(other.Leaves), CheckedLeaves(other.CheckedLeaves), LeafParams(other.LeafParams) { RebindCheckedLeaves(); }
+		LN_CurveBVH(LN_CurveBVH&& other) = default;
+		LN_CurveBVH& operator=(const LN_CurveBVH& other)
+		{
+			Nodes = other.Nodes;
+			Leaves = other.Leaves;
+			CheckedLeaves = other.CheckedLeaves;
+			LeafParams = other.LeafParams;
+			RebindCheckedLeaves();
+			return *this;
+		}
+		LN_CurveBVH& operator=(LN_CurveBVH&& other) = default;
+
+	private:
+		void RebindCheckedLeaves()
+		{
+			for (int i = 0; i < CheckedLeaves.size(); i++)
+			{
+				CheckedLeaves[i].m_curve = LN_BsplineCurveView<XYZW>(Leaves[i]);
+			}
+		}
+	};
+
+	/// <summary>
+	/// Projection accelerator of a NURBS surface, built by NurbsSurface::BuildBVH. Leaves[i] is a flat Bezier piece of the surface over [0, 1] x [0, 1],
+	/// mapping linearly onto [LeafParams[4 * i], LeafParams[4 * i + 1]] x [LeafParams[4 * i + 2], LeafParams[4 * i + 3]].
+	/// Nodes[0] is the root.
+	/// </summary>
+	struct LN_SurfaceBVH
+	{
+		std::vector<LN_BVHNode> Nodes;
+		std::vector<LN_NurbsSurface> Leaves;
+		std::vector<LN_CheckedNurbsSurface> CheckedLeaves;
+		std::vector<double> LeafParams;
+
+		LN_SurfaceBVH() {}
+		LN_SurfaceBVH(const LN_SurfaceBVH& other) :
+			Nodes(other.Nodes), Leaves(other.Leaves), CheckedLeaves(other.CheckedLeaves), LeafParams(other.LeafParams) { RebindCheckedLeaves(); }
+		LN_SurfaceBVH(LN_SurfaceBVH&& other) = default;
+		LN_SurfaceBVH& operator=(const LN_SurfaceBVH& other)
+		{
+			Nodes = other.Nodes;
+			Leaves = other.Leaves;
+			CheckedLeaves = other.CheckedLeaves;
+			LeafParams = other.LeafParams;
+			RebindCheckedLeaves();
+			return *this;
+		}
+		LN_SurfaceBVH& operator=(LN_SurfaceBVH&& other) = default;
+
+	private:
+		void RebindCheckedLeaves()
+		{
+			for (int i = 0; i < CheckedLeaves.size(); i++)
+			{
+				CheckedLeaves[i].m_surface = LN_BsplineSurfaceView<XYZW>(Leaves[i]);
+			}
+		}
+	};
+
+	/// <summary>
+	/// Statistics of signed deviations d, as returned by NurbsSurface::GetParamsOnSurface.
+	/// Histogram[i] counts the d in [HistogramStart + i * HistogramBinWidth, HistogramStart + (i + 1) * HistogramBinWidth),
+	/// spanning [MinSignedDistance, MaxSignedDistance] with the last bin closed.
+	/// </summary>
+	struct LN_DeviationStatistics
+	{
+		int Count;
+		double MinSignedDistance;
+		double MaxSignedDistance;
+		double MaxAbsoluteDistance;
+		double MeanAbsoluteDistance;
+		double MeanSignedDistance;
+		double RMSDistance;
+		double HistogramStart;
+		double HistogramBinWidth;
+		std::vector<int> Histogram;
+
+		LN_DeviationStatistics() : Count(0), MinSignedDistance(0.0), MaxSignedDistance(0.0), MaxAbsoluteDistance(0.0), MeanAbsoluteDistance(0.0),
+			MeanSignedDistance(0.0), RMSDistance(0.0), HistogramStart(0.0), HistogramBinWidth(0.0) {}
+	};
+
+	/// <summary>
+	/// Target accuracy of adaptive integration: the error estimate must not exceed max(Absolute, Relative * |value|).
+	/// </summary>
+	struct LN_IntegrationTolerance
+	{
+		double Absolute;
+		double Relative;
+
+		LN_IntegrationTolerance(double absolute = 0.0, double relative = 1E-10) : Absolute(absolute), Relative(relative) {}
+	};
+
+	/// <summary>
+	/// Result of an adaptive integration: the value, its error estimate, the number of integrand evaluations spent,
+	/// and whether the estimate met the requested tolerance within the evaluation budget.
+	/// </summary>
+	struct LN_IntegrationResult
+	{
+		double Value;
+		double Error;
+		int Evaluations;
+		bool IsConverged;
+
+		LN_IntegrationResult() : Value(0.0), Error(0.0), Evaluations(0), IsConverged(true) {}
+	};
+
+	/// <summary>
+	/// Area of a NURBS surface with its breakdown over the Bezier patches of NurbsSurface::DecomposeToBeziers:
+	/// PatchAreas[i * PatchCountV + j] and PatchErrors[i * PatchCountV + j] belong to patch (i, j), and Area and Error are their sums.
+	/// IsConverged is false if some patch used up its evaluation budget before meeting the tolerance.
+	/// </summary>
+	struct LN_SurfaceArea
+	{
+		double Area;
+		double Error;
+		int PatchCountU;
+		int PatchCountV;
+		std::vector<double> PatchAreas;
+		std::vector<double> PatchErrors;
+		int Evaluations;
+		bool IsConverged;
+
+		LN_SurfaceArea() : Area(0.0), Error(0.0), PatchCountU(0), PatchCountV(0), Evaluations(0), IsConverged(true) {}
+	};
+
+	/// <summary>
+	/// Arc length table of a NURBS curve, built by NurbsCurve::BuildArcLengthTable.
+	/// Segments[k] is Bezier segment k over [0, 1], covering [Breakpoints[k], Breakpoints[k + 1]] of the curve.
+	/// Params increase from the start to the end of the curve, Lengths[i] is the arc length from the start to Params[i],
+	/// and interval [Params[i], Params[i + 1]] lies in segment IntervalSegments[i].
+	/// CheckedSegments[k] is Segments[k] checked once at build time, so lookups skip validation.
+	/// Speeds[2 * i] and Speeds[2 * i + 1] are |C'| at the start and end of interval i; lookups use them to start from a monotone cubic inverse.
+	/// </summary>
+	struct LN_ArcLengthTable
+	{
+		std::vector<LN_NurbsCurve> Segments;
+		std::vector<LN_CheckedNurbsCurve> CheckedSegments;
+		std::vector<double> Breakpoints;
+		std::vector<double> Params;
+		std::vector<double> Lengths;
+		std::vector<double> Speeds;
+		std::vector<int> IntervalSegments;
+
+		LN_ArcLengthTable() {}
+		LN_ArcLengthTable(const LN_ArcLengthTable& other) :
+			Segments(other.Segments), CheckedSegments(other.CheckedSegments), Breakpoints(other.Breakpoints), Params(other.Params),
+			Lengths(other.Lengths), Speeds(other.Speeds), IntervalSegments(other.IntervalSegments) { RebindCheckedSegments(); }
+		LN_ArcLengthTable(LN_ArcLengthTable&& other) = default;
+		LN_ArcLengthTable& operator=(const LN_ArcLengthTable& other)
+		{
+			Segments = other.Segments;
+			CheckedSegments = other.CheckedSegments;
+			Breakpoints = other.Breakpoints;
+			Params = other.Params;
+			Lengths = other.Lengths;
+			Speeds = other.Speeds;
+			IntervalSegments = other.IntervalSegments;
+			RebindCheckedSegments();
+			return *this;
+		}
+		LN_ArcLengthTable& operator=(LN_ArcLengthTable&& other) = default;
+
+	private:
+		void RebindCheckedSegments()
+		{
+			for (int k = 0; k < CheckedSegments.size(); k++)
+			{
+				CheckedSegments[k].m_curve = LN_BsplineCurveView<XYZW>(Segments[k]);
+			}
+		}
+	};
+
+	/// <summary>
+	/// Tolerances of the adaptive tessellators. An edge is split until the geometry deviates from it by at most ChordHeight,
+	/// the tangents (or normals) at its ends differ by at most AngleTolerance radians, and it is at most MaxEdgeLength long.
+	/// MaxEdgeLength = 0 leaves the edge length unbounded.
+	/// </summary>
+	struct LN_TessellationTolerance
+	{
+		double ChordHeight;
+		double AngleTolerance;
+		double MaxEdgeLength;
+
+		LN_TessellationTolerance(double chordHeight = 1E-3, double angleTolerance = 0.1, double maxEdgeLength = 0.0) :
+			ChordHeight(chordHeight), AngleTolerance(angleTolerance), MaxEdgeLength(maxEdgeLength) {}
+	};
+
+	/// <summary>
+	/// Execution policy of the bulk operations. ThreadCount = 1 runs sequentially on the calling thread,
+	/// ThreadCount = 0 uses every hardware thread. Results do not depend on the thread count.
+	/// </summary>
+	struct LN_ExecutionPolicy
+	{
+		int ThreadCount;
+
+		LN_ExecutionPolicy(int threadCount = 1) : ThreadCount(threadCount) {}
+	};
+
+	/// <summary>
+	/// Indexed triangle mesh. Vertices, Normals and UVs are parallel arrays with one entry per vertex,
+	/// and Triangles holds three vertex indices per triangle, counterclockwise around the normal.
+	/// </summary>
+	struct LN_Mesh
+	{
+		std::vector<XYZ> Vertices;
+		std::vector<XYZ> Normals;
+		std::vector<UV> UVs;
+		std::vector<int> Triangles;
+	};
+
+	/// <summary>
+	/// Polyline produced by a curve tessellator: Points[i] lies on the curve at Params[i].
+	/// </summary>
+	struct LN_Polyline
+	{
+		std::vector<XYZ> Points;
+		std::vector<double> Params;
+	};
+}
 
@@ -41,8 +41,20 @@ namespace LNLib
 
 		static int Factorial(int number);
 
+		/// <summary>
+		/// Largest number whose binomial coefficients are read from the shared Pascal triangle.
+		/// Every entry up to this number is an exactly representable double.
+		/// </summary>
+		static const int MaxBinomialNumber = 32;
+
 		static double Binomial(int number, int i);
 
+		/// <summary>
+		/// Row number of the Pascal triangle, built once: BinomialRow(number)[i] is Binomial(number, i) for 0 <= i <= number.
+		/// number must not exceed MaxBinomialNumber.
+		/// </summary>
+		static const double* BinomialRow(int number);
+
 		/// <summary>
 		/// The NURBS Book 2nd Edition Page445
 		/// Equation 9.102.
@@ -10,24 +10,26 @@
 
 #pragma once
 #include "LNLibDefinitions.h"
+#include "XYZ.h"
+#include "XYZW.h"
 
 namespace LNLib
 {
-	class XYZ;
-	class XYZW;
 	/// <summary>
 	/// 4 * 4 Matrix for model transformation, such as T(x) = M * x
 	/// Matrix4d : [x y z w]
+	/// Construction, element access, Multiply and the point/vector transforms are defined inline below;
+	/// the constructors and GetElement are constexpr.
 	/// </summary>
 	class LNLIB_EXPORT Matrix4d
 	{
 	public:
 
-		Matrix4d();
+		constexpr Matrix4d();
 
-		Matrix4d(XYZ basisX, XYZ basisY, XYZ basisZ, XYZ basisW);
+		constexpr Matrix4d(XYZ basisX, XYZ basisY, XYZ basisZ, XYZ basisW);
 
-		Matrix4d(double a00, double a01, double a02, double a03,
+		constexpr Matrix4d(double a00, double a01, double a02, double a03,
 				 double a10, double a11, double a12, double a13,
 				 double a20, double a21, double a22, double a23,
 				 double a30, double a31, double a32, double a33);
@@ -48,7 +50,7 @@ namespace LNLib
 		XYZ GetBasisZ() const;
 		void SetBasisW(const XYZ& basisW);
 		XYZ GetBasisW() const;
-		double GetElement(int row, int column) const;
+		constexpr double GetElement(int row, int column) const;
 		void SetElement(int row, int column, double value);
 
 	public:
@@ -67,13 +69,161 @@ namespace LNLib
 		bool IsTranslation();
 
 	public:
-		Matrix4d& operator =(const Matrix4d & another);
+		Matrix4d& operator =(const Matrix4d & another) = default;
 
 	private:
 		double m_matrix4d[4][4];
 
 	};
 
+	constexpr Matrix4d::Matrix4d() :
+		m_matrix4d{ { 1, 0, 0, 0 },
+					{ 0, 1, 0, 0 },
+					{ 0, 0, 1, 0 },
+					{ 0, 0, 0, 1 } }
+	{
+	}
+
+	constexpr Matrix4d::Matrix4d(XYZ basisX, XYZ basisY, XYZ basisZ, XYZ basisW) :
+		m_matrix4d{ { basisX.GetX(), basisY.GetX(), basisZ.GetX(), basisW.GetX() },
+					{ basisX.GetY(), basisY.GetY(), basisZ.GetY(), basisW.GetY() },
+					{ basisX.GetZ(), basisY.GetZ(), basisZ.GetZ(), basisW.GetZ() },
+					{ 0, 0, 0, 1 } }
+	{
+	}
+
+	constexpr Matrix4d::Matrix4d(double a00, double a01, double a02, double a03, double a10, double a11, double a12, double a13, double a20, double a21, double a22, double a23, double a30, double a31, double a32, double a33) :
+		m_matrix4d{ { a00, a01, a02, a03 },
+					{ a10, a11, a12, a13 },
+					{ a20, a21, a22, a23 },
+					{ a30, a31, a32, a33 } }
+	{
+	}
+
+	inline void Matrix4d::SetBasisX(const XYZ& basisX)
+	{
+		m_matrix4d[0][0] = basisX[0];
+		m_matrix4d[1][0] = basisX[1];
+		m_matrix4d[2][0] = basisX[2];
+	}
+
+	inline XYZ Matrix4d::GetBasisX() const
+	{
+		return XYZ(m_matrix4d[0][0], m_matrix4d[1][0], m_matrix4d[2][0]);
+	}
+
+	inline void Matrix4d::SetBasisY(const XYZ& basisY)
+	{
+		m_matrix4d[0][1] = basisY[0];
+		m_matrix4d[1][1] = basisY[1];
+		m_matrix4d[2][1] = basisY[2];
+	}
+
+	inline XYZ Matrix4d::GetBasisY() const
+	{
+		return XYZ(m_matrix4d[0][1], m_matrix4d[1][1], m_matrix4d[2][1]);
+	}
+
+	inline void Matrix4d::SetBasisZ(const XYZ& basisZ)
+	{
+		m_matrix4d[0][2] = basisZ[0];
+		m_matrix4d[1][2] = basisZ[1];
+		m_matrix4d[2][2] = basisZ[2];
+	}
+
+	inline XYZ Matrix4d::GetBasisZ() const
+	{
+		return XYZ(m_matrix4d[0][2], m_matrix4d[1][2], m_matrix4d[2][2]);
+	}
+
+	inline void Matrix4d::SetBasisW(const XYZ& basisW)
+	{
+		m_matrix4d[0][3] = basisW[0];
+		m_matrix4d[1][3] = basisW[1];
+		m_matrix4d[2][3] = basisW[2];
+	}
+
+	inline XYZ Matrix4d::GetBasisW() const
+	{
+		return XYZ(m_matrix4d[0][3], m_matrix4d[1][3], m_matrix4d[2][3]);
+	}
+
+	constexpr double Matrix4d::GetElement(int row, int column) const
+	{
+		return m_matrix4d[row][column];
+	}
+
+	inline void Matrix4d::SetElement(int row, int column, double value)
+	{
+		m_matrix4d[row][column] = value;
+	}
+
+	inline Matrix4d Matrix4d::Multiply(const Matrix4d& right)
+	{
+		Matrix4d result = Matrix4d();
+
+		result.m_matrix4d[0][0] = m_matrix4d[0][0] * right.m_matrix4d[0][0] + m_matrix4d[0][1] * right.m_matrix4d[1][0] + m_matrix4d[0][2] * right.m_matrix4d[2][0] + m_matrix4d[0][3] * right.m_matrix4d[3][0];
+		result.m_matrix4d[0][1] = m_matrix4d[0][0] * right.m_matrix4d[0][1] + m_matrix4d[0][1] * right.m_matrix4d[1][1] + m_matrix4d[0][2] * right.m_matrix4d[2][1] + m_matrix4d[0][3] * right.m_matrix4d[3][1];
+		result.m_matrix4d[0][2] = m_matrix4d[0][0] * right.m_matrix4d[0][2] + m_matrix4d[0][1] * right.m_matrix4d[1][2] + m_matrix4d[0][2] * right.m_matrix4d[2][2] + m_matrix4d[0][3] * right.m_matrix4d[3][2];
+		result.m_matrix4d[0][3] = m_matrix4d[0][0] * right.m_matrix4d[0][3] + m_matrix4d[0][1] * right.m_matrix4d[1][3] + m_matrix4d[0][2] * right.m_matrix4d[2][3] + m_matrix4d[0][3] * right.m_matrix4d[3][3];
+
+		result.m_matrix4d[1][0] = m_matrix4d[1][0] * right.m_matrix4d[0][0] + m_matrix4d[1][1] * right.m_matrix4d[1][0] + m_matrix4d[1][2] * right.m_matrix4d[2][0] + m_matrix4d[1][3] * right.m_matrix4d[3][0];
+		result.m_matrix4d[1][1] = m_matrix4d[1][0] * right.m_matrix4d[0][1] + m_matrix4d[1][1] * right.m_matrix4d[1][1] + m_matrix4d[1][2] * right.m_matrix4d[2][1] + m_matrix4d[1][3] * right.m_matrix4d[3][1];
+		result.m_matrix4d[1][2] = m_matrix4d[1][0] * right.m_matrix4d[0][2] + m_matrix4d[1][1] * right.m_matrix4d[1][2] + m_matrix4d[1][2] * right.m_matrix4d[2][2] + m_matrix4d[1][3] * right.m_matrix4d[3][2];
+		result.m_matrix4d[1][3] = m_matrix4d[1][0] * right.m_matrix4d[0][3] + m_matrix4d[1][1] * right.m_matrix4d[1][3] + m_matrix4d[1][2] * right.m_matrix4d[2][3] + m_matrix4d[1][3] * right.m_matrix4d[3][3];
+
+		result.m_matrix4d[2][0] = m_matrix4d[2][0] * right.m_matrix4d[0][0] + m_matrix4d[2][1] * right.m_matrix4d[1][0] + m_matrix4d[2][2] * right.m_matrix4d[2][0] + m_matrix4d[2][3] * right.m_matrix4d[3][0];
+		result.m_matrix4d[2][1] = m_matrix4d[2][0] * right.m_matrix4d[0][1] + m_matrix4d[2][1] * right.m_matrix4d[1][1] + m_matrix4d[2][2] * right.m_matrix4d[2][1] + m_matrix4d[2][3] * right.m_matrix4d[3][1];
+		result.m_matrix4d[2][2] = m_matrix4d[2][0] * right.m_matrix4d[0][2] + m_matrix4d[2][1] * right.m_matrix4d[1][2] + m_matrix4d[2][2] * right.m_matrix4d[2][2] + m_matrix4d[2][3] * right.m_matrix4d[3][2];
+		result.m_matrix4d[2][3] = m_matrix4d[2][0] * right.m_matrix4d[0][3] + m_matrix4d[2][1] * right.m_matrix4d[1][3] + m_matrix4d[2][2] * right.m_matrix4d[2][3] + m_matrix4d[2][3] * right.m_matrix4d[3][3];
+
+		result.m_matrix4d[3][0] = m_matrix4d[3][0] * right.m_matrix4d[0][0] + m_matrix4d[3][1] * right.m_matrix4d[1][0] + m_matrix4d[3][2] * right.m_matrix4d[2][0] + m_matrix4d[3][3] * right.m_matrix4d[3][0];
+		result.m_matrix4d[3][1] = m_matrix4d[3][0] * right.m_matrix4d[0][1] + m_matrix4d[3][1] * right.m_matrix4d[1][1] + m_matrix4d[3][2] * right.m_matrix4d[2][1] + m_matrix4d[3][3] * right.m_matrix4d[3][1];
+		result.m_matrix4d[3][2] = m_matrix4d[3][0] * right.m_matrix4d[0][2] + m_matrix4d[3][1] * right.m_matrix4d[1][2] + m_matrix4d[3][2] * right.m_matrix4d[2][2] + m_matrix4d[3][3] * right.m_matrix4d[3][2];
+		result.m_matrix4d[3][3] = m_matrix4d[3][0] * right.m_matrix4d[0][3] + m_matrix4d[3][1] * right.m_matrix4d[1][3] + m_matrix4d[3][2] * right.m_matrix4d[2][3] + m_matrix4d[3][3] * right.m_matrix4d[3][3];
+		
+		return result;
+	}
+
+	inline XYZ Matrix4d::OfPoint(const XYZ& point)
+	{
+		double x = m_matrix4d[0][0] * point[0] + m_matrix4d[0][1] * point[1] + m_matrix4d[0][2] * point[2] + m_matrix4d[0][3] * 1;
+		double y = m_matrix4d[1][0] * point[0] + m_matrix4d[1][1] * point[1] + m_matrix4d[1][2] * point[2] + m_matrix4d[1][3] * 1;
+		double z = m_matrix4d[2][0] * point[0] + m_matrix4d[2][1] * point[1] + m_matrix4d[2][2] * point[2] + m_matrix4d[2][3] * 1;
+		
+		double w = m_matrix4d[3][0] * point[0] + m_matrix4d[3][1] * point[1] + m_matrix4d[3][2] * point[2] + m_matrix4d[3][3] * 1;
+		
+		return XYZ(x,y,z)/w;
+	}
+
+	inline XYZW Matrix4d::OfWeightedPoint(const XYZW& point)
+	{
+		double x = m_matrix4d[0][0] * point[0] + m_matrix4d[0][1] * point[1] + m_matrix4d[0][2] * point[2] + m_matrix4d[0][3] * point[3];
+		double y = m_matrix4d[1][0] * point[0] + m_matrix4d[1][1] * point[1] + m_matrix4d[1][2] * point[2] + m_matrix4d[1][3] * point[3];
+		double z = m_matrix4d[2][0] * point[0] + m_matrix4d[2][1] * point[1] + m_matrix4d[2][2] * point[2] + m_matrix4d[2][3] * point[3];
+
+		double w = m_matrix4d[3][0] * point[0] + m_matrix4d[3][1] * point[1] + m_matrix4d[3][2] * point[2] + m_matrix4d[3][3] * point[3];
+
+		return XYZW(XYZ(x,y,z),w);
+	}
+
+	inline XYZ Matrix4d::OfVector(const XYZ& vector)
+	{
+		double x = m_matrix4d[0][0] * vector[0] + m_matrix4d[0][1] * vector[1] + m_matrix4d[0][2] * vector[2];
+		double y = m_matrix4d[1][0] * vector[0] + m_matrix4d[1][1] * vector[1] + m_matrix4d[1][2] * vector[2];
+		double z = m_matrix4d[2][0] * vector[0] + m_matrix4d[2][1] * vector[1] + m_matrix4d[2][2] * vector[2];
+
+		return XYZ(x,y,z);
+	}
+
+	inline Matrix4d Matrix4d::GetTranspose()
+	{
+		return Matrix4d(m_matrix4d[0][0], m_matrix4d[1][0], m_matrix4d[2][0], m_matrix4d[3][0],
+			            m_matrix4d[0][1], m_matrix4d[1][1], m_matrix4d[2][1], m_matrix4d[3][1],
+			            m_matrix4d[0][2], m_matrix4d[1][2], m_matrix4d[2][2], m_matrix4d[3][2],
+			            m_matrix4d[0][3], m_matrix4d[1][3], m_matrix4d[2][3], m_matrix4d[3][3]);
+	}
+
 	LNLIB_EXPORT Matrix4d operator *(const Matrix4d& left, const Matrix4d& right);
 	LNLIB_EXPORT Matrix4d operator +(const Matrix4d& left, const Matrix4d& right);
 	LNLIB_EXPORT Matrix4d operator -(const Matrix4d& left, const Matrix4d& right);
@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "Constants.h"
 #include "LNEnums.h"
 #include "LNLibDefinitions.h"
 #include "LNObject.h"
@@ -21,11 +22,16 @@ namespace LNLib
 	class XYZ;
 	class XYZW;
 	class Matrix4d;
+	class CurveTessellationSink;
 	class LNLIB_EXPORT NurbsCurve
 	{
 	public:
 
-		static void Check(const LN_NurbsCurve& curve);
+		/// <summary>
+		/// Validates degree, knot vector and control points once, and records whether any weight differs from 1.
+		/// The returned handle can be passed to the evaluation overloads below, which then skip validation.
+		/// </summary>
+		static LN_CheckedNurbsCurve Check(const LN_NurbsCurve& curve);
 
 		/// <summary>
 		/// The NURBS Book 2nd Edition Page124
@@ -33,6 +39,7 @@ namespace LNLib
 		/// Compute point on rational B-spline curve.
 		/// </summary>
 		static XYZ GetPointOnCurve(const LN_NurbsCurve& curve, double paramT);
+		static XYZ GetPointOnCurve(const LN_CheckedNurbsCurve& curve, double paramT);
 
 		/// <summary>
 		/// The NURBS Book 2nd Edition Page127
@@ -40,10 +47,53 @@ namespace LNLib
 		/// Compute C(paramT) derivatives from Cw(paramT) deraivatives.
 		/// </summary>
 		static std::vector<XYZ> ComputeRationalCurveDerivatives(const LN_NurbsCurve& curve, int derivative, double paramT);
+		static std::vector<XYZ> ComputeRationalCurveDerivatives(const LN_CheckedNurbsCurve& curve, int derivative, double paramT);
+
+		/// <summary>
+		/// Batch forms of A4.1 and A4.2. The curve is validated once for the whole batch,
+		/// and sorted paramTs are evaluated by walking the knot spans forward instead of searching each one.
+		/// derivatives[i] holds the derivatives at paramTs[i].
+		/// </summary>
+		static void GetPointsOnCurve(const LN_NurbsCurve& curve, const std::vector<double>& paramTs, std::vector<XYZ>& points);
+		static void GetPointsOnCurve(const LN_CheckedNurbsCurve& curve, const std::vector<double>& paramTs, std::vector<XYZ>& points);
+		static void ComputeRationalCurveDerivatives(const LN_NurbsCurve& curve, int derivative, const std::vector<double>& paramTs, std::vector<std::vector<XYZ>>& derivatives);
+		static void ComputeRationalCurveDerivatives(const LN_CheckedNurbsCurve& curve, int derivative, const std::vector<double>& paramTs, std::vector<std::vector<XYZ>>& derivatives);
+
+		/// <summary>
+		/// Flat batch form of A4.2: derivatives[i * (derivative + 1) + k] is the kth derivative at paramTs[i].
+		/// The quotient rule runs over the batch buffers, with binomials from MathUtils::BinomialRow and no allocation per parameter.
+		/// </summary>
+		static void ComputeRationalCurveDerivatives(const LN_NurbsCurve& curve, int derivative, const std::vector<double>& paramTs, std::vector<XYZ>& derivatives);
+		static void ComputeRationalCurveDerivatives(const LN_CheckedNurbsCurve& curve, int derivative, const std::vector<double>& paramTs, std::vector<XYZ>& derivatives);
+
+		/// <summary>
+		/// Validates the curve and builds its structure-of-arrays form for the SIMD kernels (see SimdKernels).
+		/// </summary>
+		static LN_CompiledNurbsCurve Compile(const LN_NurbsCurve& curve);
+		static void GetPointsOnCurve(const LN_CompiledNurbsCurve& curve, const std::vector<double>& paramTs, std::vector<XYZ>& points);
+
+		/// <summary>
+		/// Converts the curve once into per-span power basis coefficients: DecomposeToBeziers, then Polynomials::BezierToPowerMatrix.
+		/// Evaluation is then a span lookup plus Horner on the weighted coordinates.
+		/// </summary>
+		static LN_PowerBasisCurve ToPowerBasis(const LN_NurbsCurve& curve);
+		static XYZ GetPointOnCurve(const LN_PowerBasisCurve& curve, double paramT);
+		static std::vector<XYZ> ComputeRationalCurveDerivatives(const LN_PowerBasisCurve& curve, int derivative, double paramT);
 
+		/// <summary>
+		/// Coefficients of Cw'(t), the derivative of the weighted curve with respect to t, over the same spans and local parameters.
+		/// The result has degree curve.Degree - 1; apply again for higher derivatives.
+		/// </summary>
+		static LN_PowerBasisCurve Differentiate(const LN_PowerBasisCurve& curve);
+
+		/// <summary>
+		/// The checked overloads skip the quotient rule for curves with unit weights (see LN_CheckedNurbsCurve::IsRational()).
+		/// </summary>
 		static double Curvature(const LN_NurbsCurve& curve, double paramT);
+		static double Curvature(const LN_CheckedNurbsCurve& curve, double paramT);
 
 		static XYZ Normal(const LN_NurbsCurve& curve, CurveNormal normalType, double paramT);
+		static XYZ Normal(const LN_CheckedNurbsCurve& curve, CurveNormal normalType, double paramT);
 
 		static double Torsion(const LN_NurbsCurve& curve, double paramT);
 
@@ -102,6 +152,19 @@ namespace LNLib
 		/// Equally spaced parameter values on each candidate span.
 		/// </summary>
 		static void EquallyTessellate(const LN_NurbsCurve& curve, std::vector<XYZ>& tessellatedPoints, std::vector<double>& correspondingKnots);
+		static void EquallyTessellate(const LN_NurbsCurve& curve, CurveTessellationSink& sink);
+
+		/// <summary>
+		/// Tolerance-driven tessellation: every Bezier segment is bisected recursively until each edge meets the chord height,
+		/// angle and edge length limits of tolerance. Flat spans end up with few points and tight bends with many.
+		/// </summary>
+		static void AdaptiveTessellate(const LN_NurbsCurve& curve, const LN_TessellationTolerance& tolerance, std::vector<XYZ>& tessellatedPoints, std::vector<double>& correspondingKnots);
+
+		/// <summary>
+		/// Streaming forms of the tessellators: sink receives the points of one knot span (or Bezier segment) at a time,
+		/// so memory stays bounded by the largest span instead of the whole polyline.
+		/// </summary>
+		static void AdaptiveTessellate(const LN_NurbsCurve& curve, const LN_TessellationTolerance& tolerance, CurveTessellationSink& sink);
 
 		static bool IsClosed(const LN_NurbsCurve& curve);
 
@@ -111,6 +174,25 @@ namespace LNLib
 		/// </summary>
 		static double GetParamOnCurve(const LN_NurbsCurve& curve, const XYZ& givenPoint);
 
+		/// <summary>
+		/// Builds a reusable point inversion accelerator: the Bezier segments of DecomposeToBeziers are subdivided until their control
+		/// polygons are flat, and the pieces are bounded by the boxes of their control points in a balanced hierarchy.
+		/// The query visits boxes nearest first, runs Newton only on pieces whose box is closer than the best point found so far,
+		/// and stops at the first farther box, so its cost grows with the depth of the hierarchy instead of the size of the curve.
+		/// Weights must be positive, so that every piece lies inside the box of its control points.
+		/// </summary>
+		static LN_CurveBVH BuildBVH(const LN_NurbsCurve& curve);
+		static double GetParamOnCurve(const LN_CurveBVH& bvh, const XYZ& givenPoint);
+
+		/// <summary>
+		/// Projects many points at once: params[i] and distances[i] belong to the closest point of the curve to points[i].
+		/// One BVH serves every query. Points are taken in blocks of consecutive inputs, and each query first projects onto the piece
+		/// that held the previous answer, which bounds the search immediately when the points are spatially coherent (e.g. scan lines).
+		/// Blocks run on the threads of policy; results do not depend on the thread count.
+		/// </summary>
+		static void GetParamsOnCurve(const LN_NurbsCurve& curve, const std::vector<XYZ>& points, std::vector<double>& params, std::vector<double>& distances, const LN_ExecutionPolicy& policy = LN_ExecutionPolicy());
+		static void GetParamsOnCurve(const LN_CurveBVH& bvh, const std::vector<XYZ>& points, std::vector<double>& params, std::vector<double>& distances, const LN_ExecutionPolicy& policy = LN_ExecutionPolicy());
+
 		/// <summary>
 		/// The NURBS Book 2nd Edition Page236
 		/// Curve make Transform.
@@ -313,9 +395,58 @@ namespace LNLib
 		/// </summary>
 		static double ApproximateLength(const LN_NurbsCurve& curve, IntegratorType type);
 
+		/// <summary>
+		/// Parameter at arc length givenLength from the start, looked up in an arc length table (see BuildArcLengthTable).
+		/// type is kept for source compatibility; the table always integrates with Gauss-Legendre.
+		/// </summary>
 		static double GetParamOnCurve(const LN_NurbsCurve& curve, double givenLength, IntegratorType type);
 
+		/// <summary>
+		/// Builds an arc length table: every Bezier segment of DecomposeToBeziers is halved until 24 point Gauss-Legendre integration of |C'|
+		/// over each interval agrees with the sum over its halves within tolerance, and the cumulative lengths at the interval ends are stored.
+		/// Segments are integrated on the threads of policy. The queries below then cost a binary search plus a few integrations over
+		/// a single interval, O(log n) in the size of the curve, so a table kept per curve answers repeated length queries without integrating again.
+		/// </summary>
+		static LN_ArcLengthTable BuildArcLengthTable(const LN_NurbsCurve& curve, const LN_IntegrationTolerance& tolerance = LN_IntegrationTolerance(), const LN_ExecutionPolicy& policy = LN_ExecutionPolicy());
+
+		/// <summary>
+		/// Length of the curve to the given tolerance (see BuildArcLengthTable).
+		/// </summary>
+		static double ApproximateLength(const LN_NurbsCurve& curve, const LN_IntegrationTolerance& tolerance, const LN_ExecutionPolicy& policy = LN_ExecutionPolicy());
+
+		/// <summary>
+		/// Arc length from the start of the curve to paramT.
+		/// </summary>
+		static double ApproximateLength(const LN_ArcLengthTable& table, double paramT);
+
+		/// <summary>
+		/// Arc length between startT and endT, from the cumulative lengths of the table.
+		/// </summary>
+		static double ApproximateLength(const LN_ArcLengthTable& table, double startT, double endT);
+
+		/// <summary>
+		/// Parameter at arc length givenLength from the start: the interval is found by binary search on Lengths, and the parameter, first
+		/// interpolated linearly in it, is refined by Newton steps t -= (L(t) - givenLength) / |C'(t)|, bisecting whenever a step leaves the bracket.
+		/// </summary>
+		static double GetParamOnCurve(const LN_ArcLengthTable& table, double givenLength);
+
+		/// <summary>
+		/// Parameters at arc lengths givenLength, 2 * givenLength, ... before the end of the curve (see DivideByLength).
+		/// type is kept for source compatibility.
+		/// </summary>
 		static std::vector<double> GetParamsOnCurve(const LN_NurbsCurve& curve, double givenLength, IntegratorType type);
+
+		/// <summary>
+		/// Divides the curve into pieces of segmentLength, measured along the arc or as chords, in a single walk over the table.
+		/// Returns the parameters of the division points, excluding the start and end of the curve; the last piece is the remainder.
+		/// </summary>
+		static std::vector<double> DivideByLength(const LN_ArcLengthTable& table, double segmentLength, CurveDivisionType type = CurveDivisionType::ArcLength);
+
+		/// <summary>
+		/// Divides the curve into count pieces of equal arc length or equal chord length, returning the count - 1 interior division parameters.
+		/// Arc lengths are exact to the table accuracy; for chords the chord length is bisected until the last chord differs from the others by at most tolerance.
+		/// </summary>
+		static std::vector<double> DivideByCount(const LN_ArcLengthTable& table, int count, CurveDivisionType type = CurveDivisionType::ArcLength, double tolerance = Constants::DistanceEpsilon);
 	};
 }
 
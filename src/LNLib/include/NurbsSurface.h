@@ -19,11 +19,16 @@ namespace LNLib
 	class UV;
 	class XYZ;
 	class XYZW;
+	class SurfaceTessellationSink;
 	class LNLIB_EXPORT NurbsSurface
 	{
 	public:
 
-		static void Check(const LN_NurbsSurface& surface);
+		/// <summary>
+		/// Validates degrees, knot vectors and control points once, and records whether any weight differs from 1.
+		/// The returned handle can be passed to the evaluation overloads below, which then skip validation.
+		/// </summary>
+		static LN_CheckedNurbsSurface Check(const LN_NurbsSurface& surface);
 
 		/// <summary>
 		/// The NURBS Book 2nd Edition Page134
@@ -31,6 +36,7 @@ namespace LNLib
 		/// Compute point on rational B-spline surface.
 		/// </summary>
 		static XYZ GetPointOnSurface(const LN_NurbsSurface& surface, UV uv);
+		static XYZ GetPointOnSurface(const LN_CheckedNurbsSurface& surface, UV uv);
 
 		/// <summary>
 		/// The NURBS Book 2nd Edition Page137
@@ -38,10 +44,47 @@ namespace LNLib
 		/// Compute S(paramU,paramV) derivatives.
 		/// </summary>
 		static std::vector<std::vector<XYZ>> ComputeRationalSurfaceDerivatives(const LN_NurbsSurface& surface, int derivative, UV uv);
+		static std::vector<std::vector<XYZ>> ComputeRationalSurfaceDerivatives(const LN_CheckedNurbsSurface& surface, int derivative, UV uv);
+
+		/// <summary>
+		/// Batch form of A4.4: derivatives[(i * (derivative + 1) + k) * (derivative + 1) + l] is SKL[k][l] at uvs[i], zero where k + l > derivative.
+		/// The surface is validated once, and the quotient rule reads binomials from MathUtils::BinomialRow with no allocation per parameter.
+		/// </summary>
+		static void ComputeRationalSurfaceDerivatives(const LN_NurbsSurface& surface, int derivative, const std::vector<UV>& uvs, std::vector<XYZ>& derivatives);
+		static void ComputeRationalSurfaceDerivatives(const LN_CheckedNurbsSurface& surface, int derivative, const std::vector<UV>& uvs, std::vector<XYZ>& derivatives);
 
+		/// <summary>
+		/// The checked overloads skip the quotient rule for surfaces with unit weights (see LN_CheckedNurbsSurface::IsRational()).
+		/// </summary>
 		static double Curvature(const LN_NurbsSurface& surface, SurfaceCurvature curvature, UV uv);
+		static double Curvature(const LN_CheckedNurbsSurface& surface, SurfaceCurvature curvature, UV uv);
 
 		static XYZ Normal(const LN_NurbsSurface& surface, UV uv);
+		static XYZ Normal(const LN_CheckedNurbsSurface& surface, UV uv);
+
+		/// <summary>
+		/// Evaluates the tensor-product grid uParams x vParams, computing each basis once per parameter value instead of once per grid point.
+		/// points[i * vParams.size() + j] is S(uParams[i], vParams[j]); normals, when requested, are laid out the same way.
+		/// With a parallel policy, blocks of uParams rows are evaluated on separate threads.
+		/// </summary>
+		static void EvaluateGrid(const LN_NurbsSurface& surface, const std::vector<double>& uParams, const std::vector<double>& vParams, std::vector<XYZ>& points, const LN_ExecutionPolicy& policy = LN_ExecutionPolicy());
+		static void EvaluateGrid(const LN_NurbsSurface& surface, const std::vector<double>& uParams, const std::vector<double>& vParams, std::vector<XYZ>& points, std::vector<XYZ>& normals, const LN_ExecutionPolicy& policy = LN_ExecutionPolicy());
+		static void EvaluateGrid(const LN_CheckedNurbsSurface& surface, const std::vector<double>& uParams, const std::vector<double>& vParams, std::vector<XYZ>& points, const LN_ExecutionPolicy& policy = LN_ExecutionPolicy());
+		static void EvaluateGrid(const LN_CheckedNurbsSurface& surface, const std::vector<double>& uParams, const std::vector<double>& vParams, std::vector<XYZ>& points, std::vector<XYZ>& normals, const LN_ExecutionPolicy& policy = LN_ExecutionPolicy());
+
+		/// <summary>
+		/// Validates the surface and builds its structure-of-arrays form for the SIMD kernels (see SimdKernels).
+		/// </summary>
+		static LN_CompiledNurbsSurface Compile(const LN_NurbsSurface& surface);
+		static void EvaluateGrid(const LN_CompiledNurbsSurface& surface, const std::vector<double>& uParams, const std::vector<double>& vParams, std::vector<XYZ>& points);
+
+		/// <summary>
+		/// Converts the surface once into per-patch power basis coefficients: DecomposeToBeziers, then Polynomials::BezierToPowerMatrix in both directions.
+		/// Evaluation is then a patch lookup plus the nested Horner of the 2D Polynomials::Horner on the weighted coordinates.
+		/// </summary>
+		static LN_PowerBasisSurface ToPowerBasis(const LN_NurbsSurface& surface);
+		static XYZ GetPointOnSurface(const LN_PowerBasisSurface& surface, UV uv);
+		static std::vector<std::vector<XYZ>> ComputeRationalSurfaceDerivatives(const LN_PowerBasisSurface& surface, int derivative, UV uv);
 
 		static void Swap(const LN_NurbsSurface& surface, LN_NurbsSurface& result);
 
@@ -92,6 +135,31 @@ namespace LNLib
 		/// Equally spaced parameter values on each candidate span.
 		/// </summary>
 		static void EquallyTessellate(const LN_NurbsSurface& surface, std::vector<XYZ>& tessellatedPoints, std::vector<UV>& correspondingKnots);
+		static void EquallyTessellate(const LN_NurbsSurface& surface, SurfaceTessellationSink& sink);
+
+		/// <summary>
+		/// Tolerance-driven triangulation into an indexed mesh. Each Bezier patch is bisected along u and v until its isoparametric
+		/// edges meet the chord height, normal angle and edge length limits of tolerance. The splits of a patch are shared by its
+		/// whole row (or column) of patches, so the mesh is a conforming grid without cracks or T-junctions.
+		/// With a parallel policy, rows and columns of patches are refined on separate threads; the mesh is the same for any thread count.
+		/// </summary>
+		static void AdaptiveTessellate(const LN_NurbsSurface& surface, const LN_TessellationTolerance& tolerance, LN_Mesh& mesh, const LN_ExecutionPolicy& policy = LN_ExecutionPolicy());
+
+		/// <summary>
+		/// Streaming forms of the tessellators: sink receives the vertices (and triangles) of one row of knot spans at a time,
+		/// so memory stays bounded by one row instead of the whole mesh. With a parallel policy, each thread evaluates one row
+		/// ahead and the sink still receives the rows in order, from whichever thread finished the previous one.
+		/// </summary>
+		static void AdaptiveTessellate(const LN_NurbsSurface& surface, const LN_TessellationTolerance& tolerance, SurfaceTessellationSink& sink, const LN_ExecutionPolicy& policy = LN_ExecutionPolicy());
+
+		/// <summary>
+		/// Tessellates adjacent surfaces into one watertight mesh. Boundary sides lying on the same curve, of two surfaces or of a closed one,
+		/// are matched by their ends and quarter points within Constants::DistanceEpsilon. A shared side is split wherever either neighbour needs it,
+		/// so it meets the tighter of their tolerances, and its vertices are emitted once and referenced by the triangles of both sides.
+		/// tolerances holds one entry per surface or a single entry for all. A shared vertex keeps the normal and UV of the surface that emitted it first.
+		/// Throws std::invalid_argument when the splits of a shared side cannot be made to agree on both neighbours.
+		/// </summary>
+		static void AdaptiveTessellate(const std::vector<LN_NurbsSurface>& surfaces, const std::vector<LN_TessellationTolerance>& tolerances, LN_Mesh& mesh, const LN_ExecutionPolicy& policy = LN_ExecutionPolicy());
 
 		///  [0][0]  [0][1] ... ...  [0][m]     ------- v direction
 		///  [1][0]  [1][1] ... ...  [1][m]    |
@@ -107,6 +175,25 @@ namespace LNLib
 		/// </summary>
 		static UV GetParamOnSurface(const LN_NurbsSurface& surface, const XYZ& givenPoint);
 
+		/// <summary>
+		/// Builds a reusable point inversion accelerator: the Bezier patches of DecomposeToBeziers are subdivided until every row and column
+		/// of their control nets is flat, and the pieces are bounded by the boxes of their control points in a hierarchy split at the median
+		/// along the longest axis. The query visits boxes nearest first, runs Newton on a piece only while its box is closer than the best
+		/// point found so far, and stops at the first farther box. Weights must be positive, so that every piece lies inside its box.
+		/// </summary>
+		static LN_SurfaceBVH BuildBVH(const LN_NurbsSurface& surface);
+		static UV GetParamOnSurface(const LN_SurfaceBVH& bvh, const XYZ& givenPoint);
+
+		/// <summary>
+		/// Projects many points at once, e.g. a scan against its CAD surface. For points[i], params[i] and closestPoints[i] give the closest point
+		/// of the surface and signedDistances[i] its distance, positive on the side the normal Su x Sv points to.
+		/// statistics summarizes the signed distances with a histogram of histogramBinCount bins.
+		/// One BVH serves every query. Points are taken in fixed blocks of consecutive inputs, each query first projecting onto the piece of
+		/// the previous answer; blocks run on the threads of policy and results do not depend on the thread count.
+		/// </summary>
+		static void GetParamsOnSurface(const LN_NurbsSurface& surface, const std::vector<XYZ>& points, std::vector<UV>& params, std::vector<XYZ>& closestPoints, std::vector<double>& signedDistances, LN_DeviationStatistics& statistics, int histogramBinCount = 20, const LN_ExecutionPolicy& policy = LN_ExecutionPolicy());
+		static void GetParamsOnSurface(const LN_SurfaceBVH& bvh, const std::vector<XYZ>& points, std::vector<UV>& params, std::vector<XYZ>& closestPoints, std::vector<double>& signedDistances, LN_DeviationStatistics& statistics, int histogramBinCount = 20, const LN_ExecutionPolicy& policy = LN_ExecutionPolicy());
+
 		static void Reparametrize(const LN_NurbsSurface& surface, double minU, double maxU, double minV, double maxV, LN_NurbsSurface& result);
 
 		/// <summary>
@@ -228,10 +315,19 @@ namespace LNLib
 		/// <summary>
 		/// Calculate surface area.
 		/// 
-		/// Use Simpson integration for low accuracy.
+		/// Use Simpson integration for low accuracy; it now runs the adaptive engine below to a relative tolerance of 1E-6.
 		/// Use Gauss-Legendre integration for medium accuracy.
 		/// Use Chebyshev integration for high accuracy.
+		/// Gauss-Legendre integrates the Bezier patches in parallel under a parallel policy and sums them in patch order.
+		/// </summary>
+		static double ApproximateArea(const LN_NurbsSurface& surface, IntegratorType type, const LN_ExecutionPolicy& policy = LN_ExecutionPolicy());
+
+		/// <summary>
+		/// Surface area to the given tolerance, with the per patch breakdown. Every Bezier patch of DecomposeToBeziers is integrated by
+		/// adaptive tensor product Gauss-Kronrod cubature of |Su x Sv| (see Integrator::GaussKronrodCubature), with a share of the absolute
+		/// tolerance proportional to its parameter area. Non-rational patches evaluate Su and Sv from the Bernstein forms of their derivative nets,
+		/// reusing the basis along grid lines; rational patches use the batch derivatives. Patches run on the threads of policy and are summed in order.
 		/// </summary>
-		static double ApproximateArea(const LN_NurbsSurface& surface, IntegratorType type);
+		static LN_SurfaceArea ApproximateArea(const LN_NurbsSurface& surface, const LN_IntegrationTolerance& tolerance, const LN_ExecutionPolicy& policy = LN_ExecutionPolicy());
 	};
 }
@@ -0,0 +1,35 @@
+/*
+ * Author:
+ * 2026/10/16 - LNLib contributors
+ * Individual authors are recorded in the git history of this file.
+ *
+ * Use of this source code is governed by a GPL-3.0 license that can be found in
+ * the LICENSE file.
+ */
+
+#pragma once
+
+#include "LNLibDefinitions.h"
+#include "LNObject.h"
+#include <functional>
+
+namespace LNLib
+{
+	class LNLIB_EXPORT ParallelUtils
+	{
+	public:
+
+		/// <summary>
+		/// Number of threads policy asks for: policy.ThreadCount, or every hardware thread when it is 0.
+		/// </summary>
+		static int GetThreadCount(const LN_ExecutionPolicy& policy);
+
+		/// <summary>
+		/// Runs body(0) ... body(count - 1) on up to GetThreadCount(policy) threads, the calling thread included.
+		/// Threads claim the next unprocessed index from a shared counter, so uneven items balance out without a static partition.
+		/// body must write its result only to slots owned by its index; merging them in index order keeps results deterministic.
+		/// The first exception thrown by body is rethrown after all threads have finished.
+		/// </summary>
+		static void For(int count, const LN_ExecutionPolicy& policy, const std::function<void(int)>& body);
+	};
+}
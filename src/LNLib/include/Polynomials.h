@@ -11,6 +11,7 @@
 #pragma once
 
 #include "LNLibDefinitions.h"
+#include "LNObject.h"
 #include <vector>
 #include <unordered_map>
 
@@ -58,6 +59,43 @@ namespace LNLib
 		/// </summary>
 		static double Horner(int degreeU, int degreeV, const std::vector<std::vector<double>>& coefficients, UV& uv);
 
+		/// <summary>
+		/// Unchecked A1.1 over degree + 1 coefficients of any type with scalar multiplication and addition (double, XYZW, ...).
+		/// HornerDerivativeUnchecked evaluates the derivative-th derivative of the same polynomial without building its coefficients.
+		/// </summary>
+		template <typename T>
+		static T HornerUnchecked(int degree, const T* coefficients, double paramT)
+		{
+			T result = coefficients[degree];
+			for (int i = degree - 1; i >= 0; i--)
+			{
+				result = result * paramT + coefficients[i];
+			}
+			return result;
+		}
+
+		template <typename T>
+		static T HornerDerivativeUnchecked(int degree, int derivative, const T* coefficients, double paramT)
+		{
+			if (derivative > degree)
+			{
+				return T();
+			}
+			// factor = i! / (i - derivative)!, updated as i counts down.
+			double factor = 1.0;
+			for (int i = 0; i < derivative; i++)
+			{
+				factor *= degree - i;
+			}
+			T result = factor * coefficients[degree];
+			for (int i = degree - 1; i >= derivative; i--)
+			{
+				factor = factor * (i + 1 - derivative) / (i + 1);
+				result = result * paramT + factor * coefficients[i];
+			}
+			return result;
+		}
+
 		/// <summary>
 		/// The NURBS Book 2nd Edition Page63
 		/// Get the knot multiplicity.
@@ -70,6 +108,7 @@ namespace LNLib
 		/// Determine the knot span index.
 		/// </summary>
 		static int GetKnotSpanIndex(int degree, const std::vector<double>& knotVector, double paramT);
+		static int GetKnotSpanIndex(int degree, const LN_ArrayView<double>& knotVector, double paramT);
 
 		/// <summary>
 		/// The NURBS Book 2nd Edition Page70
@@ -77,6 +116,7 @@ namespace LNLib
 		/// Compute the nonvanishing basis functions.
 		/// </summary>
 		static std::vector<double> BasisFunctions(int spanIndex, int degree, const std::vector<double>& knotVector, double paramT);
+		static std::vector<double> BasisFunctions(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double paramT);
 
 		/// <summary>
 		/// The NURBS Book 2nd Edition Page72
@@ -84,6 +124,7 @@ namespace LNLib
 		/// Compute nonzero basis functions and their derivative.
 		/// </summary>
 		static std::vector<std::vector<double>> BasisFunctionsDerivatives(int spanIndex, int degree, int derivative, const std::vector<double>& knotVector, double paramT);
+		static std::vector<std::vector<double>> BasisFunctionsDerivatives(int spanIndex, int degree, int derivative, const LN_ArrayView<double>& knotVector, double paramT);
 
 		/// <summary>
 		/// The NURBS Book 2nd Edition Page74
@@ -104,6 +145,167 @@ namespace LNLib
 		/// A simple modification of A2.2 to return all nonzero basis functions of all degrees from 0 up to degree.
 		/// </summary>
 		static std::vector<std::vector<double>> AllBasisFunctions(int spanIndex, int degree, const std::vector<double>& knotVector, double knot);
+		static std::vector<std::vector<double>> AllBasisFunctions(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double knot);
+
+		/// <summary>
+		/// Unchecked variants of A2.1, A2.2, A2.3 and AllBasisFunctions.
+		/// Nothing is validated: the knot vector must already be known to be valid (see NurbsCurve::Check and NurbsSurface::Check)
+		/// and paramT must lie inside the knot range.
+		/// </summary>
+		static int GetKnotSpanIndexUnchecked(int degree, const LN_ArrayView<double>& knotVector, double paramT);
+		static std::vector<double> BasisFunctionsUnchecked(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double paramT);
+		static std::vector<std::vector<double>> BasisFunctionsDerivativesUnchecked(int spanIndex, int degree, int derivative, const LN_ArrayView<double>& knotVector, double paramT);
+		static std::vector<std::vector<double>> AllBasisFunctionsUnchecked(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double knot);
+
+		/// <summary>
+		/// Highest degree whose basis function scratch fits on the stack.
+		/// Higher degrees still work, they just allocate.
+		/// </summary>
+		static const int MaxStackDegree = 15;
+
+		/// <summary>
+		/// Allocation-free forms of the unchecked A2.2, A2.3 and AllBasisFunctions, writing into caller-supplied buffers:
+		/// basisFunctions holds degree + 1 values;
+		/// derivatives holds (derivative + 1) * (degree + 1) values, N(k)[j] at derivatives[k * (degree + 1) + j], with derivative <= degree;
+		/// allBasisFunctions holds (degree + 1) * (degree + 1) values, AllBasisFunctions()[j][i] at allBasisFunctions[j * (degree + 1) + i].
+		/// Degrees 1 to 5 dispatch to the fixed-degree templates below.
+		/// </summary>
+		static void BasisFunctionsUnchecked(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double paramT, double* basisFunctions);
+		static void BasisFunctionsDerivativesUnchecked(int spanIndex, int degree, int derivative, const LN_ArrayView<double>& knotVector, double paramT, double* derivatives);
+		static void AllBasisFunctionsUnchecked(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double knot, double* allBasisFunctions);
+
+		/// <summary>
+		/// A2.1 for sorted parameter sequences: starts from the span found for the previous parameter and walks forward.
+		/// Falls back to the binary search when hintSpanIndex is not a valid span or paramT lies before it.
+		/// </summary>
+		static int GetKnotSpanIndexUnchecked(int degree, const LN_ArrayView<double>& knotVector, double paramT, int hintSpanIndex);
+
+		/// <summary>
+		/// The denominators right[r + 1] + left[j - r] of A2.2 only depend on the span, not on paramT.
+		/// ComputeInverseDenominators writes their reciprocals (degree * (degree + 1) / 2 values, [j * (j - 1) / 2 + r])
+		/// so that every parameter inside the same span can reuse them. They are also the lower triangle of ndu in A2.3.
+		/// </summary>
+		static void ComputeInverseDenominators(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double* inverseDenominators);
+		static void BasisFunctionsUnchecked(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double paramT, const double* inverseDenominators, double* basisFunctions);
+		static void BasisFunctionsDerivativesUnchecked(int spanIndex, int degree, int derivative, const LN_ArrayView<double>& knotVector, double paramT, const double* inverseDenominators, double* derivatives);
+
+		/// <summary>
+		/// Fixed-degree A2.2 and A2.3.
+		/// left, right, ndu and a are stack arrays sized by Degree and every loop bound but derivative is a compile-time constant,
+		/// so the compiler fully unrolls the recurrences and keeps the scratch in registers.
+		/// </summary>
+		template <int Degree>
+		static void BasisFunctionsUnchecked(int spanIndex, const LN_ArrayView<double>& knotVector, double paramT, double* basisFunctions)
+		{
+			double left[Degree + 1];
+			double right[Degree + 1];
+			double N[Degree + 1];
+			for (int j = 1; j <= Degree; j++)
+			{
+				left[j] = paramT - knotVector[spanIndex + 1 - j];
+				right[j] = knotVector[spanIndex + j] - paramT;
+			}
+
+			N[0] = 1.0;
+			for (int j = 1; j <= Degree; j++)
+			{
+				double saved = 0.0;
+				for (int r = 0; r < j; r++)
+				{
+					double temp = N[r] / (right[r + 1] + left[j - r]);
+					N[r] = saved + right[r + 1] * temp;
+					saved = left[j - r] * temp;
+				}
+				N[j] = saved;
+			}
+			for (int j = 0; j <= Degree; j++)
+			{
+				basisFunctions[j] = N[j];
+			}
+		}
+
+		template <int Degree>
+		static void BasisFunctionsDerivativesUnchecked(int spanIndex, int derivative, const LN_ArrayView<double>& knotVector, double paramT, double* derivatives)
+		{
+			const int n = Degree + 1;
+			double left[Degree + 1];
+			double right[Degree + 1];
+			double ndu[Degree + 1][Degree + 1];
+			double a[2][Degree + 1];
+			for (int j = 1; j <= Degree; j++)
+			{
+				left[j] = paramT - knotVector[spanIndex + 1 - j];
+				right[j] = knotVector[spanIndex + j] - paramT;
+			}
+
+			ndu[0][0] = 1.0;
+			for (int j = 1; j <= Degree; j++)
+			{
+				double saved = 0.0;
+				for (int r = 0; r < j; r++)
+				{
+					ndu[j][r] = right[r + 1] + left[j - r];
+					double temp = ndu[r][j - 1] / ndu[j][r];
+					ndu[r][j] = saved + right[r + 1] * temp;
+					saved = left[j - r] * temp;
+				}
+				ndu[j][j] = saved;
+			}
+
+			for (int j = 0; j <= Degree; j++)
+			{
+				derivatives[j] = ndu[j][Degree];
+			}
+
+			for (int r = 0; r <= Degree; r++)
+			{
+				int s1 = 0;
+				int s2 = 1;
+				a[0][0] = 1.0;
+
+				for (int k = 1; k <= derivative; k++)
+				{
+					double d = 0.0;
+					int rk = r - k;
+					int pk = Degree - k;
+
+					if (r >= k)
+					{
+						a[s2][0] = a[s1][0] / ndu[pk + 1][rk];
+						d = a[s2][0] * ndu[rk][pk];
+					}
+
+					int j1 = rk >= -1 ? 1 : -rk;
+					int j2 = r - 1 <= pk ? k - 1 : Degree - r;
+
+					for (int j = j1; j <= j2; j++)
+					{
+						a[s2][j] = (a[s1][j] - a[s1][j - 1]) / ndu[pk + 1][rk + j];
+						d += a[s2][j] * ndu[rk + j][pk];
+					}
+					if (r <= pk)
+					{
+						a[s2][k] = -a[s1][k - 1] / ndu[pk + 1][r];
+						d += a[s2][k] * ndu[r][pk];
+					}
+					derivatives[k * n + r] = d;
+
+					int temp = s1;
+					s1 = s2;
+					s2 = temp;
+				}
+			}
+
+			int r = Degree;
+			for (int k = 1; k <= derivative; k++)
+			{
+				for (int j = 0; j <= Degree; j++)
+				{
+					derivatives[k * n + j] *= r;
+				}
+				r *= Degree - k;
+			}
+		}
 
 		/// <summary>
 		/// The NURBS Book 2nd Edition Page269
@@ -118,6 +320,106 @@ namespace LNLib
 		/// Compute inverse of pth-degree Bezier matrix.
 		/// </summary>
 		static std::vector<std::vector<double>> PowerToBezierMatrix(int degree, const std::vector<std::vector<double>>& matrix);
+
+	private:
+
+		/// <summary>
+		/// Shared bodies of the buffer kernels. left[j] and right[j] of A2.2 are read straight from the knot vector,
+		/// so A2.2 needs no scratch at all; A2.3 takes ndu ((degree + 1) * (degree + 1)) and a (2 * (degree + 1)) from the caller.
+		/// </summary>
+		static inline void BasisFunctionsKernel(int spanIndex, int degree, const LN_ArrayView<double>& knotVector, double paramT, double* basisFunctions)
+		{
+			basisFunctions[0] = 1.0;
+			for (int j = 1; j <= degree; j++)
+			{
+				double saved = 0.0;
+				for (int r = 0; r < j; r++)
+				{
+					double right = knotVector[spanIndex + r + 1] - paramT;
+					double left = paramT - knotVector[spanIndex + 1 - j + r];
+					double temp = basisFunctions[r] / (right + left);
+					basisFunctions[r] = saved + right * temp;
+					saved = left * temp;
+				}
+				basisFunctions[j] = saved;
+			}
+		}
+
+		static inline void BasisFunctionsDerivativesKernel(int spanIndex, int degree, int derivative, const LN_ArrayView<double>& knotVector, double paramT, double* ndu, double* a, double* derivatives)
+		{
+			const int n = degree + 1;
+
+			ndu[0] = 1.0;
+			for (int j = 1; j <= degree; j++)
+			{
+				double saved = 0.0;
+				for (int r = 0; r < j; r++)
+				{
+					double right = knotVector[spanIndex + r + 1] - paramT;
+					double left = paramT - knotVector[spanIndex + 1 - j + r];
+					ndu[j * n + r] = right + left;
+					double temp = ndu[r * n + j - 1] / ndu[j * n + r];
+
+					ndu[r * n + j] = saved + right * temp;
+					saved = left * temp;
+				}
+				ndu[j * n + j] = saved;
+			}
+
+			for (int j = 0; j <= degree; j++)
+			{
+				derivatives[j] = ndu[j * n + degree];
+			}
+
+			for (int r = 0; r <= degree; r++)
+			{
+				double* a1 = a;
+				double* a2 = a + n;
+				a1[0] = 1.0;
+
+				for (int k = 1; k <= derivative; k++)
+				{
+					double d = 0.0;
+					int rk = r - k;
+					int pk = degree - k;
+
+					if (r >= k)
+					{
+						a2[0] = a1[0] / ndu[(pk + 1) * n + rk];
+						d = a2[0] * ndu[rk * n + pk];
+					}
+
+					int j1 = rk >= -1 ? 1 : -rk;
+					int j2 = r - 1 <= pk ? k - 1 : degree - r;
+
+					for (int j = j1; j <= j2; j++)
+					{
+						a2[j] = (a1[j] - a1[j - 1]) / ndu[(pk + 1) * n + rk + j];
+						d += a2[j] * ndu[(rk + j) * n + pk];
+					}
+					if (r <= pk)
+					{
+						a2[k] = -a1[k - 1] / ndu[(pk + 1) * n + r];
+						d += a2[k] * ndu[r * n + pk];
+					}
+					derivatives[k * n + r] = d;
+
+					double* swap = a1;
+					a1 = a2;
+					a2 = swap;
+				}
+			}
+
+			int r = degree;
+			for (int k = 1; k <= derivative; k++)
+			{
+				for (int j = 0; j <= degree; j++)
+				{
+					derivatives[k * n + j] *= r;
+				}
+				r *= degree - k;
+			}
+		}
 	};
 
 }
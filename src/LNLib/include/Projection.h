@@ -20,6 +20,16 @@ namespace LNLib
 	public:
 		static XYZ PointToRay(const XYZ& origin, const XYZ& vector, const XYZ& Point);
 		static bool PointToLine(const XYZ& start, const XYZ& end, const XYZ& point, XYZ& projectPoint);
+
+		/// <summary>
+		/// Distance from point to the infinite line through start and end, or to start when both coincide.
+		/// </summary>
+		static double DistanceToLine(const XYZ& start, const XYZ& end, const XYZ& point);
+
+		/// <summary>
+		/// Distance from point to the axis aligned box [min, max], 0 inside it.
+		/// </summary>
+		static double DistanceToBox(const XYZ& min, const XYZ& max, const XYZ& point);
 		static XYZ Stereographic(const XYZ& pointOnSphere, double radius);
 	};
 }
@@ -0,0 +1,47 @@
+/*
+ * Author:
+ * 2026/10/16 - LNLib contributors
+ * Individual authors are recorded in the git history of this file.
+ *
+ * Use of this source code is governed by a GPL-3.0 license that can be found in
+ * the LICENSE file.
+ */
+
+#pragma once
+
+#include "LNLibDefinitions.h"
+#include "LNObject.h"
+
+namespace LNLib
+{
+	class XYZ;
+	class LNLIB_EXPORT SimdKernels
+	{
+	public:
+
+		/// <summary>
+		/// True when the running CPU and OS support AVX2 and FMA. Detected once, at first use.
+		/// </summary>
+		static bool IsAVX2Supported();
+
+		/// <summary>
+		/// Allows forcing the scalar kernels, e.g. for bitwise reproducible results across machines.
+		/// The AVX2 kernels are used only while enabled and supported.
+		/// </summary>
+		static void SetAVX2Enabled(bool enabled);
+		static bool IsAVX2Enabled();
+
+		/// <summary>
+		/// Evaluates count points of a compiled curve. Parameters must lie inside the knot range.
+		/// The AVX2 kernel evaluates four parameters per iteration, gathering knots and control points per lane,
+		/// so sorted and unsorted parameters are both supported.
+		/// </summary>
+		static void GetPointsOnCurve(const LN_CompiledNurbsCurve& curve, const double* paramTs, int count, XYZ* points);
+
+		/// <summary>
+		/// Evaluates the grid uParams x vParams of a compiled surface, points[i * vCount + j] = S(uParams[i], vParams[j]).
+		/// Each u value contracts contiguous control net rows into one isoparametric curve, which is then evaluated four v values at a time.
+		/// </summary>
+		static void EvaluateGrid(const LN_CompiledNurbsSurface& surface, const double* uParams, int uCount, const double* vParams, int vCount, XYZ* points);
+	};
+}
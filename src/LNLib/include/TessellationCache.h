@@ -0,0 +1,87 @@
+/*
+ * Author:
+ * 2026/10/16 - LNLib contributors
+ * Individual authors are recorded in the git history of this file.
+ *
+ * Use of this source code is governed by a GPL-3.0 license that can be found in
+ * the LICENSE file.
+ */
+
+#pragma once
+
+#include "LNLibDefinitions.h"
+#include "LNObject.h"
+#include <vector>
+#include <list>
+#include <unordered_map>
+
+namespace LNLib
+{
+	/// <summary>
+	/// Level of detail cache of curve polylines and surface meshes. Each level is an adaptive tessellation tolerance,
+	/// generated the first time a curve or surface is requested at it. Entries are keyed by a hash of degree, knots and
+	/// control points, and the stored copy is compared exactly, so equal geometry shares its tessellations wherever it comes from.
+	/// Once generated, a level is returned by reference without allocating; references stay valid until Clear.
+	/// Not thread safe.
+	/// </summary>
+	class LNLIB_EXPORT TessellationCache
+	{
+	public:
+
+		/// <summary>
+		/// levels lists the tolerance tiers, e.g. from coarse to fine. policy is used when meshing surfaces.
+		/// </summary>
+		TessellationCache(const std::vector<LN_TessellationTolerance>& levels, const LN_ExecutionPolicy& policy = LN_ExecutionPolicy());
+
+		int GetLevelCount() const;
+		const LN_TessellationTolerance& GetLevel(int level) const;
+
+		/// <summary>
+		/// The coarsest level whose chord height does not exceed chordHeight, or the finest level when none does.
+		/// Viewers derive chordHeight from the camera distance, e.g. pixel size times distance.
+		/// </summary>
+		int SelectLevel(double chordHeight) const;
+
+		const LN_Polyline& GetTessellation(const LN_NurbsCurve& curve, int level);
+		const LN_Mesh& GetTessellation(const LN_NurbsSurface& surface, int level);
+
+		/// <summary>
+		/// Number of distinct curves (surfaces) held, and number of tessellations generated since construction or Clear.
+		/// </summary>
+		int GetCurveCount() const;
+		int GetSurfaceCount() const;
+		int GetGeneratedCount() const;
+
+		void Clear();
+
+		/// <summary>
+		/// FNV-1a hashes of degree, knots and control points (bitwise, weights included).
+		/// </summary>
+		static unsigned long long GetHash(const LN_NurbsCurve& curve);
+		static unsigned long long GetHash(const LN_NurbsSurface& surface);
+
+	private:
+
+		struct CurveEntry
+		{
+			LN_NurbsCurve Curve;
+			std::vector<LN_Polyline> Levels;
+			std::vector<bool> IsGenerated;
+		};
+
+		struct SurfaceEntry
+		{
+			LN_NurbsSurface Surface;
+			std::vector<LN_Mesh> Levels;
+			std::vector<bool> IsGenerated;
+		};
+
+		std::vector<LN_TessellationTolerance> m_levels;
+		LN_ExecutionPolicy m_policy;
+		std::unordered_map<unsigned long long, std::list<CurveEntry>> m_curves;
+		std::unordered_map<unsigned long long, std::list<SurfaceEntry>> m_surfaces;
+		int m_curveCount;
+		int m_surfaceCount;
+		int m_generatedCount;
+	};
+}
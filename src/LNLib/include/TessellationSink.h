@@ -0,0 +1,43 @@
+/*
+ * Author:
+ * 2026/10/16 - LNLib contributors
+ * Individual authors are recorded in the git history of this file.
+ *
+ * Use of this source code is governed by a GPL-3.0 license that can be found in
+ * the LICENSE file.
+ */
+
+#pragma once
+#include "LNLibDefinitions.h"
+
+namespace LNLib
+{
+	class XYZ;
+	class UV;
+
+	/// <summary>
+	/// Receives curve tessellation output chunk by chunk (one knot span or Bezier segment at a time),
+	/// so callers can write the points out without holding the whole polyline.
+	/// The arrays are only valid during the call.
+	/// </summary>
+	class LNLIB_EXPORT CurveTessellationSink
+	{
+	public:
+		virtual ~CurveTessellationSink() {}
+		virtual void AddPoints(const XYZ* points, const double* params, int count) = 0;
+	};
+
+	/// <summary>
+	/// Receives surface tessellation output chunk by chunk (one row of Bezier patches or knot spans at a time).
+	/// Vertices are numbered from 0 in the order they arrive; normals is null when the tessellator computes none.
+	/// Triangles hold three indices each and only refer to vertices that were already delivered.
+	/// The arrays are only valid during the call.
+	/// </summary>
+	class LNLIB_EXPORT SurfaceTessellationSink
+	{
+	public:
+		virtual ~SurfaceTessellationSink() {}
+		virtual void AddVertices(const XYZ* vertices, const XYZ* normals, const UV* uvs, int count) = 0;
+		virtual void AddTriangles(const int* indices, int triangleCount) = 0;
+	};
+}
@@ -12,30 +12,32 @@
 
 #include "Constants.h"
 #include "LNLibDefinitions.h"
+#include <math.h>
 
 namespace LNLib
 {
 	/// <summary>
 	/// Represents two-dimension location/vector/offset
+	/// Accessors and arithmetic are defined inline, like XYZ.
 	/// </summary>
 	class LNLIB_EXPORT UV
 	{
 
 	public:
 
-		UV();
-		UV(double u, double v);
+		constexpr UV() : m_uv{ 0, 0 } {}
+		constexpr UV(double u, double v) : m_uv{ u, v } {}
 
 	public:
 
 		void SetU(const double x);
-		double GetU() const;
+		constexpr double GetU() const { return m_uv[0]; }
 		void SetV(const double y);
-		double GetV() const;
+		constexpr double GetV() const { return m_uv[1]; }
 
-		double U() const;
+		constexpr double U() const { return m_uv[0]; }
 		double& U();
-		double V() const;
+		constexpr double V() const { return m_uv[1]; }
 		double& V();
 
 	public:
@@ -44,40 +46,108 @@ namespace LNLib
 		bool IsUnit(const double epsilon = Constants::DoubleEpsilon) const;
 		bool IsAlmostEqualTo(const UV& another) const;
 		double Length() const;
-		double SqrLength() const;
+		constexpr double SqrLength() const { return m_uv[0] * m_uv[0] + m_uv[1] * m_uv[1]; }
 		double AngleTo(const UV& another) const;
 		UV Normalize();
-		UV Add(const UV& another) const;
-		UV Substract(const UV& another) const;
-		UV Negative() const;
-		double DotProduct(const UV& another) const;
-		double CrossProduct(const UV& another) const;
+		constexpr UV Add(const UV& another) const { return UV(m_uv[0] + another.m_uv[0], m_uv[1] + another.m_uv[1]); }
+		constexpr UV Substract(const UV& another) const { return UV(m_uv[0] - another.m_uv[0], m_uv[1] - another.m_uv[1]); }
+		constexpr UV Negative() const { return UV(-m_uv[0], -m_uv[1]); }
+		constexpr double DotProduct(const UV& another) const { return m_uv[0] * another.m_uv[0] + m_uv[1] * another.m_uv[1]; }
+		constexpr double CrossProduct(const UV& another) const { return m_uv[0] * another.m_uv[1] - another.m_uv[0] * m_uv[1]; }
 		double Distance(const UV& another) const;
 
 	public:
 
-		UV& operator =(const UV& uv);
+		UV& operator =(const UV& uv) = default;
 		double& operator[](int index);
-		const double& operator[](int index) const;
-		UV operator +(const UV& uv) const;
-		UV operator -(const UV& uv) const;
-		double operator *(const UV& uv) const;
+		constexpr const double& operator[](int index) const { return m_uv[index]; }
+		constexpr UV operator +(const UV& uv) const { return Add(uv); }
+		constexpr UV operator -(const UV& uv) const { return Substract(uv); }
+		constexpr double operator *(const UV& uv) const { return DotProduct(uv); }
 		UV& operator *=(const double& d);
 		UV& operator /=(const double& d);
 		UV& operator +=(const UV& uv);
 		UV& operator -=(const UV& uv);
-		UV  operator-() const;
+		constexpr UV  operator-() const { return Negative(); }
 
 	private:
 
 		double m_uv[2];
 	};
 
-	LNLIB_EXPORT UV operator *(const UV& source, const double d);
-	LNLIB_EXPORT UV operator *(const double& d, const UV& source);
-	LNLIB_EXPORT double operator ^(const UV& uv1, const UV& uv2);
-	LNLIB_EXPORT UV operator /(const UV& source, double d);
-}
+	inline void UV::SetU(const double x) { m_uv[0] = x; }
+	inline void UV::SetV(const double y) { m_uv[1] = y; }
+	inline double& UV::U() { return m_uv[0]; }
+	inline double& UV::V() { return m_uv[1]; }
+
+	inline bool UV::IsZero(const double epsilon) const
+	{
+		return SqrLength() <= epsilon * epsilon;
+	}
+
+	inline bool UV::IsUnit(const double epsilon) const
+	{
+		return fabs(SqrLength() - 1) < epsilon * epsilon;
+	}
+
+	inline double UV::Length() const
+	{
+		return sqrt(SqrLength());
+	}
+
+	inline UV UV::Normalize()
+	{
+		double length = Length();
+		UV newUV = *this;
+		if (length > 0)
+		{
+			double invLength = 1.0 / length;
+			newUV.m_uv[0] *= invLength;
+			newUV.m_uv[1] *= invLength;
+		}
+		return newUV;
+	}
+
+	inline double UV::Distance(const UV& another) const
+	{
+		return Substract(another).Length();
+	}
 
+	inline double& UV::operator[](int index)
+	{
+		return m_uv[index];
+	}
 
+	inline UV& UV::operator*=(const double& d)
+	{
+		m_uv[0] *= d;
+		m_uv[1] *= d;
+		return *this;
+	}
+
+	inline UV& UV::operator/=(const double& d)
+	{
+		m_uv[0] /= d;
+		m_uv[1] /= d;
+		return *this;
+	}
 
+	inline UV& UV::operator+=(const UV& uv)
+	{
+		m_uv[0] += uv.m_uv[0];
+		m_uv[1] += uv.m_uv[1];
+		return *this;
+	}
+
+	inline UV& UV::operator-=(const UV& uv)
+	{
+		m_uv[0] -= uv.m_uv[0];
+		m_uv[1] -= uv.m_uv[1];
+		return *this;
+	}
+
+	LNLIB_EXPORT inline UV operator *(const UV& source, const double d) { return UV(source.GetU() * d, source.GetV() * d); }
+	LNLIB_EXPORT inline UV operator *(const double& d, const UV& source) { return UV(source.GetU() * d, source.GetV() * d); }
+	LNLIB_EXPORT inline double operator ^(const UV& uv1, const UV& uv2) { return uv1.CrossProduct(uv2); }
+	LNLIB_EXPORT inline UV operator /(const UV& source, double d) { return UV(source.GetU() / d, source.GetV() / d); }
+}
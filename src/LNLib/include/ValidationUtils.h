@@ -12,6 +12,7 @@
 
 #include "LNLibDefinitions.h"
 #include "MathUtils.h"
+#include "LNObject.h"
 #include <vector>
 
 namespace LNLib
@@ -29,6 +30,7 @@ namespace LNLib
 		/// Knot Vector is a nondecreasing sequence of real numbers.
 		/// </summary>
 		static bool IsValidKnotVector(const std::vector<double>& knotVector);
+		static bool IsValidKnotVector(const LN_ArrayView<double>& knotVector);
 
 		static bool IsValidBspline(int degree, int knotVectorCount, int controlPointsCount);
 
@@ -11,34 +11,38 @@
 #pragma once
 #include "Constants.h"
 #include "LNLibDefinitions.h"
+#include <math.h>
 
 namespace LNLib
 {
 	/// <summary>
 	/// Represents three-dimension location/vector/offset
+	/// Accessors and arithmetic are defined inline below so that evaluation loops compile to straight-line code
+	/// instead of calls into the shared library. The library no longer exports these members, so code built
+	/// against pre-1.0 headers must be rebuilt.
 	/// </summary>
 	class LNLIB_EXPORT XYZ
 	{
 
 	public:
 
-		XYZ();
-		XYZ(double x, double y, double z);
+		constexpr XYZ() : m_xyz{ 0, 0, 0 } {}
+		constexpr XYZ(double x, double y, double z) : m_xyz{ x, y, z } {}
 
 	public:
 
 		void SetX(const double x);
-		double GetX() const;
+		constexpr double GetX() const { return m_xyz[0]; }
 		void SetY(const double y);
-		double GetY() const;
+		constexpr double GetY() const { return m_xyz[1]; }
 		void SetZ(const double z);
-		double GetZ() const;
+		constexpr double GetZ() const { return m_xyz[2]; }
 
-		double X() const;
+		constexpr double X() const { return m_xyz[0]; }
 		double& X();
-		double Y() const;
+		constexpr double Y() const { return m_xyz[1]; }
 		double& Y();
-		double Z() const;
+		constexpr double Z() const { return m_xyz[2]; }
 		double& Z();
 
 	public:
@@ -47,29 +51,34 @@ namespace LNLib
 		bool IsUnit(const double epsilon = Constants::DoubleEpsilon) const;
 		bool IsAlmostEqualTo(const XYZ& another) const;
 		double Length() const;
-		double SqrLength() const;
+		constexpr double SqrLength() const { return m_xyz[0] * m_xyz[0] + m_xyz[1] * m_xyz[1] + m_xyz[2] * m_xyz[2]; }
 		double AngleTo(const XYZ& another) const;
 		XYZ Normalize();
-		XYZ Add(const XYZ& another) const;
-		XYZ Substract(const XYZ& another) const;
-		XYZ Negative() const;
-		double DotProduct(const XYZ& another) const;
-		XYZ CrossProduct(const XYZ& another) const;
+		constexpr XYZ Add(const XYZ& another) const { return XYZ(m_xyz[0] + another.m_xyz[0], m_xyz[1] + another.m_xyz[1], m_xyz[2] + another.m_xyz[2]); }
+		constexpr XYZ Substract(const XYZ& another) const { return XYZ(m_xyz[0] - another.m_xyz[0], m_xyz[1] - another.m_xyz[1], m_xyz[2] - another.m_xyz[2]); }
+		constexpr XYZ Negative() const { return XYZ(-m_xyz[0], -m_xyz[1], -m_xyz[2]); }
+		constexpr double DotProduct(const XYZ& another) const { return m_xyz[0] * another.m_xyz[0] + m_xyz[1] * another.m_xyz[1] + m_xyz[2] * another.m_xyz[2]; }
+		constexpr XYZ CrossProduct(const XYZ& another) const
+		{
+			return XYZ(m_xyz[1] * another.m_xyz[2] - another.m_xyz[1] * m_xyz[2],
+					   m_xyz[2] * another.m_xyz[0] - another.m_xyz[2] * m_xyz[0],
+					   m_xyz[0] * another.m_xyz[1] - another.m_xyz[0] * m_xyz[1]);
+		}
 		double Distance(const XYZ& another) const;
 
 	public:
 
-		XYZ& operator =(const XYZ& xyz);
+		XYZ& operator =(const XYZ& xyz) = default;
 		double& operator[](int index);
-		const double& operator[](int index) const;
-		XYZ operator +(const XYZ& xyz) const;
-		XYZ operator -(const XYZ& xyz) const;
-		double operator *(const XYZ& xyz) const;
+		constexpr const double& operator[](int index) const { return m_xyz[index]; }
+		constexpr XYZ operator +(const XYZ& xyz) const { return Add(xyz); }
+		constexpr XYZ operator -(const XYZ& xyz) const { return Substract(xyz); }
+		constexpr double operator *(const XYZ& xyz) const { return DotProduct(xyz); }
 		XYZ& operator *=(const double& d);
 		XYZ& operator /=(const double& d);
 		XYZ& operator +=(const XYZ& xyz);
 		XYZ& operator -=(const XYZ& xyz);
-		XYZ  operator-() const;
+		constexpr XYZ  operator-() const { return Negative(); }
 
 	private:
 
@@ -77,10 +86,86 @@ namespace LNLib
 
 	};
 
-	LNLIB_EXPORT XYZ operator *(const XYZ& source, const double d);
-	LNLIB_EXPORT XYZ operator *(const double& d, const XYZ& source);
-	LNLIB_EXPORT XYZ operator ^(const XYZ& xyz1, const XYZ& xyz2);
-	LNLIB_EXPORT XYZ operator /(const XYZ& source, double d);
-}
+	inline void XYZ::SetX(const double x) { m_xyz[0] = x; }
+	inline void XYZ::SetY(const double y) { m_xyz[1] = y; }
+	inline void XYZ::SetZ(const double z) { m_xyz[2] = z; }
+	inline double& XYZ::X() { return m_xyz[0]; }
+	inline double& XYZ::Y() { return m_xyz[1]; }
+	inline double& XYZ::Z() { return m_xyz[2]; }
+
+	inline bool XYZ::IsZero(const double epsilon) const
+	{
+		return SqrLength() <= epsilon * epsilon;
+	}
+
+	inline bool XYZ::IsUnit(const double epsilon) const
+	{
+		return fabs(SqrLength() - 1) < epsilon * epsilon;
+	}
 
+	inline double XYZ::Length() const
+	{
+		return sqrt(SqrLength());
+	}
 
+	inline XYZ XYZ::Normalize()
+	{
+		double length = Length();
+		XYZ newXYZ = *this;
+		if (length > 0)
+		{
+			double invLength = 1.0 / length;
+			newXYZ.m_xyz[0] *= invLength;
+			newXYZ.m_xyz[1] *= invLength;
+			newXYZ.m_xyz[2] *= invLength;
+		}
+		return newXYZ;
+	}
+
+	inline double XYZ::Distance(const XYZ& another) const
+	{
+		return Substract(another).Length();
+	}
+
+	inline double& XYZ::operator[](int index)
+	{
+		return m_xyz[index];
+	}
+
+	inline XYZ& XYZ::operator*=(const double& d)
+	{
+		m_xyz[0] *= d;
+		m_xyz[1] *= d;
+		m_xyz[2] *= d;
+		return *this;
+	}
+
+	inline XYZ& XYZ::operator/=(const double& d)
+	{
+		m_xyz[0] /= d;
+		m_xyz[1] /= d;
+		m_xyz[2] /= d;
+		return *this;
+	}
+
+	inline XYZ& XYZ::operator+=(const XYZ& xyz)
+	{
+		m_xyz[0] += xyz.m_xyz[0];
+		m_xyz[1] += xyz.m_xyz[1];
+		m_xyz[2] += xyz.m_xyz[2];
+		return *this;
+	}
+
+	inline XYZ& XYZ::operator-=(const XYZ& xyz)
+	{
+		m_xyz[0] -= xyz.m_xyz[0];
+		m_xyz[1] -= xyz.m_xyz[1];
+		m_xyz[2] -= xyz.m_xyz[2];
+		return *this;
+	}
+
+	LNLIB_EXPORT inline XYZ operator *(const XYZ& source, const double d) { return XYZ(source.GetX() * d, source.GetY() * d, source.GetZ() * d); }
+	LNLIB_EXPORT inline XYZ operator *(const double& d, const XYZ& source) { return XYZ(source.GetX() * d, source.GetY() * d, source.GetZ() * d); }
+	LNLIB_EXPORT inline XYZ operator ^(const XYZ& xyz1, const XYZ& xyz2) { return xyz1.CrossProduct(xyz2); }
+	LNLIB_EXPORT inline XYZ operator /(const XYZ& source, double d) { return XYZ(source.GetX() / d, source.GetY() / d, source.GetZ() / d); }
+}
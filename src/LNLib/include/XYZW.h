@@ -10,53 +10,56 @@
 
 #pragma once
 #include "LNLibDefinitions.h"
+#include "Constants.h"
 #include "XYZ.h"
 #include <math.h>
+#include <cmath>
 
 namespace LNLib
 {
 	/// <summary>
 	/// Represents four-dimension location/vector/offset
+	/// Accessors and arithmetic are defined inline, like XYZ.
 	/// </summary>
 	class LNLIB_EXPORT XYZW
 	{
 
 	public:
 
-		XYZW();
-		XYZW(XYZ xyz, double w);
-		XYZW(double wx, double wy, double wz, double w);
+		constexpr XYZW() : m_xyzw{ 0, 0, 0, 0 } {}
+		constexpr XYZW(XYZ xyz, double w) : m_xyzw{ xyz.GetX() * w, xyz.GetY() * w, xyz.GetZ() * w, w } {}
+		constexpr XYZW(double wx, double wy, double wz, double w) : m_xyzw{ wx, wy, wz, w } {}
 
 	public:
 
-		double GetWX() const;
-		double GetWY() const;
-		double GetWZ() const;
+		constexpr double GetWX() const { return m_xyzw[0]; }
+		constexpr double GetWY() const { return m_xyzw[1]; }
+		constexpr double GetWZ() const { return m_xyzw[2]; }
 
 		void SetW(const double w);
-		double GetW() const;
+		constexpr double GetW() const { return m_xyzw[3]; }
 
-		double WX() const;
+		constexpr double WX() const { return m_xyzw[0]; }
 		double& WX();
-		double WY() const;
+		constexpr double WY() const { return m_xyzw[1]; }
 		double& WY();
-		double WZ() const;
+		constexpr double WZ() const { return m_xyzw[2]; }
 		double& WZ();
-		double W() const;
+		constexpr double W() const { return m_xyzw[3]; }
 		double& W();
 
 	public:
 
-		XYZ ToXYZ(bool divideWeight);
+		XYZ ToXYZ(bool divideWeight) const;
 		bool IsAlmostEqualTo(const XYZW& another) const;
 		double Distance(const XYZW& another) const;
 
 	public:
 
 		double& operator[](int index);
-		const double& operator[](int index) const;
-		XYZW  operator +(const XYZW& xyzw) const;
-		XYZW  operator -(const XYZW& xyzw) const;
+		constexpr const double& operator[](int index) const { return m_xyzw[index]; }
+		constexpr XYZW  operator +(const XYZW& xyzw) const { return XYZW(m_xyzw[0] + xyzw.m_xyzw[0], m_xyzw[1] + xyzw.m_xyzw[1], m_xyzw[2] + xyzw.m_xyzw[2], m_xyzw[3] + xyzw.m_xyzw[3]); }
+		constexpr XYZW  operator -(const XYZW& xyzw) const { return XYZW(m_xyzw[0] - xyzw.m_xyzw[0], m_xyzw[1] - xyzw.m_xyzw[1], m_xyzw[2] - xyzw.m_xyzw[2], m_xyzw[3] - xyzw.m_xyzw[3]); }
 		XYZW& operator +=(const XYZW& xyzw);
 
 	private:
@@ -64,8 +67,53 @@ namespace LNLib
 		double m_xyzw[4];
 	};
 
-	LNLIB_EXPORT XYZW operator *(const XYZW& source, const double d);
-	LNLIB_EXPORT XYZW operator *(const double& d, const XYZW& source);
-	LNLIB_EXPORT XYZW operator /(const XYZW& source, double d);
-}
+	inline double& XYZW::WX() { return m_xyzw[0]; }
+	inline double& XYZW::WY() { return m_xyzw[1]; }
+	inline double& XYZW::WZ() { return m_xyzw[2]; }
+	inline double& XYZW::W() { return m_xyzw[3]; }
+
+	inline void XYZW::SetW(const double w)
+	{
+		XYZ origin = ToXYZ(true);
+		*this = XYZW(origin, w);
+	}
+
+	inline XYZ XYZW::ToXYZ(bool divideWeight) const
+	{
+		if (divideWeight)
+		{
+			double w = m_xyzw[3];
+			// Same zero test as MathUtils::IsAlmostEqualTo(w, 0.0), which this header does not include.
+			if (std::abs(w) < (std::abs(w) + 10) * Constants::DoubleEpsilon)
+			{
+				return XYZ(m_xyzw[0], m_xyzw[1], m_xyzw[2]);
+			}
+			else
+			{
+				return XYZ(m_xyzw[0] / w, m_xyzw[1] / w, m_xyzw[2] / w);
+			}
+		}
+		else
+		{
+			return XYZ(m_xyzw[0], m_xyzw[1], m_xyzw[2]);
+		}
+	}
+
+	inline double& XYZW::operator[](int index)
+	{
+		return m_xyzw[index];
+	}
 
+	inline XYZW& XYZW::operator+=(const XYZW& xyzw)
+	{
+		m_xyzw[0] += xyzw.m_xyzw[0];
+		m_xyzw[1] += xyzw.m_xyzw[1];
+		m_xyzw[2] += xyzw.m_xyzw[2];
+		m_xyzw[3] += xyzw.m_xyzw[3];
+		return *this;
+	}
+
+	LNLIB_EXPORT inline XYZW operator *(const XYZW& source, const double d) { return XYZW(source.GetWX() * d, source.GetWY() * d, source.GetWZ() * d, source.GetW() * d); }
+	LNLIB_EXPORT inline XYZW operator *(const double& d, const XYZW& source) { return XYZW(source.GetWX() * d, source.GetWY() * d, source.GetWZ() * d, source.GetW() * d); }
+	LNLIB_EXPORT inline XYZW operator /(const XYZW& source, double d) { return XYZW(source.GetWX() / d, source.GetWY() / d, source.GetWZ() / d, source.GetW() / d); }
+}
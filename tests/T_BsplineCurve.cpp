@@ -4,6 +4,7 @@
 #include "XYZW.h"
 #include "MathUtils.h"
 #include "LNObject.h"
+#include <type_traits>
 
 using namespace LNLib;
 
@@ -29,4 +30,30 @@ TEST(Test_BsplineCurve, All)
 	EXPECT_TRUE(ders[1].IsAlmostEqualTo(-0.5 * P2 + 0.5 * P4));
 	ders = BsplineCurve::ComputeDerivativesByAllBasisFunctions(bsplineCurve, 1, paramT);
 	EXPECT_TRUE(ders[1].IsAlmostEqualTo(-0.5 * P2 + 0.5 * P4));
-}
\ No newline at end of file
+}
+
+TEST(Test_BsplineCurve, View)
+{
+	int degree = 2;
+	std::vector<double> knotVector = { 0,0,0,1,2,3,4,4,5,5,5 };
+	double paramT = 5.0 / 2;
+	XYZ P2 = XYZ(5, 6, 7);
+	XYZ P3 = XYZ(6, 7, 8);
+	XYZ P4 = XYZ(8, 9, 10);
+
+	// Every second entry is a control point, the others are unrelated data.
+	std::vector<XYZ> interleaved = { XYZ(1,0,0), XYZ(), XYZ(2,3,4), XYZ(), P2, XYZ(), P3, XYZ(), P4, XYZ(),
+									 XYZ(9,10,11), XYZ(), XYZ(10,11,12), XYZ(), XYZ(11,12,13), XYZ() };
+
+	LN_BsplineCurveView<XYZ> view(degree, LN_ArrayView<double>(knotVector), LN_ArrayView<XYZ>(interleaved.data(), 8, 2));
+
+	XYZ result = BsplineCurve::GetPointOnCurve(view, paramT);
+	EXPECT_TRUE(result.IsAlmostEqualTo(1.0 / 8 * P2 + 6.0 / 8 * P3 + 1.0 / 8 * P4));
+	std::vector<XYZ> ders = BsplineCurve::ComputeDerivatives(view, 1, paramT);
+	EXPECT_TRUE(ders[1].IsAlmostEqualTo(-0.5 * P2 + 0.5 * P4));
+	ders = BsplineCurve::ComputeDerivativesByAllBasisFunctions(view, 1, paramT);
+	EXPECT_TRUE(ders[1].IsAlmostEqualTo(-0.5 * P2 + 0.5 * P4));
+
+	static_assert(std::is_constructible<LN_ArrayView<double>, const std::vector<double>&>::value, "Views of stored vectors must be allowed.");
+	static_assert(!std::is_constructible<LN_ArrayView<double>, std::vector<double>&&>::value, "Views of temporary vectors would dangle.");
+}
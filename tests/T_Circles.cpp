@@ -62,4 +62,21 @@ TEST(Test_Circles, All)
 		XYZ C2 = NurbsCurve::GetPointOnCurve(curve, 1);
 		EXPECT_TRUE(C2.IsAlmostEqualTo(XYZ(0, -10, 0)));
 	}
+}
+
+TEST(Test_Circles, ThreeSegmentArc)
+{
+	// Sweeps between pi and 3pi/2 are built from three equal segments joined at knots 1/3 and 2/3.
+	double sweep = 1.25 * Constants::Pi;
+	LN_NurbsCurve curve;
+	EXPECT_TRUE(NurbsCurve::CreateArc(XYZ(0, 0, 0), XYZ(1, 0, 0), XYZ(0, 1, 0), 0, sweep, 10, 10, curve));
+	ASSERT_EQ(curve.KnotVector.size(), 10);
+	EXPECT_TRUE(MathUtils::IsAlmostEqualTo(curve.KnotVector[3], 1.0 / 3.0));
+	EXPECT_TRUE(MathUtils::IsAlmostEqualTo(curve.KnotVector[5], 2.0 / 3.0));
+	for (int i = 0; i <= 3; i++)
+	{
+		double angle = sweep * i / 3.0;
+		XYZ point = NurbsCurve::GetPointOnCurve(curve, i / 3.0);
+		EXPECT_TRUE(point.IsAlmostEqualTo(XYZ(10 * cos(angle), 10 * sin(angle), 0)));
+	}
 }
\ No newline at end of file
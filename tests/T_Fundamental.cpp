@@ -6,6 +6,7 @@
 #include "ValidationUtils.h"
 #include "MathUtils.h"
 #include "LNObject.h"
+#include "KnotVectorUtils.h"
 using namespace LNLib;
 
 TEST(Test_Fundamental, All)
@@ -341,4 +342,16 @@ TEST(Test_Fundamental, All)
 		EXPECT_TRUE(updatedCps[2].ToXYZ(true).IsAlmostEqualTo(XYZ(3, 0, 0)));
 		ValidationUtils::IsValidNurbs(degree - 1, updatedKv.size(), updatedCps.size());
 	}
+}
+
+TEST(Test_Fundamental, InternalKnotMultiplicityMap)
+{
+	std::vector<double> kv = { 0,0,0,0,1,2,2,3,4,4,4,4 };
+	auto result = KnotVectorUtils::GetInternalKnotMultiplicityMap(kv);
+	EXPECT_EQ(result.size(), 3);
+	EXPECT_TRUE(result.find(0.0) == result.end());
+	EXPECT_TRUE(result.find(4.0) == result.end());
+	EXPECT_EQ(result[1.0], 1);
+	EXPECT_EQ(result[2.0], 2);
+	EXPECT_EQ(result[3.0], 1);
 }
\ No newline at end of file
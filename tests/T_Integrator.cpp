@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+#include "Integrator.h"
+#include <cmath>
+using namespace LNLib;
+
+TEST(Test_Integrator, GaussKronrod)
+{
+	// Both rules integrate polynomials up to their Kronrod degree exactly on the first application.
+	std::function<double(double)> polynomial = [](double x) { return 3 * pow(x, 12) - x * x + 1; };
+	double exact = 2 * 3 * pow(2.0, 13) / 13.0 - 16.0 / 3.0 + 4;
+	LN_IntegrationResult result = Integrator::GaussKronrod(polynomial, -2, 2);
+	EXPECT_NEAR(result.Value, exact, 1E-9 * exact);
+	EXPECT_EQ(result.Evaluations, 15);
+	EXPECT_TRUE(result.IsConverged);
+	result = Integrator::GaussKronrod(polynomial, -2, 2, LN_IntegrationTolerance(), 10000, GaussKronrodRule::G10K21);
+	EXPECT_NEAR(result.Value, exact, 1E-9 * exact);
+	EXPECT_EQ(result.Evaluations, 21);
+
+	// A square root singularity needs subdivision near zero only; the error estimate bounds the actual error.
+	std::function<double(double)> root = [](double x) { return sqrt(x); };
+	result = Integrator::GaussKronrod(root, 0, 1, LN_IntegrationTolerance(1E-10, 0.0));
+	EXPECT_TRUE(result.IsConverged);
+	EXPECT_LE(result.Error, 1E-10);
+	EXPECT_NEAR(result.Value, 2.0 / 3.0, 1E-10);
+	EXPECT_LT(result.Evaluations, 2000);
+
+	// The budget stops the refinement and reports the shortfall.
+	result = Integrator::GaussKronrod(root, 0, 1, LN_IntegrationTolerance(1E-14, 0.0), 45);
+	EXPECT_FALSE(result.IsConverged);
+	EXPECT_EQ(result.Evaluations, 45);
+	EXPECT_NEAR(result.Value, 2.0 / 3.0, 1E-3);
+	EXPECT_GT(result.Error, 1E-14);
+}
+
+TEST(Test_Integrator, GaussKronrodCubature)
+{
+	// x^4 * y^2 is integrated exactly by one application of the tensor product rule.
+	auto polynomial = [](const std::vector<double>& us, const std::vector<double>& vs, std::vector<double>& values)
+	{
+		for (int i = 0; i < us.size(); i++)
+		{
+			for (int j = 0; j < vs.size(); j++)
+			{
+				values[i * vs.size() + j] = pow(us[i], 4) * vs[j] * vs[j];
+			}
+		}
+	};
+	LN_IntegrationResult result = Integrator::GaussKronrodCubature(polynomial, 0, 2, -1, 1);
+	EXPECT_NEAR(result.Value, 64.0 / 15.0, 1E-12);
+	EXPECT_EQ(result.Evaluations, 15 * 15);
+	EXPECT_TRUE(result.IsConverged);
+
+	// sqrt(u * v) is singular along both axes; the rectangles there are quartered until the estimate meets the tolerance.
+	auto root = [](const std::vector<double>& us, const std::vector<double>& vs, std::vector<double>& values)
+	{
+		for (int i = 0; i < us.size(); i++)
+		{
+			for (int j = 0; j < vs.size(); j++)
+			{
+				values[i * vs.size() + j] = sqrt(us[i] * vs[j]);
+			}
+		}
+	};
+	result = Integrator::GaussKronrodCubature(root, 0, 1, 0, 1, LN_IntegrationTolerance(1E-6, 0.0));
+	EXPECT_TRUE(result.IsConverged);
+	EXPECT_LE(result.Error, 1E-6);
+	EXPECT_NEAR(result.Value, 4.0 / 9.0, 1E-6);
+	EXPECT_GT(result.Evaluations, 15 * 15);
+
+	// The budget stops the refinement after one split and reports the shortfall.
+	result = Integrator::GaussKronrodCubature(root, 0, 1, 0, 1, LN_IntegrationTolerance(1E-14, 0.0), 5 * 15 * 15);
+	EXPECT_FALSE(result.IsConverged);
+	EXPECT_EQ(result.Evaluations, 5 * 15 * 15);
+	EXPECT_NEAR(result.Value, 4.0 / 9.0, 1E-3);
+
+	// A degenerate rectangle has no area.
+	result = Integrator::GaussKronrodCubature(root, 0.5, 0.5, 0, 1);
+	EXPECT_EQ(result.Value, 0.0);
+	EXPECT_EQ(result.Evaluations, 0);
+}
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include "MathUtils.h"
+#include "Constants.h"
 using namespace LNLib;
 
 TEST(Test_MathUtils, Compare)
@@ -39,4 +40,19 @@ TEST(Test_MathUtils, Matrix)
 				MathUtils::IsAlmostEqualTo(upper[2][0], 0) &&
 				MathUtils::IsAlmostEqualTo(upper[2][1], 0) &&
 				MathUtils::IsAlmostEqualTo(upper[2][2], -15));
-}
\ No newline at end of file
+}
+
+TEST(Test_MathUtils, Binomial)
+{
+	EXPECT_TRUE(MathUtils::IsAlmostEqualTo(MathUtils::Binomial(3, 2), 3));
+	EXPECT_TRUE(MathUtils::IsAlmostEqualTo(MathUtils::Binomial(6, 3), 20));
+	EXPECT_TRUE(MathUtils::IsAlmostEqualTo(MathUtils::Binomial(20, 10), 184756));
+	EXPECT_TRUE(MathUtils::IsAlmostEqualTo(MathUtils::Binomial(40, 3), 9880));
+	EXPECT_TRUE(MathUtils::IsAlmostEqualTo(MathUtils::Binomial(5, 6), 0));
+
+	const double* row = MathUtils::BinomialRow(4);
+	EXPECT_TRUE(MathUtils::IsAlmostEqualTo(row[0], 1));
+	EXPECT_TRUE(MathUtils::IsAlmostEqualTo(row[1], 4));
+	EXPECT_TRUE(MathUtils::IsAlmostEqualTo(row[2], 6));
+	EXPECT_TRUE(MathUtils::IsAlmostEqualTo(row[4], 1));
+}
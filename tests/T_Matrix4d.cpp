@@ -129,5 +129,13 @@ TEST(Test_Matrix4d, OperatorOverride)
 	EXPECT_TRUE(add.IsIdentity());
 }
 
-
-
+TEST(Test_Matrix4d, Constexpr)
+{
+	constexpr Matrix4d identity = Matrix4d();
+	constexpr Matrix4d basis = Matrix4d(XYZ(1, 2, 3), XYZ(4, 5, 6), XYZ(7, 8, 9), XYZ(10, 11, 12));
+	constexpr Matrix4d m = Matrix4d(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
+	static_assert(identity.GetElement(2, 2) == 1 && identity.GetElement(2, 3) == 0, "Matrix4d() must be usable in constant expressions.");
+	static_assert(basis.GetElement(1, 0) == 2 && basis.GetElement(2, 3) == 12 && basis.GetElement(3, 3) == 1, "The basis constructor must be usable in constant expressions.");
+	static_assert(m.GetElement(1, 2) == 7, "The element constructor must be usable in constant expressions.");
+	EXPECT_TRUE(Matrix4d(identity).IsIdentity());
+}
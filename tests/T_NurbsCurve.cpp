@@ -2,6 +2,9 @@
 #include "XYZ.h"
 #include "XYZW.h"
 #include "NurbsCurve.h"
+#include "Polynomials.h"
+#include "SimdKernels.h"
+#include "Constants.h"
 using namespace LNLib;
 
 TEST(Test_NurbsCurve, All)
@@ -27,4 +30,517 @@ TEST(Test_NurbsCurve, All)
 	std::vector<XYZ> ders = NurbsCurve::ComputeRationalCurveDerivatives(curve, 2, 0.0);
 	EXPECT_TRUE(ders[1].IsAlmostEqualTo(XYZ(0, 2, 0)));
 	EXPECT_TRUE(ders[2].IsAlmostEqualTo(XYZ(-4, 0, 0)));
-}
\ No newline at end of file
+}
+
+TEST(Test_NurbsCurve, Checked)
+{
+	LN_NurbsCurve curve;
+	curve.Degree = 2;
+	curve.KnotVector = { 0,0,0,1,2,3,3,3 };
+	curve.ControlPoints = { XYZW(XYZ(0,0,0),1), XYZW(XYZ(1,1,0),4), XYZW(XYZ(3,2,0),1), XYZW(XYZ(4,1,0),1), XYZW(XYZ(5,-1,0),1) };
+
+	LN_CheckedNurbsCurve checked = NurbsCurve::Check(curve);
+	for (int i = 0; i <= 12; i++)
+	{
+		double t = 3.0 * i / 12;
+		EXPECT_TRUE(NurbsCurve::GetPointOnCurve(checked, t).IsAlmostEqualTo(NurbsCurve::GetPointOnCurve(curve, t)));
+
+		std::vector<XYZ> ders = NurbsCurve::ComputeRationalCurveDerivatives(curve, 2, t);
+		std::vector<XYZ> checkedDers = NurbsCurve::ComputeRationalCurveDerivatives(checked, 2, t);
+		EXPECT_TRUE(checkedDers[1].IsAlmostEqualTo(ders[1]));
+		EXPECT_TRUE(checkedDers[2].IsAlmostEqualTo(ders[2]));
+	}
+
+	curve.KnotVector = { 0,0,0,2,1,3,3,3 };
+	EXPECT_THROW(NurbsCurve::Check(curve), std::invalid_argument);
+}
+
+TEST(Test_NurbsCurve, Batch)
+{
+	LN_NurbsCurve curve;
+	curve.Degree = 2;
+	curve.KnotVector = { 0,0,0,1,2,3,3,3 };
+	curve.ControlPoints = { XYZW(XYZ(0,0,0),1), XYZW(XYZ(1,1,0),4), XYZW(XYZ(3,2,0),1), XYZW(XYZ(4,1,0),1), XYZW(XYZ(5,-1,0),1) };
+
+	std::vector<double> params;
+	for (int i = 0; i <= 30; i++)
+	{
+		params.emplace_back(3.0 * i / 30);
+	}
+	params.emplace_back(0.5);
+
+	std::vector<XYZ> points;
+	NurbsCurve::GetPointsOnCurve(curve, params, points);
+	std::vector<std::vector<XYZ>> ders;
+	NurbsCurve::ComputeRationalCurveDerivatives(curve, 2, params, ders);
+	EXPECT_EQ(points.size(), params.size());
+	EXPECT_EQ(ders.size(), params.size());
+	for (int i = 0; i < params.size(); i++)
+	{
+		EXPECT_TRUE(points[i].IsAlmostEqualTo(NurbsCurve::GetPointOnCurve(curve, params[i])));
+
+		std::vector<XYZ> single = NurbsCurve::ComputeRationalCurveDerivatives(curve, 2, params[i]);
+		EXPECT_TRUE(ders[i][0].IsAlmostEqualTo(single[0]));
+		EXPECT_TRUE(ders[i][1].IsAlmostEqualTo(single[1]));
+		EXPECT_TRUE(ders[i][2].IsAlmostEqualTo(single[2]));
+	}
+
+	std::vector<XYZ> flat;
+	NurbsCurve::ComputeRationalCurveDerivatives(curve, 2, params, flat);
+	EXPECT_EQ(flat.size(), 3 * params.size());
+	for (int i = 0; i < params.size(); i++)
+	{
+		for (int k = 0; k <= 2; k++)
+		{
+			EXPECT_TRUE(flat[i * 3 + k].IsAlmostEqualTo(ders[i][k]));
+		}
+	}
+
+	params.emplace_back(3.5);
+	EXPECT_THROW(NurbsCurve::GetPointsOnCurve(curve, params, points), std::out_of_range);
+}
+
+TEST(Test_NurbsCurve, Compiled)
+{
+	LN_NurbsCurve curve;
+	curve.Degree = 3;
+	curve.KnotVector = { 0,0,0,0,0.5,1,1.5,2,2,2,2 };
+	curve.ControlPoints = { XYZW(XYZ(0,0,0),1), XYZW(XYZ(1,2,0),2), XYZW(XYZ(2,3,1),0.5), XYZW(XYZ(4,1,2),1), XYZW(XYZ(5,-1,0),3), XYZW(XYZ(6,0,1),1), XYZW(XYZ(7,2,2),1) };
+
+	std::vector<double> params;
+	for (int i = 0; i <= 41; i++)
+	{
+		params.emplace_back(2.0 * i / 41);
+	}
+	params.emplace_back(0.25);
+	params.emplace_back(1.75);
+	params.emplace_back(0.0);
+
+	std::vector<XYZ> expected;
+	NurbsCurve::GetPointsOnCurve(curve, params, expected);
+
+	LN_CompiledNurbsCurve compiled = NurbsCurve::Compile(curve);
+	bool enabled = SimdKernels::IsAVX2Enabled();
+	for (int pass = 0; pass < 2; pass++)
+	{
+		SimdKernels::SetAVX2Enabled(pass == 0);
+		std::vector<XYZ> points;
+		NurbsCurve::GetPointsOnCurve(compiled, params, points);
+		EXPECT_EQ(points.size(), params.size());
+		for (int i = 0; i < params.size(); i++)
+		{
+			EXPECT_TRUE(points[i].IsAlmostEqualTo(expected[i]));
+		}
+	}
+	SimdKernels::SetAVX2Enabled(enabled);
+}
+
+TEST(Test_NurbsCurve, PowerBasis)
+{
+	LN_NurbsCurve curve;
+	curve.Degree = 3;
+	curve.KnotVector = { 0,0,0,0,0.5,1,1,1,2,2,2,2 };
+	curve.ControlPoints = { XYZW(XYZ(0,0,0),1), XYZW(XYZ(1,2,0),2), XYZW(XYZ(2,3,1),0.5), XYZW(XYZ(4,1,2),1), XYZW(XYZ(5,-1,0),3), XYZW(XYZ(6,0,1),1), XYZW(XYZ(7,2,2),1), XYZW(XYZ(8,1,0),2) };
+
+	EXPECT_EQ(NurbsCurve::DecomposeToBeziers(curve).size(), 3);
+
+	LN_PowerBasisCurve powerBasis = NurbsCurve::ToPowerBasis(curve);
+	EXPECT_EQ(powerBasis.Knots.size(), 4);
+	EXPECT_EQ(powerBasis.Coefficients.size(), 3);
+
+	LN_PowerBasisCurve derivative = NurbsCurve::Differentiate(powerBasis);
+	EXPECT_EQ(derivative.Degree, 2);
+
+	for (int i = 0; i <= 40; i++)
+	{
+		double paramT = 2.0 * i / 40;
+		XYZ point = NurbsCurve::GetPointOnCurve(curve, paramT);
+		EXPECT_TRUE(NurbsCurve::GetPointOnCurve(powerBasis, paramT).IsAlmostEqualTo(point));
+
+		std::vector<XYZ> expected = NurbsCurve::ComputeRationalCurveDerivatives(curve, 3, paramT);
+		std::vector<XYZ> ders = NurbsCurve::ComputeRationalCurveDerivatives(powerBasis, 3, paramT);
+		for (int k = 0; k <= 3; k++)
+		{
+			EXPECT_TRUE(ders[k].IsAlmostEqualTo(expected[k]));
+		}
+
+		int spanIndex = Polynomials::GetKnotSpanIndex(0, derivative.Knots, paramT);
+		double s = (paramT - derivative.Knots[spanIndex]) / (derivative.Knots[spanIndex + 1] - derivative.Knots[spanIndex]);
+		XYZW weightedPoint = Polynomials::HornerUnchecked(powerBasis.Degree, powerBasis.Coefficients[spanIndex].data(), s);
+		XYZW weightedDerivative = Polynomials::HornerUnchecked(derivative.Degree, derivative.Coefficients[spanIndex].data(), s);
+		XYZ tangent = (weightedDerivative.ToXYZ(false) - weightedDerivative.GetW() * point) / weightedPoint.GetW();
+		EXPECT_TRUE(tangent.IsAlmostEqualTo(expected[1]));
+	}
+}
+
+TEST(Test_NurbsCurve, NonRational)
+{
+	LN_NurbsCurve curve;
+	curve.Degree = 3;
+	curve.KnotVector = { 0,0,0,0,1,2,2,2,2 };
+	curve.ControlPoints = { XYZW(XYZ(0,0,0),1), XYZW(XYZ(1,2,0),1), XYZW(XYZ(3,3,1),1), XYZW(XYZ(4,1,2),1), XYZW(XYZ(6,0,0),1) };
+
+	LN_CheckedNurbsCurve checked = NurbsCurve::Check(curve);
+	EXPECT_FALSE(checked.IsRational());
+	for (int i = 0; i <= 10; i++)
+	{
+		double t = 2.0 * i / 10;
+		EXPECT_TRUE(NurbsCurve::GetPointOnCurve(checked, t).IsAlmostEqualTo(NurbsCurve::GetPointOnCurve(curve, t)));
+
+		std::vector<XYZ> ders = NurbsCurve::ComputeRationalCurveDerivatives(curve, 3, t);
+		std::vector<XYZ> checkedDers = NurbsCurve::ComputeRationalCurveDerivatives(checked, 3, t);
+		for (int k = 0; k <= 3; k++)
+		{
+			EXPECT_TRUE(checkedDers[k].IsAlmostEqualTo(ders[k]));
+		}
+		EXPECT_NEAR(NurbsCurve::Curvature(checked, t), NurbsCurve::Curvature(curve, t), 1e-9);
+	}
+
+	curve.ControlPoints[2] = XYZW(XYZ(3,3,1),2);
+	EXPECT_TRUE(NurbsCurve::Check(curve).IsRational());
+}
+
+TEST(Test_NurbsCurve, AdaptiveTessellate)
+{
+	LN_NurbsCurve line;
+	line.Degree = 3;
+	line.KnotVector = { 0,0,0,0,1,1,1,1 };
+	line.ControlPoints = { XYZW(XYZ(0,0,0),1), XYZW(XYZ(2,0,0),1), XYZW(XYZ(5,0,0),1), XYZW(XYZ(10,0,0),1) };
+
+	std::vector<XYZ> points;
+	std::vector<double> params;
+	NurbsCurve::AdaptiveTessellate(line, LN_TessellationTolerance(1E-3, 0.1), points, params);
+	EXPECT_EQ(points.size(), 2);
+	EXPECT_TRUE(points[1].IsAlmostEqualTo(XYZ(10,0,0)));
+
+	NurbsCurve::AdaptiveTessellate(line, LN_TessellationTolerance(1E-3, 0.1, 1.0), points, params);
+	for (int i = 0; i < points.size() - 1; i++)
+	{
+		EXPECT_LE(points[i].Distance(points[i + 1]), 1.0);
+	}
+
+	LN_NurbsCurve circle;
+	NurbsCurve::CreateArc(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, 2 * Constants::Pi, 10, 10, circle);
+	double chordHeight = 1E-2;
+	NurbsCurve::AdaptiveTessellate(circle, LN_TessellationTolerance(chordHeight, 0.5), points, params);
+	EXPECT_EQ(points.size(), params.size());
+	EXPECT_DOUBLE_EQ(params[0], circle.KnotVector[0]);
+	EXPECT_DOUBLE_EQ(params[params.size() - 1], circle.KnotVector[circle.KnotVector.size() - 1]);
+
+	std::vector<XYZ> equalPoints;
+	std::vector<double> equalParams;
+	NurbsCurve::EquallyTessellate(circle, equalPoints, equalParams);
+	EXPECT_LT(points.size(), equalPoints.size() / 2);
+	for (int i = 0; i < points.size() - 1; i++)
+	{
+		EXPECT_LT(params[i], params[i + 1]);
+		EXPECT_TRUE(NurbsCurve::GetPointOnCurve(circle, params[i]).IsAlmostEqualTo(points[i]));
+		XYZ middle = NurbsCurve::GetPointOnCurve(circle, (params[i] + params[i + 1]) / 2);
+		EXPECT_LE(middle.Length() - ((points[i] + points[i + 1]) / 2).Length(), chordHeight);
+	}
+}
+
+TEST(Test_NurbsCurve, BVH)
+{
+	// A rational wave of many spans.
+	LN_NurbsCurve wave;
+	wave.Degree = 3;
+	int count = 40;
+	wave.KnotVector = { 0,0,0,0 };
+	for (int i = 1; i < count - 3; i++)
+	{
+		wave.KnotVector.emplace_back(i);
+	}
+	wave.KnotVector.insert(wave.KnotVector.end(), 4, count - 3);
+	for (int i = 0; i < count; i++)
+	{
+		wave.ControlPoints.emplace_back(XYZW(XYZ(i, i % 2 == 0 ? 0 : 2, 0), i % 3 == 0 ? 2 : 1));
+	}
+
+	LN_CurveBVH bvh = NurbsCurve::BuildBVH(wave);
+	EXPECT_GE(bvh.Leaves.size(), count - 3);
+	EXPECT_EQ(bvh.Nodes.size(), 2 * bvh.Leaves.size() - 1);
+	EXPECT_EQ(bvh.LeafParams.size(), 2 * bvh.Leaves.size());
+
+	std::vector<XYZ> samples;
+	std::vector<double> sampleParams;
+	NurbsCurve::EquallyTessellate(wave, samples, sampleParams);
+	const XYZ queries[] = { XYZ(3.2, 1.0, 0.5), XYZ(-2, -1, 0), XYZ(20.5, 5, -1), XYZ(40, 1, 0), XYZ(11.7, 0.3, 0) };
+	for (const XYZ& query : queries)
+	{
+		double bruteForce = Constants::MaxDistance;
+		for (int i = 0; i < samples.size(); i++)
+		{
+			bruteForce = std::min(bruteForce, samples[i].Distance(query));
+		}
+		double param = NurbsCurve::GetParamOnCurve(bvh, query);
+		EXPECT_LE(NurbsCurve::GetPointOnCurve(wave, param).Distance(query), bruteForce + Constants::DoubleEpsilon);
+		EXPECT_DOUBLE_EQ(NurbsCurve::GetParamOnCurve(wave, query), param);
+	}
+
+	double param = NurbsCurve::GetParamOnCurve(bvh, NurbsCurve::GetPointOnCurve(wave, 17.3));
+	EXPECT_NEAR(param, 17.3, 1E-9);
+
+	// The checked leaves of a copy view the copy's own leaves.
+	LN_CurveBVH copy;
+	{
+		LN_CurveBVH original = NurbsCurve::BuildBVH(wave);
+		copy = original;
+	}
+	ASSERT_EQ(copy.CheckedLeaves.size(), copy.Leaves.size());
+	EXPECT_EQ(copy.CheckedLeaves[0].GetCurve().ControlPoints.Data, copy.Leaves[0].ControlPoints.data());
+	EXPECT_DOUBLE_EQ(NurbsCurve::GetParamOnCurve(copy, NurbsCurve::GetPointOnCurve(wave, 17.3)), param);
+}
+
+TEST(Test_NurbsCurve, BatchProjection)
+{
+	LN_NurbsCurve circle;
+	NurbsCurve::CreateArc(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, 2 * Constants::Pi, 10, 10, circle);
+
+	// A scan line crossing the circle, followed by scattered points.
+	std::vector<XYZ> points;
+	for (int i = 0; i < 1000; i++)
+	{
+		points.emplace_back(XYZ(-12 + 0.024 * i, 3 + 0.5 * sin(0.1 * i), 0.2));
+	}
+	for (int i = 0; i < 100; i++)
+	{
+		points.emplace_back(XYZ(20 * cos(1.7 * i), 15 * sin(2.3 * i), (i % 7) - 3.0));
+	}
+
+	LN_CurveBVH bvh = NurbsCurve::BuildBVH(circle);
+	std::vector<double> params;
+	std::vector<double> distances;
+	NurbsCurve::GetParamsOnCurve(bvh, points, params, distances);
+	ASSERT_EQ(params.size(), points.size());
+	ASSERT_EQ(distances.size(), points.size());
+	for (int i = 0; i < points.size(); i += 37)
+	{
+		XYZ point = NurbsCurve::GetPointOnCurve(circle, params[i]);
+		EXPECT_NEAR(point.Distance(points[i]), distances[i], 1E-9);
+		XYZ expected = NurbsCurve::GetPointOnCurve(circle, NurbsCurve::GetParamOnCurve(bvh, points[i]));
+		EXPECT_NEAR(expected.Distance(points[i]), distances[i], 1E-9);
+	}
+
+	std::vector<double> parallelParams;
+	std::vector<double> parallelDistances;
+	NurbsCurve::GetParamsOnCurve(circle, points, parallelParams, parallelDistances, LN_ExecutionPolicy(4));
+	EXPECT_EQ(parallelParams, params);
+	EXPECT_EQ(parallelDistances, distances);
+}
+
+TEST(Test_NurbsCurve, ProjectionScale)
+{
+	// Foot points on an arc are exact relative to its radius, however small the arc is.
+	const double radii[] = { 1.0, 0.01, 0.001 };
+	for (double radius : radii)
+	{
+		LN_NurbsCurve arc;
+		NurbsCurve::CreateArc(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, 1.5 * Constants::Pi, radius, radius, arc);
+		LN_CurveBVH bvh = NurbsCurve::BuildBVH(arc);
+		std::vector<XYZ> points;
+		for (int i = 0; i < 10; i++)
+		{
+			double angle = 0.1 + 0.45 * i;
+			points.emplace_back(XYZ(1.2 * radius * cos(angle), 1.2 * radius * sin(angle), 0));
+		}
+		std::vector<double> params;
+		std::vector<double> distances;
+		NurbsCurve::GetParamsOnCurve(bvh, points, params, distances);
+		for (int i = 0; i < points.size(); i++)
+		{
+			double angle = 0.1 + 0.45 * i;
+			XYZ expected = XYZ(radius * cos(angle), radius * sin(angle), 0);
+			XYZ point = NurbsCurve::GetPointOnCurve(arc, NurbsCurve::GetParamOnCurve(arc, points[i]));
+			EXPECT_LE(point.Distance(expected), 1E-9 * radius);
+			EXPECT_NEAR(distances[i], 0.2 * radius, 1E-9 * radius);
+		}
+	}
+}
+
+TEST(Test_NurbsCurve, ArcLengthTable)
+{
+	double radius = 10.0;
+	LN_NurbsCurve arc;
+	NurbsCurve::CreateArc(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, 1.5 * Constants::Pi, radius, radius, arc);
+	LN_ArcLengthTable table = NurbsCurve::BuildArcLengthTable(arc);
+	EXPECT_EQ(table.Params.size(), table.Lengths.size());
+	EXPECT_EQ(table.IntervalSegments.size(), table.Params.size() - 1);
+	EXPECT_NEAR(table.Lengths.back(), 1.5 * Constants::Pi * radius, 1E-8);
+
+	// On a circle the arc length to a point is the radius times its angle.
+	double first = arc.KnotVector.front();
+	double last = arc.KnotVector.back();
+	for (int i = 0; i <= 10; i++)
+	{
+		double paramT = first + (last - first) * i / 10.0;
+		XYZ point = NurbsCurve::GetPointOnCurve(arc, paramT);
+		double angle = atan2(point.GetY(), point.GetX());
+		if (angle < 0)
+		{
+			angle += 2 * Constants::Pi;
+		}
+		if (i == 10)
+		{
+			angle = 1.5 * Constants::Pi;
+		}
+		EXPECT_NEAR(NurbsCurve::ApproximateLength(table, paramT), radius * angle, 1E-8);
+	}
+
+	for (int i = 0; i <= 10; i++)
+	{
+		double length = table.Lengths.back() * i / 10.0;
+		double paramT = NurbsCurve::GetParamOnCurve(table, length);
+		EXPECT_NEAR(NurbsCurve::ApproximateLength(table, paramT), length, 1E-8);
+		double angle = length / radius;
+		EXPECT_TRUE(NurbsCurve::GetPointOnCurve(arc, paramT).IsAlmostEqualTo(XYZ(radius * cos(angle), radius * sin(angle), 0)));
+	}
+
+	EXPECT_EQ(table.CheckedSegments.size(), table.Segments.size());
+	EXPECT_EQ(table.Speeds.size(), 2 * table.IntervalSegments.size());
+	for (int i = 0; i < table.Speeds.size(); i++)
+	{
+		EXPECT_GT(table.Speeds[i], 0.0);
+	}
+
+	// A copied table views its own segments.
+	LN_ArcLengthTable copy;
+	{
+		LN_ArcLengthTable temporary = NurbsCurve::BuildArcLengthTable(arc);
+		copy = temporary;
+	}
+	for (int i = 0; i < copy.CheckedSegments.size(); i++)
+	{
+		EXPECT_EQ(copy.CheckedSegments[i].GetCurve().ControlPoints.Data, copy.Segments[i].ControlPoints.data());
+	}
+	EXPECT_EQ(NurbsCurve::GetParamOnCurve(copy, radius), NurbsCurve::GetParamOnCurve(table, radius));
+
+	double paramT = NurbsCurve::GetParamOnCurve(arc, radius * 2.0, IntegratorType::Gauss_Legendre);
+	EXPECT_TRUE(NurbsCurve::GetPointOnCurve(arc, paramT).IsAlmostEqualTo(XYZ(radius * cos(2.0), radius * sin(2.0), 0)));
+}
+
+TEST(Test_NurbsCurve, Division)
+{
+	double radius = 10.0;
+	LN_NurbsCurve arc;
+	NurbsCurve::CreateArc(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, 1.5 * Constants::Pi, radius, radius, arc);
+	LN_ArcLengthTable table = NurbsCurve::BuildArcLengthTable(arc);
+	double totalLength = table.Lengths.back();
+
+	std::vector<double> params = NurbsCurve::DivideByLength(table, 1.0);
+	EXPECT_EQ(params.size(), static_cast<int>(totalLength));
+	for (int i = 0; i < params.size(); i++)
+	{
+		EXPECT_NEAR(NurbsCurve::ApproximateLength(table, params[i]), i + 1.0, 1E-8);
+	}
+	std::vector<double> legacy = NurbsCurve::GetParamsOnCurve(arc, 1.0, IntegratorType::Gauss_Legendre);
+	EXPECT_EQ(legacy.size(), params.size());
+
+	params = NurbsCurve::DivideByCount(table, 7);
+	EXPECT_EQ(params.size(), 6);
+	for (int i = 0; i < params.size(); i++)
+	{
+		EXPECT_NEAR(NurbsCurve::ApproximateLength(table, params[i]), totalLength * (i + 1) / 7.0, 1E-8);
+	}
+
+	// Equal chords of a circle subtend equal angles.
+	params = NurbsCurve::DivideByLength(table, 2.0, CurveDivisionType::Chord);
+	XYZ previous = NurbsCurve::GetPointOnCurve(arc, arc.KnotVector.front());
+	for (int i = 0; i < params.size(); i++)
+	{
+		XYZ current = NurbsCurve::GetPointOnCurve(arc, params[i]);
+		EXPECT_NEAR(current.Distance(previous), 2.0, Constants::DistanceEpsilon);
+		previous = current;
+	}
+	EXPECT_EQ(params.size(), static_cast<int>(1.5 * Constants::Pi / (2.0 * asin(0.1))));
+
+	params = NurbsCurve::DivideByCount(table, 5, CurveDivisionType::Chord);
+	EXPECT_EQ(params.size(), 4);
+	previous = NurbsCurve::GetPointOnCurve(arc, arc.KnotVector.front());
+	double chordLength = 2.0 * radius * sin(1.5 * Constants::Pi / 10.0);
+	params.emplace_back(arc.KnotVector.back());
+	for (int i = 0; i < params.size(); i++)
+	{
+		XYZ current = NurbsCurve::GetPointOnCurve(arc, params[i]);
+		EXPECT_NEAR(current.Distance(previous), chordLength, Constants::DistanceEpsilon);
+		previous = current;
+	}
+}
+
+TEST(Test_NurbsCurve, DivisionScale)
+{
+	// A 9000.5 long arc has a station at every unit of length, up to and including 9000.
+	double sweep = 1.5 * Constants::Pi;
+	double radius = 9000.5 / sweep;
+	LN_NurbsCurve arc;
+	NurbsCurve::CreateArc(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, sweep, radius, radius, arc);
+	LN_ArcLengthTable table = NurbsCurve::BuildArcLengthTable(arc);
+	std::vector<double> params = NurbsCurve::DivideByLength(table, 1.0);
+	EXPECT_EQ(params.size(), 9000);
+	EXPECT_NEAR(NurbsCurve::ApproximateLength(table, params.back()), 9000.0, 1E-6);
+	EXPECT_EQ(NurbsCurve::GetParamsOnCurve(arc, 1.0, IntegratorType::Gauss_Legendre).size(), 9000);
+
+	// A 3 millimetre arc divided at a sixth of its length has five interior stations.
+	radius = 0.003 / sweep;
+	NurbsCurve::CreateArc(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, sweep, radius, radius, arc);
+	table = NurbsCurve::BuildArcLengthTable(arc);
+	double totalLength = table.Lengths.back();
+	params = NurbsCurve::DivideByLength(table, totalLength / 6.0);
+	EXPECT_EQ(params.size(), 5);
+	for (int i = 0; i < params.size(); i++)
+	{
+		EXPECT_NEAR(NurbsCurve::ApproximateLength(table, params[i]), totalLength * (i + 1) / 6.0, 1E-12);
+	}
+
+	// Chords of a millimetre scale curve resolve to a tolerance far below DoubleEpsilon.
+	params = NurbsCurve::DivideByCount(table, 4, CurveDivisionType::Chord, 1E-9);
+	EXPECT_EQ(params.size(), 3);
+	double chordLength = 2.0 * radius * sin(sweep / 8.0);
+	XYZ previous = NurbsCurve::GetPointOnCurve(arc, arc.KnotVector.front());
+	params.emplace_back(arc.KnotVector.back());
+	for (int i = 0; i < params.size(); i++)
+	{
+		XYZ current = NurbsCurve::GetPointOnCurve(arc, params[i]);
+		EXPECT_NEAR(current.Distance(previous), chordLength, 1E-9);
+		previous = current;
+	}
+	params = NurbsCurve::DivideByLength(table, chordLength, CurveDivisionType::Chord);
+	EXPECT_EQ(params.size(), 3);
+}
+
+TEST(Test_NurbsCurve, LengthEngine)
+{
+	LN_NurbsCurve curve;
+	curve.Degree = 3;
+	int count = 40;
+	for (int i = 0; i < count; i++)
+	{
+		curve.ControlPoints.emplace_back(XYZW(XYZ(i * 5.0, 10.0 * sin(i * 0.7), 2.0 * cos(i * 0.3)), 1.0 + 0.2 * (i % 3)));
+	}
+	curve.KnotVector = { 0, 0, 0, 0 };
+	for (int i = 1; i < count - 3; i++)
+	{
+		curve.KnotVector.emplace_back(i);
+	}
+	curve.KnotVector.insert(curve.KnotVector.end(), 4, count - 3);
+
+	LN_ArcLengthTable reference = NurbsCurve::BuildArcLengthTable(curve, LN_IntegrationTolerance(0.0, 1E-13));
+	double length = reference.Lengths.back();
+
+	LN_ArcLengthTable coarse = NurbsCurve::BuildArcLengthTable(curve, LN_IntegrationTolerance(1E-3, 0.0));
+	EXPECT_NEAR(coarse.Lengths.back(), length, 1E-3);
+	EXPECT_LE(coarse.Params.size(), reference.Params.size());
+	EXPECT_NEAR(NurbsCurve::ApproximateLength(curve, LN_IntegrationTolerance(0.0, 1E-6)), length, 1E-6 * length);
+
+	// Segments merge in order, so the thread count does not change the table.
+	LN_ArcLengthTable parallel = NurbsCurve::BuildArcLengthTable(curve, LN_IntegrationTolerance(0.0, 1E-13), LN_ExecutionPolicy(4));
+	EXPECT_EQ(parallel.Params, reference.Params);
+	EXPECT_EQ(parallel.Lengths, reference.Lengths);
+
+	double middle = (count - 3) / 2.0;
+	double first = NurbsCurve::ApproximateLength(reference, 0.0, middle);
+	double second = NurbsCurve::ApproximateLength(reference, middle, count - 3);
+	EXPECT_NEAR(first + second, length, 1E-9);
+	EXPECT_NEAR(NurbsCurve::ApproximateLength(reference, 1.25, 7.5), NurbsCurve::ApproximateLength(reference, 7.5) - NurbsCurve::ApproximateLength(reference, 1.25), 1E-12);
+	EXPECT_NEAR(NurbsCurve::ApproximateLength(curve, IntegratorType::Gauss_Legendre), length, 1E-3 * length);
+}
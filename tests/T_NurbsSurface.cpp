@@ -3,9 +3,96 @@
 #include "XYZ.h"
 #include "XYZW.h"
 #include "NurbsSurface.h"
+#include "SimdKernels.h"
 #include "LNObject.h"
+#include "Constants.h"
+#include "MathUtils.h"
+#include "ParallelUtils.h"
+#include "TessellationSink.h"
+#include "TessellationCache.h"
+#include <map>
 using namespace LNLib;
 
+namespace
+{
+	/// <summary>
+	/// The rational surface of the All test.
+	/// </summary>
+	LN_NurbsSurface CreateRationalSurface()
+	{
+		int degreeU = 2;
+		int degreeV = 2;
+		std::vector<double> kvU = { 0,0,0,1,2,3,4,4,5,5,5 };
+		std::vector<double> kvV = { 0,0,0,1,2,3,3,3 };
+
+		XYZW P20 = XYZW(-1, 2, 4, 1);
+		XYZW P21 = XYZW(0, 2, 4, 1);
+		XYZW P22 = XYZW(0, 6, 4, 2);
+		XYZW P23 = XYZW(0, 2, 0, 1);
+		XYZW P24 = XYZW(1, 2, 0, 1);
+
+		XYZW P10 = 0.9 * P20;
+		XYZW P11 = 0.9 * P21;
+		XYZW P12 = 0.9 * P22;
+		XYZW P13 = 0.9 * P23;
+		XYZW P14 = 0.9 * P24;
+
+		XYZW P00 = 0.9 * P10;
+		XYZW P01 = 0.9 * P11;
+		XYZW P02 = 0.9 * P12;
+		XYZW P03 = 0.9 * P13;
+		XYZW P04 = 0.9 * P14;
+
+		XYZW P30 = XYZW(3, 6, 8, 2);
+		XYZW P31 = XYZW(4, 6, 8, 2);
+		XYZW P32 = XYZW(12, 24, 12, 6);
+		XYZW P33 = XYZW(4, 6, 0, 2);
+		XYZW P34 = XYZW(5, 6, 0, 2);
+
+		XYZW P40 = XYZW(3, 2, 4, 1);
+		XYZW P41 = XYZW(4, 2, 4, 1);
+		XYZW P42 = XYZW(8, 6, 4, 2);
+		XYZW P43 = XYZW(4, 2, 0, 1);
+		XYZW P44 = XYZW(5, 2, 0, 1);
+
+		XYZW P50 = 1.5 * P40;
+		XYZW P51 = 1.5 * P41;
+		XYZW P52 = 1.5 * P42;
+		XYZW P53 = 1.5 * P43;
+		XYZW P54 = 1.5 * P44;
+
+		XYZW P60 = 1.5 * P50;
+		XYZW P61 = 1.5 * P51;
+		XYZW P62 = 1.5 * P52;
+		XYZW P63 = 1.5 * P53;
+		XYZW P64 = 1.5 * P54;
+
+		XYZW P70 = 1.5 * P60;
+		XYZW P71 = 1.5 * P61;
+		XYZW P72 = 1.5 * P62;
+		XYZW P73 = 1.5 * P63;
+		XYZW P74 = 1.5 * P64;
+
+		std::vector<std::vector<XYZW>> cps = {
+			{P00, P01, P02, P03, P04},
+			{P10, P11, P12, P13, P14},
+			{P20, P21, P22, P23, P24},
+			{P30, P31, P32, P33, P34},
+			{P40, P41, P42, P43, P44},
+			{P50, P51, P52, P53, P54},
+			{P60, P61, P62, P63, P64},
+			{P70, P71, P72, P73, P74},
+		};
+		LN_NurbsSurface surface;
+		surface.DegreeU = degreeU;
+		surface.DegreeV = degreeV;
+		surface.KnotVectorU = kvU;
+		surface.KnotVectorV = kvV;
+		surface.ControlPoints = cps;
+		return surface;
+	}
+}
+
 TEST(Test_NurbsSurface, All)
 {
 	int degreeU = 2; 
@@ -85,4 +172,655 @@ TEST(Test_NurbsSurface, All)
 
 	std::vector<std::vector<XYZ>> ders =  NurbsSurface::ComputeRationalSurfaceDerivatives(surface,1,uv);
 	EXPECT_TRUE(ders[0][0].IsAlmostEqualTo(XYZ(2, 98.0 / 27, 68.0 / 27)));
-}
\ No newline at end of file
+}
+
+TEST(Test_NurbsSurface, Checked)
+{
+	LN_NurbsSurface surface = CreateRationalSurface();
+	LN_CheckedNurbsSurface checked = NurbsSurface::Check(surface);
+	for (int i = 0; i <= 10; i++)
+	{
+		for (int j = 0; j <= 6; j++)
+		{
+			UV uv = UV(i / 2.0, j / 2.0);
+			EXPECT_TRUE(NurbsSurface::GetPointOnSurface(checked, uv).IsAlmostEqualTo(NurbsSurface::GetPointOnSurface(surface, uv)));
+
+			std::vector<std::vector<XYZ>> ders = NurbsSurface::ComputeRationalSurfaceDerivatives(surface, 1, uv);
+			std::vector<std::vector<XYZ>> checkedDers = NurbsSurface::ComputeRationalSurfaceDerivatives(checked, 1, uv);
+			EXPECT_TRUE(checkedDers[1][0].IsAlmostEqualTo(ders[1][0]));
+			EXPECT_TRUE(checkedDers[0][1].IsAlmostEqualTo(ders[0][1]));
+		}
+	}
+
+	surface.KnotVectorU = { 0,0,0,1,3,2,4,4,5,5,5 };
+	EXPECT_THROW(NurbsSurface::Check(surface), std::invalid_argument);
+}
+
+TEST(Test_NurbsSurface, Batch)
+{
+	LN_NurbsSurface surface = CreateRationalSurface();
+	LN_CheckedNurbsSurface checked = NurbsSurface::Check(surface);
+
+	std::vector<UV> uvs = { UV(0, 0), UV(5.0 / 2, 1), UV(4, 1.5), UV(5, 3) };
+	std::vector<XYZ> batchDers;
+	NurbsSurface::ComputeRationalSurfaceDerivatives(checked, 2, uvs, batchDers);
+	EXPECT_EQ(batchDers.size(), uvs.size() * 9);
+	for (int i = 0; i < uvs.size(); i++)
+	{
+		std::vector<std::vector<XYZ>> single = NurbsSurface::ComputeRationalSurfaceDerivatives(surface, 2, uvs[i]);
+		for (int k = 0; k <= 2; k++)
+		{
+			for (int l = 0; l <= 2 - k; l++)
+			{
+				EXPECT_TRUE(batchDers[(i * 3 + k) * 3 + l].IsAlmostEqualTo(single[k][l]));
+			}
+		}
+	}
+}
+
+TEST(Test_NurbsSurface, Grid)
+{
+	LN_NurbsSurface surface = CreateRationalSurface();
+	std::vector<double> uParams = { 0, 0.5, 1, 2.5, 4, 4.75, 5 };
+	std::vector<double> vParams = { 0, 1, 1.5, 3 };
+	std::vector<XYZ> points;
+	std::vector<XYZ> normals;
+	NurbsSurface::EvaluateGrid(surface, uParams, vParams, points, normals);
+	EXPECT_EQ(points.size(), uParams.size() * vParams.size());
+	for (int i = 0; i < uParams.size(); i++)
+	{
+		for (int j = 0; j < vParams.size(); j++)
+		{
+			UV gridUV = UV(uParams[i], vParams[j]);
+			EXPECT_TRUE(points[i * vParams.size() + j].IsAlmostEqualTo(NurbsSurface::GetPointOnSurface(surface, gridUV)));
+			EXPECT_TRUE(normals[i * vParams.size() + j].IsAlmostEqualTo(NurbsSurface::Normal(surface, gridUV)));
+		}
+	}
+}
+
+TEST(Test_NurbsSurface, Compiled)
+{
+	LN_NurbsSurface surface = CreateRationalSurface();
+	std::vector<double> uParams = { 0, 0.5, 1, 2.5, 4, 4.75, 5 };
+	std::vector<double> vParams = { 0, 1, 1.5, 3 };
+	std::vector<XYZ> points;
+	NurbsSurface::EvaluateGrid(surface, uParams, vParams, points);
+
+	LN_CompiledNurbsSurface compiled = NurbsSurface::Compile(surface);
+	bool enabled = SimdKernels::IsAVX2Enabled();
+	for (int pass = 0; pass < 2; pass++)
+	{
+		SimdKernels::SetAVX2Enabled(pass == 0);
+		std::vector<XYZ> compiledPoints;
+		NurbsSurface::EvaluateGrid(compiled, uParams, vParams, compiledPoints);
+		EXPECT_EQ(compiledPoints.size(), points.size());
+		for (int i = 0; i < points.size(); i++)
+		{
+			EXPECT_TRUE(compiledPoints[i].IsAlmostEqualTo(points[i]));
+		}
+	}
+	SimdKernels::SetAVX2Enabled(enabled);
+}
+
+TEST(Test_NurbsSurface, PowerBasis)
+{
+	LN_NurbsSurface surface = CreateRationalSurface();
+	std::vector<double> uParams = { 0, 0.5, 1, 2.5, 4, 4.75, 5 };
+	std::vector<double> vParams = { 0, 1, 1.5, 3 };
+	std::vector<XYZ> points;
+	NurbsSurface::EvaluateGrid(surface, uParams, vParams, points);
+
+	LN_PowerBasisSurface powerBasis = NurbsSurface::ToPowerBasis(surface);
+	EXPECT_EQ(powerBasis.Coefficients.size(), (powerBasis.KnotsU.size() - 1) * (powerBasis.KnotsV.size() - 1));
+	for (int i = 0; i < uParams.size(); i++)
+	{
+		for (int j = 0; j < vParams.size(); j++)
+		{
+			UV gridUV = UV(uParams[i], vParams[j]);
+			EXPECT_TRUE(NurbsSurface::GetPointOnSurface(powerBasis, gridUV).IsAlmostEqualTo(points[i * vParams.size() + j]));
+			std::vector<std::vector<XYZ>> expected = NurbsSurface::ComputeRationalSurfaceDerivatives(surface, 2, gridUV);
+			std::vector<std::vector<XYZ>> powerDers = NurbsSurface::ComputeRationalSurfaceDerivatives(powerBasis, 2, gridUV);
+			for (int k = 0; k <= 2; k++)
+			{
+				for (int l = 0; l <= 2 - k; l++)
+				{
+					EXPECT_TRUE(powerDers[k][l].IsAlmostEqualTo(expected[k][l]));
+				}
+			}
+		}
+	}
+}
+
+TEST(Test_NurbsSurface, NonRational)
+{
+	LN_NurbsSurface surface;
+	surface.DegreeU = 2;
+	surface.DegreeV = 2;
+	surface.KnotVectorU = { 0,0,0,1,1,1 };
+	surface.KnotVectorV = { 0,0,0,1,1,1 };
+	surface.ControlPoints = {
+		{ XYZW(XYZ(0,0,0),1), XYZW(XYZ(0,1,1),1), XYZW(XYZ(0,2,0),1) },
+		{ XYZW(XYZ(1,0,1),1), XYZW(XYZ(1,1,2),1), XYZW(XYZ(1,2,1),1) },
+		{ XYZW(XYZ(2,0,0),1), XYZW(XYZ(2,1,1),1), XYZW(XYZ(2,2,0),1) },
+	};
+
+	LN_CheckedNurbsSurface checked = NurbsSurface::Check(surface);
+	EXPECT_FALSE(checked.IsRational());
+	for (int i = 0; i <= 4; i++)
+	{
+		for (int j = 0; j <= 4; j++)
+		{
+			UV uv = UV(i / 4.0, j / 4.0);
+			EXPECT_TRUE(NurbsSurface::GetPointOnSurface(checked, uv).IsAlmostEqualTo(NurbsSurface::GetPointOnSurface(surface, uv)));
+
+			std::vector<std::vector<XYZ>> ders = NurbsSurface::ComputeRationalSurfaceDerivatives(surface, 2, uv);
+			std::vector<std::vector<XYZ>> checkedDers = NurbsSurface::ComputeRationalSurfaceDerivatives(checked, 2, uv);
+			EXPECT_TRUE(checkedDers[1][0].IsAlmostEqualTo(ders[1][0]));
+			EXPECT_TRUE(checkedDers[1][1].IsAlmostEqualTo(ders[1][1]));
+			EXPECT_TRUE(checkedDers[0][2].IsAlmostEqualTo(ders[0][2]));
+			EXPECT_TRUE(NurbsSurface::Normal(checked, uv).IsAlmostEqualTo(NurbsSurface::Normal(surface, uv)));
+			EXPECT_NEAR(NurbsSurface::Curvature(checked, SurfaceCurvature::Gauss, uv), NurbsSurface::Curvature(surface, SurfaceCurvature::Gauss, uv), 1e-9);
+		}
+	}
+
+	surface.ControlPoints[1][1] = XYZW(XYZ(1,1,2),3);
+	EXPECT_TRUE(NurbsSurface::Check(surface).IsRational());
+}
+
+TEST(Test_NurbsSurface, AdaptiveTessellate)
+{
+	LN_NurbsSurface plane;
+	NurbsSurface::CreateBilinearSurface(XYZ(0,0,0), XYZ(10,0,0), XYZ(10,10,0), XYZ(0,10,0), plane);
+	LN_Mesh mesh;
+	NurbsSurface::AdaptiveTessellate(plane, LN_TessellationTolerance(1E-3, 0.1), mesh);
+	EXPECT_EQ(mesh.Vertices.size(), 4);
+	EXPECT_EQ(mesh.Triangles.size(), 6);
+
+	// Triangles far smaller than the distance tolerance are still valid.
+	LN_NurbsSurface tinyPlane;
+	NurbsSurface::CreateBilinearSurface(XYZ(0,0,0), XYZ(1E-4,0,0), XYZ(1E-4,1E-4,0), XYZ(0,1E-4,0), tinyPlane);
+	NurbsSurface::AdaptiveTessellate(tinyPlane, LN_TessellationTolerance(1E-7, 0.1), mesh);
+	EXPECT_EQ(mesh.Triangles.size(), 6);
+
+	LN_NurbsSurface cylinder;
+	NurbsSurface::CreateCylindricalSurface(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, Constants::Pi, 1, 2, cylinder);
+	double chordHeight = 1E-3;
+	NurbsSurface::AdaptiveTessellate(cylinder, LN_TessellationTolerance(chordHeight, 0.5), mesh);
+	EXPECT_EQ(mesh.Normals.size(), mesh.Vertices.size());
+	EXPECT_EQ(mesh.UVs.size(), mesh.Vertices.size());
+	EXPECT_EQ(mesh.Triangles.size() % 3, 0);
+	EXPECT_LT(mesh.Vertices.size(), 200);
+
+	for (int i = 0; i < mesh.Vertices.size(); i++)
+	{
+		EXPECT_TRUE(NurbsSurface::GetPointOnSurface(cylinder, mesh.UVs[i]).IsAlmostEqualTo(mesh.Vertices[i]));
+	}
+	for (int i = 0; i < mesh.Triangles.size(); i += 3)
+	{
+		const XYZ& a = mesh.Vertices[mesh.Triangles[i]];
+		const XYZ& b = mesh.Vertices[mesh.Triangles[i + 1]];
+		const XYZ& c = mesh.Vertices[mesh.Triangles[i + 2]];
+		XYZ normal = (b - a).CrossProduct(c - a);
+		EXPECT_GT(normal.DotProduct(mesh.Normals[mesh.Triangles[i]]), 0.0);
+
+		XYZ centroid = (a + b + c) / 3;
+		EXPECT_LT(1.0 - XYZ(centroid.GetX(), centroid.GetY(), 0).Length(), chordHeight);
+	}
+}
+
+TEST(Test_NurbsSurface, Parallel)
+{
+	LN_NurbsSurface cylinder;
+	NurbsSurface::CreateCylindricalSurface(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, 2 * Constants::Pi, 1, 2, cylinder);
+	LN_ExecutionPolicy parallel(4);
+
+	std::vector<double> uParams;
+	std::vector<double> vParams;
+	for (int i = 0; i <= 50; i++)
+	{
+		uParams.emplace_back(i / 50.0);
+		vParams.emplace_back(i / 50.0);
+	}
+	std::vector<XYZ> points, normals, parallelPoints, parallelNormals;
+	NurbsSurface::EvaluateGrid(cylinder, uParams, vParams, points, normals);
+	NurbsSurface::EvaluateGrid(cylinder, uParams, vParams, parallelPoints, parallelNormals, parallel);
+	ASSERT_EQ(parallelPoints.size(), points.size());
+	for (int i = 0; i < points.size(); i++)
+	{
+		EXPECT_EQ(parallelPoints[i].Distance(points[i]), 0.0);
+		EXPECT_EQ(parallelNormals[i].Distance(normals[i]), 0.0);
+	}
+
+	LN_Mesh mesh, parallelMesh;
+	NurbsSurface::AdaptiveTessellate(cylinder, LN_TessellationTolerance(1E-3, 0.2), mesh);
+	NurbsSurface::AdaptiveTessellate(cylinder, LN_TessellationTolerance(1E-3, 0.2), parallelMesh, parallel);
+	EXPECT_EQ(parallelMesh.Triangles, mesh.Triangles);
+	ASSERT_EQ(parallelMesh.Vertices.size(), mesh.Vertices.size());
+	for (int i = 0; i < mesh.Vertices.size(); i++)
+	{
+		EXPECT_EQ(parallelMesh.Vertices[i].Distance(mesh.Vertices[i]), 0.0);
+	}
+
+	double area = NurbsSurface::ApproximateArea(cylinder, IntegratorType::Gauss_Legendre);
+	EXPECT_NEAR(area, 4 * Constants::Pi, 1E-6);
+	EXPECT_EQ(NurbsSurface::ApproximateArea(cylinder, IntegratorType::Gauss_Legendre, parallel), area);
+
+	EXPECT_THROW(ParallelUtils::For(100, parallel, [](int i) { if (i == 42) throw std::invalid_argument("42"); }), std::invalid_argument);
+}
+
+namespace
+{
+	class CountingSink : public SurfaceTessellationSink
+	{
+	public:
+		int Vertices = 0;
+		int Triangles = 0;
+		int Chunks = 0;
+		bool IndicesDelivered = true;
+
+		void AddVertices(const XYZ* /*vertices*/, const XYZ* /*normals*/, const UV* /*uvs*/, int count)
+		{
+			Vertices += count;
+			Chunks++;
+		}
+
+		void AddTriangles(const int* indices, int triangleCount)
+		{
+			for (int i = 0; i < 3 * triangleCount; i++)
+			{
+				IndicesDelivered = IndicesDelivered && indices[i] >= 0 && indices[i] < Vertices;
+			}
+			Triangles += triangleCount;
+		}
+	};
+}
+
+TEST(Test_NurbsSurface, TessellationSink)
+{
+	LN_NurbsSurface surface;
+	surface.DegreeU = 2;
+	surface.DegreeV = 2;
+	surface.KnotVectorU = { 0,0,0,0.5,1,1,1 };
+	surface.KnotVectorV = { 0,0,0,1,1,1 };
+	surface.ControlPoints = {
+		{ XYZW(XYZ(0,0,0),1), XYZW(XYZ(0,1,1),1), XYZW(XYZ(0,2,0),1) },
+		{ XYZW(XYZ(1,0,1),1), XYZW(XYZ(1,1,2),1), XYZW(XYZ(1,2,1),1) },
+		{ XYZW(XYZ(2,0,0),1), XYZW(XYZ(2,1,1),1), XYZW(XYZ(2,2,0),1) },
+		{ XYZW(XYZ(3,0,1),1), XYZW(XYZ(3,1,0),1), XYZW(XYZ(3,2,1),1) },
+	};
+
+	LN_TessellationTolerance tolerance(1E-3, 0.2);
+	LN_Mesh mesh;
+	NurbsSurface::AdaptiveTessellate(surface, tolerance, mesh);
+
+	CountingSink sink;
+	NurbsSurface::AdaptiveTessellate(surface, tolerance, sink);
+	EXPECT_EQ(sink.Chunks, 2);
+	EXPECT_EQ(sink.Vertices, mesh.Vertices.size());
+	EXPECT_EQ(3 * sink.Triangles, mesh.Triangles.size());
+	EXPECT_TRUE(sink.IndicesDelivered);
+
+	LN_Mesh parallelMesh;
+	NurbsSurface::AdaptiveTessellate(surface, tolerance, parallelMesh, LN_ExecutionPolicy(4));
+	ASSERT_EQ(parallelMesh.Vertices.size(), mesh.Vertices.size());
+	for (int i = 0; i < mesh.Vertices.size(); i++)
+	{
+		EXPECT_TRUE(parallelMesh.Vertices[i].IsAlmostEqualTo(mesh.Vertices[i]));
+	}
+	EXPECT_EQ(parallelMesh.Triangles, mesh.Triangles);
+
+	std::vector<XYZ> points;
+	std::vector<UV> uvs;
+	NurbsSurface::EquallyTessellate(surface, points, uvs);
+	CountingSink equalSink;
+	NurbsSurface::EquallyTessellate(surface, equalSink);
+	EXPECT_EQ(equalSink.Chunks, 3);
+	EXPECT_EQ(equalSink.Vertices, points.size());
+	EXPECT_EQ(equalSink.Triangles, 0);
+}
+
+TEST(Test_NurbsSurface, CrackFreeTessellation)
+{
+	LN_NurbsSurface front;
+	NurbsSurface::CreateCylindricalSurface(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, Constants::Pi, 1, 2, front);
+	LN_NurbsSurface half;
+	NurbsSurface::CreateCylindricalSurface(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), Constants::Pi, 2 * Constants::Pi, 1, 2, half);
+	LN_NurbsSurface back = half;
+	NurbsSurface::Reverse(half, SurfaceDirection::All, back);
+
+	// The halves meet along two lines and are refined to different tolerances.
+	std::vector<LN_NurbsSurface> surfaces = { front, back };
+	std::vector<LN_TessellationTolerance> tolerances = { LN_TessellationTolerance(1E-4, 0.05, 0.1), LN_TessellationTolerance(1E-2, 0.5) };
+	LN_Mesh mesh;
+	NurbsSurface::AdaptiveTessellate(surfaces, tolerances, mesh);
+	EXPECT_EQ(mesh.Normals.size(), mesh.Vertices.size());
+	EXPECT_EQ(mesh.UVs.size(), mesh.Vertices.size());
+
+	// Every edge is used by two triangles, except those on the open bottom and top circles.
+	std::map<std::pair<int, int>, int> edgeUses;
+	for (int i = 0; i < mesh.Triangles.size(); i += 3)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			int a = mesh.Triangles[i + k];
+			int b = mesh.Triangles[i + (k + 1) % 3];
+			edgeUses[std::make_pair(std::min(a, b), std::max(a, b))]++;
+		}
+	}
+	for (auto it = edgeUses.begin(); it != edgeUses.end(); ++it)
+	{
+		EXPECT_LE(it->second, 2);
+		if (it->second == 1)
+		{
+			double z = mesh.Vertices[it->first.first].GetZ();
+			EXPECT_TRUE(MathUtils::IsAlmostEqualTo(z, 0.0) || MathUtils::IsAlmostEqualTo(z, 2.0));
+			EXPECT_TRUE(MathUtils::IsAlmostEqualTo(mesh.Vertices[it->first.second].GetZ(), z));
+		}
+	}
+
+	// A single closed surface is stitched along its own seam.
+	LN_NurbsSurface cylinder;
+	NurbsSurface::CreateCylindricalSurface(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, 2 * Constants::Pi, 1, 2, cylinder);
+	LN_Mesh open;
+	NurbsSurface::AdaptiveTessellate(cylinder, tolerances[1], open);
+	LN_Mesh closed;
+	NurbsSurface::AdaptiveTessellate(std::vector<LN_NurbsSurface>(1, cylinder), std::vector<LN_TessellationTolerance>(1, tolerances[1]), closed);
+	EXPECT_EQ(closed.Triangles.size(), open.Triangles.size());
+	EXPECT_LT(closed.Vertices.size(), open.Vertices.size());
+
+	// Small surfaces keep all their triangles.
+	LN_NurbsSurface left;
+	NurbsSurface::CreateBilinearSurface(XYZ(0,0,0), XYZ(5E-4,0,0), XYZ(5E-4,5E-4,0), XYZ(0,5E-4,0), left);
+	LN_NurbsSurface right;
+	NurbsSurface::CreateBilinearSurface(XYZ(5E-4,0,0), XYZ(1E-3,0,0), XYZ(1E-3,5E-4,0), XYZ(5E-4,5E-4,0), right);
+	std::vector<LN_NurbsSurface> smallSurfaces = { left, right };
+	NurbsSurface::AdaptiveTessellate(smallSurfaces, { LN_TessellationTolerance(1E-7, 0.1) }, mesh);
+	EXPECT_EQ(mesh.Vertices.size(), 6);
+	EXPECT_EQ(mesh.Triangles.size(), 12);
+
+	// Sub-millimetre half cylinders stacked on a shared semicircle are stitched as unit ones are.
+	double scale = 3E-4;
+	LN_NurbsSurface lower;
+	NurbsSurface::CreateCylindricalSurface(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, Constants::Pi, scale, scale, lower);
+	LN_NurbsSurface upper;
+	NurbsSurface::CreateCylindricalSurface(XYZ(0,0,scale), XYZ(1,0,0), XYZ(0,1,0), 0, Constants::Pi, scale, scale, upper);
+	surfaces = { lower, upper };
+	tolerances = { LN_TessellationTolerance(1E-4 * scale, 0.05, 0.1 * scale), LN_TessellationTolerance(1E-2 * scale, 0.5) };
+	NurbsSurface::AdaptiveTessellate(surfaces, tolerances, mesh);
+	edgeUses.clear();
+	for (int i = 0; i < mesh.Triangles.size(); i += 3)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			int a = mesh.Triangles[i + k];
+			int b = mesh.Triangles[i + (k + 1) % 3];
+			edgeUses[std::make_pair(std::min(a, b), std::max(a, b))]++;
+		}
+	}
+	for (auto it = edgeUses.begin(); it != edgeUses.end(); ++it)
+	{
+		EXPECT_LE(it->second, 2);
+		if (it->second == 1)
+		{
+			double z = mesh.Vertices[it->first.first].GetZ();
+			XYZ a = mesh.Vertices[it->first.first];
+			XYZ b = mesh.Vertices[it->first.second];
+			bool isOpenEdge = (std::abs(a.GetZ() - b.GetZ()) < 1E-12 && std::abs(std::abs(a.GetZ() - scale) - scale) < 1E-12) ||
+				(std::abs(a.GetY()) < 1E-12 && std::abs(b.GetY()) < 1E-12);
+			EXPECT_TRUE(isOpenEdge);
+		}
+	}
+}
+
+TEST(Test_NurbsSurface, TessellationCache)
+{
+	std::vector<LN_TessellationTolerance> levels = { LN_TessellationTolerance(1E-1, 0.5), LN_TessellationTolerance(1E-2, 0.2), LN_TessellationTolerance(1E-3, 0.1) };
+	TessellationCache cache(levels);
+	EXPECT_EQ(cache.SelectLevel(1.0), 0);
+	EXPECT_EQ(cache.SelectLevel(5E-2), 1);
+	EXPECT_EQ(cache.SelectLevel(1E-5), 2);
+
+	LN_NurbsSurface cylinder;
+	NurbsSurface::CreateCylindricalSurface(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, Constants::Pi, 1, 2, cylinder);
+	const LN_Mesh& coarse = cache.GetTessellation(cylinder, 0);
+	const LN_Mesh& fine = cache.GetTessellation(cylinder, 2);
+	EXPECT_LT(coarse.Triangles.size(), fine.Triangles.size());
+	EXPECT_EQ(cache.GetGeneratedCount(), 2);
+
+	// An equal copy hits the cache and gets the very same buffers.
+	LN_NurbsSurface copy = cylinder;
+	EXPECT_EQ(TessellationCache::GetHash(copy), TessellationCache::GetHash(cylinder));
+	EXPECT_EQ(&cache.GetTessellation(copy, 2), &fine);
+	EXPECT_EQ(cache.GetGeneratedCount(), 2);
+	EXPECT_EQ(cache.GetSurfaceCount(), 1);
+
+	LN_Mesh expected;
+	NurbsSurface::AdaptiveTessellate(cylinder, levels[2], expected);
+	EXPECT_EQ(fine.Vertices.size(), expected.Vertices.size());
+	EXPECT_EQ(fine.Triangles, expected.Triangles);
+
+	copy.ControlPoints[0][0].SetW(2.0);
+	EXPECT_NE(TessellationCache::GetHash(copy), TessellationCache::GetHash(cylinder));
+	cache.GetTessellation(copy, 0);
+	EXPECT_EQ(cache.GetSurfaceCount(), 2);
+	EXPECT_EQ(cache.GetGeneratedCount(), 3);
+
+	LN_NurbsCurve line;
+	line.Degree = 1;
+	line.KnotVector = { 0,0,1,1 };
+	line.ControlPoints = { XYZW(XYZ(0,0,0),1), XYZW(XYZ(1,0,0),1) };
+	const LN_Polyline& polyline = cache.GetTessellation(line, 1);
+	EXPECT_EQ(polyline.Points.size(), polyline.Params.size());
+	EXPECT_EQ(&cache.GetTessellation(line, 1), &polyline);
+	EXPECT_EQ(cache.GetCurveCount(), 1);
+
+	// Signed zeros compare equal, so they must hash alike too.
+	LN_NurbsCurve negativeZero = line;
+	negativeZero.ControlPoints[0] = XYZW(-0.0, -0.0, -0.0, 1);
+	EXPECT_EQ(TessellationCache::GetHash(negativeZero), TessellationCache::GetHash(line));
+	EXPECT_EQ(&cache.GetTessellation(negativeZero, 1), &polyline);
+	EXPECT_EQ(cache.GetCurveCount(), 1);
+
+	cache.Clear();
+	EXPECT_EQ(cache.GetSurfaceCount(), 0);
+	EXPECT_EQ(cache.GetGeneratedCount(), 0);
+}
+
+TEST(Test_NurbsSurface, BVH)
+{
+	LN_NurbsSurface cylinder;
+	NurbsSurface::CreateCylindricalSurface(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, 2 * Constants::Pi, 1, 2, cylinder);
+	LN_SurfaceBVH bvh = NurbsSurface::BuildBVH(cylinder);
+	EXPECT_EQ(bvh.Nodes.size(), 2 * bvh.Leaves.size() - 1);
+	EXPECT_EQ(bvh.LeafParams.size(), 4 * bvh.Leaves.size());
+
+	std::vector<double> uParams;
+	std::vector<double> vParams;
+	for (int i = 0; i <= 40; i++)
+	{
+		uParams.emplace_back(cylinder.KnotVectorU[0] + (cylinder.KnotVectorU.back() - cylinder.KnotVectorU[0]) * i / 40);
+		vParams.emplace_back(cylinder.KnotVectorV[0] + (cylinder.KnotVectorV.back() - cylinder.KnotVectorV[0]) * i / 40);
+	}
+	std::vector<XYZ> grid;
+	NurbsSurface::EvaluateGrid(cylinder, uParams, vParams, grid);
+
+	// Points on the surface come back to themselves.
+	for (int i = 0; i < grid.size(); i += 13)
+	{
+		UV param = NurbsSurface::GetParamOnSurface(bvh, grid[i]);
+		EXPECT_NEAR(NurbsSurface::GetPointOnSurface(cylinder, param).Distance(grid[i]), 0.0, 1E-9);
+	}
+
+	// Points off the surface land at least as close as the nearest grid sample.
+	const XYZ queries[] = { XYZ(0.3, 0.2, 1.1), XYZ(3, -2, 0.5), XYZ(0, 0, -1), XYZ(-0.9, 0.9, 3), XYZ(0.01, 0.02, 1.0) };
+	for (const XYZ& query : queries)
+	{
+		double bruteForce = Constants::MaxDistance;
+		for (int i = 0; i < grid.size(); i++)
+		{
+			bruteForce = std::min(bruteForce, grid[i].Distance(query));
+		}
+		UV param = NurbsSurface::GetParamOnSurface(bvh, query);
+		EXPECT_LE(NurbsSurface::GetPointOnSurface(cylinder, param).Distance(query), bruteForce + Constants::DoubleEpsilon);
+		UV direct = NurbsSurface::GetParamOnSurface(cylinder, query);
+		EXPECT_DOUBLE_EQ(direct.GetU(), param.GetU());
+		EXPECT_DOUBLE_EQ(direct.GetV(), param.GetV());
+	}
+
+	// The checked leaves of a copy view the copy's own leaves.
+	LN_SurfaceBVH copy;
+	{
+		LN_SurfaceBVH original = NurbsSurface::BuildBVH(cylinder);
+		copy = original;
+	}
+	ASSERT_EQ(copy.CheckedLeaves.size(), copy.Leaves.size());
+	EXPECT_EQ(copy.CheckedLeaves[0].GetSurface().ControlPoints.Data, copy.Leaves[0].ControlPoints.data());
+	UV param = NurbsSurface::GetParamOnSurface(copy, NurbsSurface::GetPointOnSurface(cylinder, UV(0.3, 0.6)));
+	EXPECT_TRUE(NurbsSurface::GetPointOnSurface(cylinder, param).IsAlmostEqualTo(NurbsSurface::GetPointOnSurface(cylinder, UV(0.3, 0.6))));
+}
+
+TEST(Test_NurbsSurface, ProjectionScale)
+{
+	// Points pushed radially off a cylinder project back to where they started, relative to its radius at any scale.
+	const double radii[] = { 1.0, 0.1, 0.01, 0.001 };
+	for (double radius : radii)
+	{
+		LN_NurbsSurface cylinder;
+		NurbsSurface::CreateCylindricalSurface(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, 2 * Constants::Pi, radius, 2 * radius, cylinder);
+		LN_SurfaceBVH bvh = NurbsSurface::BuildBVH(cylinder);
+		std::vector<XYZ> feet;
+		std::vector<XYZ> points;
+		for (int i = 0; i < 12; i++)
+		{
+			double u = cylinder.KnotVectorU[0] + (cylinder.KnotVectorU.back() - cylinder.KnotVectorU[0]) * (0.05 + 0.08 * i);
+			double v = cylinder.KnotVectorV[0] + (cylinder.KnotVectorV.back() - cylinder.KnotVectorV[0]) * (0.1 + 0.07 * i);
+			XYZ foot = NurbsSurface::GetPointOnSurface(cylinder, UV(u, v));
+			feet.emplace_back(foot);
+			points.emplace_back(foot + 0.2 * XYZ(foot.GetX(), foot.GetY(), 0));
+		}
+
+		std::vector<UV> params;
+		std::vector<XYZ> closestPoints;
+		std::vector<double> signedDistances;
+		LN_DeviationStatistics statistics;
+		NurbsSurface::GetParamsOnSurface(bvh, points, params, closestPoints, signedDistances, statistics);
+		for (int i = 0; i < points.size(); i++)
+		{
+			XYZ point = NurbsSurface::GetPointOnSurface(cylinder, NurbsSurface::GetParamOnSurface(bvh, points[i]));
+			EXPECT_LE(point.Distance(feet[i]), 1E-9 * radius);
+			EXPECT_LE(closestPoints[i].Distance(feet[i]), 1E-9 * radius);
+			EXPECT_NEAR(std::abs(signedDistances[i]), 0.2 * radius, 1E-9 * radius);
+		}
+		EXPECT_NEAR(statistics.MaxAbsoluteDistance, 0.2 * radius, 1E-9 * radius);
+	}
+}
+
+TEST(Test_NurbsSurface, BatchProjection)
+{
+	LN_NurbsSurface cylinder;
+	NurbsSurface::CreateCylindricalSurface(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, Constants::Pi, 1, 2, cylinder);
+
+	// A scan of the half cylinder with radial deviations of known size.
+	std::vector<XYZ> points;
+	std::vector<double> radialDeviations;
+	for (int i = 0; i < 1500; i++)
+	{
+		double angle = 0.1 + 2.9 * (i % 100) / 100.0;
+		double deviation = 0.02 * sin(0.37 * i);
+		double height = 0.1 + 1.8 * (i / 100) / 15.0;
+		points.emplace_back(XYZ((1 + deviation) * cos(angle), (1 + deviation) * sin(angle), height));
+		radialDeviations.emplace_back(deviation);
+	}
+
+	LN_SurfaceBVH bvh = NurbsSurface::BuildBVH(cylinder);
+	std::vector<UV> params;
+	std::vector<XYZ> closestPoints;
+	std::vector<double> signedDistances;
+	LN_DeviationStatistics statistics;
+	NurbsSurface::GetParamsOnSurface(bvh, points, params, closestPoints, signedDistances, statistics, 10);
+	ASSERT_EQ(signedDistances.size(), points.size());
+
+	XYZ normal = NurbsSurface::Normal(cylinder, params[0]);
+	double side = normal.DotProduct(XYZ(cos(0.1), sin(0.1), 0)) > 0 ? 1.0 : -1.0;
+	double absoluteSum = 0.0;
+	double squareSum = 0.0;
+	for (int i = 0; i < points.size(); i++)
+	{
+		EXPECT_NEAR(signedDistances[i], side * radialDeviations[i], 1E-9);
+		EXPECT_NEAR(NurbsSurface::GetPointOnSurface(cylinder, params[i]).Distance(closestPoints[i]), 0.0, 1E-9);
+		absoluteSum += std::abs(signedDistances[i]);
+		squareSum += signedDistances[i] * signedDistances[i];
+	}
+	EXPECT_EQ(statistics.Count, points.size());
+	EXPECT_NEAR(statistics.MeanAbsoluteDistance, absoluteSum / points.size(), 1E-12);
+	EXPECT_NEAR(statistics.RMSDistance, sqrt(squareSum / points.size()), 1E-12);
+	EXPECT_NEAR(statistics.MaxAbsoluteDistance, 0.02, 1E-4);
+	EXPECT_EQ(statistics.Histogram.size(), 10);
+	int total = 0;
+	for (int i = 0; i < statistics.Histogram.size(); i++)
+	{
+		total += statistics.Histogram[i];
+	}
+	EXPECT_EQ(total, points.size());
+
+	std::vector<UV> parallelParams;
+	std::vector<XYZ> parallelClosestPoints;
+	std::vector<double> parallelDistances;
+	LN_DeviationStatistics parallelStatistics;
+	NurbsSurface::GetParamsOnSurface(cylinder, points, parallelParams, parallelClosestPoints, parallelDistances, parallelStatistics, 10, LN_ExecutionPolicy(4));
+	EXPECT_EQ(parallelDistances, signedDistances);
+	EXPECT_EQ(parallelStatistics.RMSDistance, statistics.RMSDistance);
+	EXPECT_EQ(parallelStatistics.Histogram, statistics.Histogram);
+}
+
+TEST(Test_NurbsSurface, AreaEngine)
+{
+	LN_NurbsSurface cylinder;
+	NurbsSurface::CreateCylindricalSurface(XYZ(0,0,0), XYZ(1,0,0), XYZ(0,1,0), 0, 2 * Constants::Pi, 1, 2, cylinder);
+	LN_SurfaceArea area = NurbsSurface::ApproximateArea(cylinder, LN_IntegrationTolerance(1E-9, 0.0));
+	EXPECT_TRUE(area.IsConverged);
+	EXPECT_LE(area.Error, 1E-9);
+	EXPECT_NEAR(area.Area, 4 * Constants::Pi, 1E-9);
+	ASSERT_EQ(area.PatchAreas.size(), area.PatchCountU * area.PatchCountV);
+	double sum = 0.0;
+	for (int i = 0; i < area.PatchAreas.size(); i++)
+	{
+		sum += area.PatchAreas[i];
+	}
+	EXPECT_EQ(sum, area.Area);
+
+	LN_SurfaceArea parallel = NurbsSurface::ApproximateArea(cylinder, LN_IntegrationTolerance(1E-9, 0.0), LN_ExecutionPolicy(4));
+	EXPECT_EQ(parallel.PatchAreas, area.PatchAreas);
+
+	// The legacy integrator choices agree with the engine.
+	EXPECT_NEAR(NurbsSurface::ApproximateArea(cylinder, IntegratorType::Simpson), 4 * Constants::Pi, 1E-5);
+	EXPECT_NEAR(NurbsSurface::ApproximateArea(cylinder, IntegratorType::Chebyshev), 4 * Constants::Pi, 1E-5);
+
+	// Hyperbolic paraboloid z = xy over [0, 1] x [0, 1], a non-rational bilinear patch, split into two spans in u.
+	LN_NurbsSurface saddle;
+	saddle.DegreeU = 2;
+	saddle.DegreeV = 1;
+	saddle.KnotVectorU = { 0, 0, 0, 0.5, 1, 1, 1 };
+	saddle.KnotVectorV = { 0, 0, 1, 1 };
+	double xs[4] = { 0.0, 0.25, 0.75, 1.0 };
+	for (int i = 0; i < 4; i++)
+	{
+		saddle.ControlPoints.emplace_back(std::vector<XYZW>{ XYZW(XYZ(xs[i], 0, 0), 1), XYZW(XYZ(xs[i], 1, xs[i]), 1) });
+	}
+	double exact = 1.2807892752733743;
+	area = NurbsSurface::ApproximateArea(saddle, LN_IntegrationTolerance(0.0, 1E-12));
+	EXPECT_EQ(area.PatchCountU, 2);
+	EXPECT_EQ(area.PatchCountV, 1);
+	EXPECT_NEAR(area.Area, exact, 1E-10);
+
+	// Uniform weights take the rational path and give the same area.
+	LN_NurbsSurface weighted = saddle;
+	for (int i = 0; i < weighted.ControlPoints.size(); i++)
+	{
+		for (int j = 0; j < weighted.ControlPoints[i].size(); j++)
+		{
+			weighted.ControlPoints[i][j] = XYZW(saddle.ControlPoints[i][j].ToXYZ(true), 2.0);
+		}
+	}
+	EXPECT_NEAR(NurbsSurface::ApproximateArea(weighted, LN_IntegrationTolerance(0.0, 1E-12)).Area, exact, 1E-10);
+}
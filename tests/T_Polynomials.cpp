@@ -74,4 +74,62 @@ TEST(Test_Polynomials, All)
 	KnotVectorUtils::GetInsertedKnotElement(u1, u2, i1, i2);
 	EXPECT_TRUE(i1.size() == 4);
 	EXPECT_TRUE(i2.size() == 3);
-}
\ No newline at end of file
+}
+
+TEST(Test_Polynomials, BufferKernels)
+{
+	for (int degree = 1; degree <= 7; degree++)
+	{
+		std::vector<double> knotVector(degree + 1, 0.0);
+		for (int i = 1; i < 4; i++)
+		{
+			knotVector.push_back(i);
+		}
+		knotVector.insert(knotVector.end(), degree + 1, 4.0);
+		LN_ArrayView<double> view(knotVector);
+
+		int derivative = std::min(degree, 3);
+		std::vector<double> basis(degree + 1);
+		std::vector<double> ders((derivative + 1) * (degree + 1));
+		std::vector<double> all((degree + 1) * (degree + 1));
+		std::vector<double> inverseDenominators(degree * (degree + 1) / 2);
+		std::vector<double> reusedDers((derivative + 1) * (degree + 1));
+		for (int s = 0; s < 8; s++)
+		{
+			double t = 0.5 * s;
+			int spanIndex = Polynomials::GetKnotSpanIndex(degree, knotVector, t);
+
+			Polynomials::BasisFunctionsUnchecked(spanIndex, degree, view, t, basis.data());
+			Polynomials::BasisFunctionsDerivativesUnchecked(spanIndex, degree, derivative, view, t, ders.data());
+			Polynomials::ComputeInverseDenominators(spanIndex, degree, view, inverseDenominators.data());
+			Polynomials::BasisFunctionsDerivativesUnchecked(spanIndex, degree, derivative, view, t, inverseDenominators.data(), reusedDers.data());
+			for (int i = 0; i < ders.size(); i++)
+			{
+				EXPECT_TRUE(MathUtils::IsAlmostEqualTo(reusedDers[i], ders[i]));
+			}
+			double sum = 0.0;
+			for (int j = 0; j <= degree; j++)
+			{
+				sum += basis[j];
+				EXPECT_TRUE(MathUtils::IsAlmostEqualTo(basis[j], Polynomials::OneBasisFunction(spanIndex - degree + j, degree, knotVector, t)));
+
+				std::vector<double> oneders = Polynomials::OneBasisFunctionDerivative(spanIndex - degree + j, degree, derivative, knotVector, t);
+				for (int k = 0; k <= derivative; k++)
+				{
+					EXPECT_TRUE(MathUtils::IsAlmostEqualTo(ders[k * (degree + 1) + j], oneders[k]));
+				}
+			}
+			EXPECT_TRUE(MathUtils::IsAlmostEqualTo(sum, 1.0));
+
+			Polynomials::AllBasisFunctionsUnchecked(spanIndex, degree, view, t, all.data());
+			for (int i = 0; i <= degree; i++)
+			{
+				std::vector<double> lower = Polynomials::BasisFunctions(spanIndex, i, knotVector, t);
+				for (int j = 0; j <= i; j++)
+				{
+					EXPECT_TRUE(MathUtils::IsAlmostEqualTo(all[j * (degree + 1) + i], lower[j]));
+				}
+			}
+		}
+	}
+}
@@ -1,6 +1,7 @@
 #include "gtest/gtest.h"
 #include "XYZ.h"
 #include "MathUtils.h"
+#include <type_traits>
 using namespace LNLib;
 
 TEST(Test_XYZ, Construct)
@@ -123,4 +124,15 @@ TEST(Test_XYZ, OperatorOverride)
 	EXPECT_TRUE(MathUtils::IsAlmostEqualTo(divide.GetX(), 1) &&
 				MathUtils::IsAlmostEqualTo(divide.GetY(), 2) &&
 				MathUtils::IsAlmostEqualTo(divide.GetZ(), 3));
-}
\ No newline at end of file
+}
+
+TEST(Test_XYZ, Constexpr)
+{
+	constexpr XYZ a = XYZ(1, 2, 3);
+	constexpr XYZ b = XYZ(4, 5, 6);
+	static_assert(a.DotProduct(b) == 32, "DotProduct must be usable in constant expressions.");
+	static_assert((a + b).GetZ() == 9, "operator+ must be usable in constant expressions.");
+	static_assert(a.CrossProduct(b).GetX() == -3, "CrossProduct must be usable in constant expressions.");
+	static_assert(std::is_trivially_copyable<XYZ>::value, "XYZ must stay trivially copyable.");
+	EXPECT_TRUE((a - b).IsAlmostEqualTo(XYZ(-3, -3, -3)));
+}